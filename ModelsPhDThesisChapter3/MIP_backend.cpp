@@ -0,0 +1,581 @@
+/*!
+*	@file	MIP_backend.cpp
+*	@author		Hendrik Vermuyten
+*	@brief	Solver-independent interface to build and solve the MIP models, with CPLEX and HiGHS implementations.
+*/
+
+#include "MIP_backend.h"
+#include "MIP_utilities.h"
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+
+#ifdef ALG_USE_HIGHS
+#include "interfaces/highs_c_api.h"
+#endif // ALG_USE_HIGHS
+
+
+namespace alg
+{
+	bool mip_status_has_solution(mip_status status)
+	{
+		return status == mip_status::optimal
+			|| status == mip_status::optimal_tolerance
+			|| status == mip_status::time_limit_feasible
+			|| status == mip_status::memory_limit_feasible;
+	}
+
+
+	std::string mip_status_description(mip_status status)
+	{
+		switch (status)
+		{
+		case mip_status::optimal:
+			return "Optimal solution found";
+		case mip_status::optimal_tolerance:
+			return "Solution found within tolerance limit";
+		case mip_status::time_limit_feasible:
+		case mip_status::time_limit_infeasible:
+			return "Time limit exceeded";
+		case mip_status::memory_limit_feasible:
+		case mip_status::memory_limit_infeasible:
+			return "Tree memory limit exceeded";
+		case mip_status::infeasible:
+			return "Problem is infeasible";
+		case mip_status::unbounded:
+			return "Problem is unbounded";
+		case mip_status::infeasible_or_unbounded:
+			return "Problem is infeasible or unbounded";
+		default:
+			return "Other reason for failure";
+		}
+	}
+
+
+	std::unique_ptr<mip_backend> create_mip_backend(mip_solver solver, const std::string& name)
+	{
+#ifdef ALG_USE_CPLEX
+		if (solver == mip_solver::cplex)
+			return std::make_unique<cplex_backend>(name);
+#endif // ALG_USE_CPLEX
+
+#ifdef ALG_USE_HIGHS
+		if (solver == mip_solver::highs)
+			return std::make_unique<highs_backend>(name);
+#endif // ALG_USE_HIGHS
+
+		throw std::runtime_error("Error in function create_mip_backend(). \nReason: The requested solver is not available in this build.");
+	}
+
+
+
+#ifdef ALG_USE_CPLEX
+	/*************************************************************************************************************************/
+	/******************************************************    CPLEX    ******************************************************/
+	/*************************************************************************************************************************/
+
+	cplex_backend::cplex_backend(const std::string& name)
+	{
+		int status = 0;
+
+		_env = cplex_environment_pool::get_instance().acquire();
+		_owner = true;
+
+		_problem = CPXcreateprob(_env, &status, name.c_str());
+		if (_problem == nullptr)
+		{
+			CPXgeterrorstring(_env, status, _error_text);
+			cplex_environment_pool::get_instance().release(_env);
+			throw std::runtime_error("Error in function cplex_backend::cplex_backend(). \nCouldn't create the CPLEX problem. \nReason: " + std::string(_error_text));
+		}
+
+		CPXchgobjsen(_env, _problem, CPX_MIN);
+	}
+
+
+	cplex_backend::~cplex_backend()
+	{
+		if (!_owner)
+			return;
+
+		if (_problem != nullptr)
+			CPXfreeprob(_env, &_problem);
+		if (_env != nullptr)
+			cplex_environment_pool::get_instance().release(_env);
+	}
+
+
+	void cplex_backend::check(int status, const std::string& function, const std::string& what) const
+	{
+		if (status != 0)
+		{
+			CPXgeterrorstring(_env, status, _error_text);
+			throw std::runtime_error("Error in function cplex_backend::" + function + "(). \n" + what + " \nReason: " + std::string(_error_text));
+		}
+	}
+
+
+	void cplex_backend::add_columns(int nb_columns, const double* obj, const double* lb, const double* ub, const char* type, char** names)
+	{
+		const std::string first = (names != NULL && nb_columns > 0) ? std::string(names[0]) : std::string();
+		check(CPXnewcols(_env, _problem, nb_columns, obj, lb, ub, type, names), "add_columns", "Couldn't add variable " + first + ".");
+	}
+
+
+	void cplex_backend::add_rows(int nb_rows, int nb_nonzeros, const double* rhs, const char* sense, const int* matbeg, const int* matind, const double* matval, char** names)
+	{
+		const std::string first = (names != NULL && nb_rows > 0) ? std::string(names[0]) : std::string();
+		check(CPXaddrows(_env, _problem, 0, nb_rows, nb_nonzeros, rhs, sense, matbeg, matind, matval, NULL, names), "add_rows", "Couldn't add constraint " + first + ".");
+	}
+
+
+	void cplex_backend::change_objective(int nb_columns, const int* indices, const double* values)
+	{
+		check(CPXchgobj(_env, _problem, nb_columns, indices, values), "change_objective", "Couldn't change the objective coefficients.");
+	}
+
+
+	void cplex_backend::change_rhs(int nb_rows, const int* indices, const double* values)
+	{
+		check(CPXchgrhs(_env, _problem, nb_rows, indices, values), "change_rhs", "Couldn't change the right-hand sides.");
+	}
+
+
+	void cplex_backend::get_bounds(std::vector<double>& lb, std::vector<double>& ub) const
+	{
+		const int nb_columns = get_nb_columns();
+		lb.assign(nb_columns, 0.0);
+		ub.assign(nb_columns, 0.0);
+		if (nb_columns == 0)
+			return;
+
+		int status = CPXgetlb(_env, _problem, lb.data(), 0, nb_columns - 1);
+		if (status == 0)
+			status = CPXgetub(_env, _problem, ub.data(), 0, nb_columns - 1);
+		check(status, "get_bounds", "Couldn't get the bounds of the variables.");
+	}
+
+
+	void cplex_backend::change_bounds(int nb_bounds, const int* indices, const char* lu, const double* bd)
+	{
+		check(CPXchgbds(_env, _problem, nb_bounds, indices, lu, bd), "change_bounds", "Couldn't change the bounds of the variables.");
+	}
+
+
+	void cplex_backend::add_mip_start(const std::vector<int>& columns, const std::vector<double>& values, const std::string& name)
+	{
+		alg::add_mip_start(_env, _problem, columns, values, name);
+	}
+
+
+	void cplex_backend::clear_mip_starts()
+	{
+		alg::clear_mip_starts(_env, _problem);
+	}
+
+
+	void cplex_backend::set_output(bool on)
+	{
+		check(CPXsetintparam(_env, CPX_PARAM_SCRIND, on ? CPX_ON : CPX_OFF), "set_output", "Couldn't set the output parameter.");
+	}
+
+
+	void cplex_backend::set_optimality_tolerance(double tolerance)
+	{
+		check(CPXsetdblparam(_env, CPX_PARAM_EPGAP, tolerance), "set_optimality_tolerance", "Couldn't set the optimality tolerance.");
+	}
+
+
+	void cplex_backend::set_time_limit(double seconds)
+	{
+		check(CPXsetdblparam(_env, CPX_PARAM_TILIM, seconds), "set_time_limit", "Couldn't set the time limit.");
+	}
+
+
+	void cplex_backend::set_resources(const solver_resources& resources)
+	{
+		apply_solver_resources(_env, resources);
+	}
+
+
+	mip_status cplex_backend::solve()
+	{
+		if (_trace != nullptr)
+		{
+			mip_progress_recorder recorder(_env, *_trace);
+			check(CPXmipopt(_env, _problem), "solve", "CPXmipopt failed.");
+			recorder.finish(_problem);
+		}
+		else
+			check(CPXmipopt(_env, _problem), "solve", "CPXmipopt failed.");
+
+		const int solstat = CPXgetstat(_env, _problem);
+		if (solstat == CPXMIP_OPTIMAL)
+			return mip_status::optimal;
+		else if (solstat == CPXMIP_OPTIMAL_TOL)
+			return mip_status::optimal_tolerance;
+		else if (solstat == CPXMIP_TIME_LIM_FEAS)
+			return mip_status::time_limit_feasible;
+		else if (solstat == CPXMIP_MEM_LIM_FEAS)
+			return mip_status::memory_limit_feasible;
+		else if (solstat == CPXMIP_INFEASIBLE)
+			return mip_status::infeasible;
+		else if (solstat == CPXMIP_UNBOUNDED)
+			return mip_status::unbounded;
+		else if (solstat == CPXMIP_INForUNBD)
+			return mip_status::infeasible_or_unbounded;
+		else if (solstat == CPXMIP_TIME_LIM_INFEAS)
+			return mip_status::time_limit_infeasible;
+		else if (solstat == CPXMIP_MEM_LIM_INFEAS)
+			return mip_status::memory_limit_infeasible;
+		else
+			return mip_status::other;
+	}
+
+
+	double cplex_backend::get_objective_value() const
+	{
+		double objective_value = 0.0;
+		check(CPXgetobjval(_env, _problem, &objective_value), "get_objective_value", "Couldn't get the objective value.");
+		return objective_value;
+	}
+
+
+	double cplex_backend::get_best_bound() const
+	{
+		double bound = 0.0;
+		check(CPXgetbestobjval(_env, _problem, &bound), "get_best_bound", "Couldn't get the best bound.");
+		return bound;
+	}
+
+
+	void cplex_backend::get_solution(std::vector<double>& x) const
+	{
+		const int nb_columns = get_nb_columns();
+		x.assign(nb_columns, 0.0);
+		if (nb_columns > 0)
+			check(CPXgetx(_env, _problem, x.data(), 0, nb_columns - 1), "get_solution", "Couldn't get the solution.");
+	}
+
+
+	int cplex_backend::get_nb_columns() const
+	{
+		return CPXgetnumcols(_env, _problem);
+	}
+
+
+	int cplex_backend::get_nb_rows() const
+	{
+		return CPXgetnumrows(_env, _problem);
+	}
+
+
+	void cplex_backend::write(const std::string& file_name) const
+	{
+		check(CPXwriteprob(_env, _problem, file_name.c_str(), NULL), "write", "Couldn't write the problem to " + file_name + ".");
+	}
+
+
+	bool cplex_backend::read_cached_model(variable_layout& layout, const std::string& directory, const std::string& key)
+	{
+		return alg::read_cached_model(_env, _problem, layout, directory, key);
+	}
+
+
+	void cplex_backend::write_cached_model(const variable_layout& layout, const std::string& directory, const std::string& key) const
+	{
+		alg::write_cached_model(_env, _problem, layout, directory, key);
+	}
+
+
+	void cplex_backend::set_lazy_constraint_callback(cplex_lazy_constraint_callback callback, void* handle)
+	{
+		int status = 0;
+		if (callback != NULL)
+		{
+			status = CPXsetintparam(_env, CPX_PARAM_MIPCBREDLP, CPX_OFF);
+			if (status == 0)
+				status = CPXsetintparam(_env, CPX_PARAM_PRELINEAR, 0);
+			if (status == 0)
+				status = CPXsetlazyconstraintcallbackfunc(_env, callback, handle);
+			check(status, "set_lazy_constraint_callback", "Couldn't set the lazy constraint callback.");
+		}
+		else
+		{
+			status = CPXsetlazyconstraintcallbackfunc(_env, NULL, NULL);
+			if (status == 0)
+				status = CPXsetintparam(_env, CPX_PARAM_MIPCBREDLP, CPX_ON);
+			if (status == 0)
+				status = CPXsetintparam(_env, CPX_PARAM_PRELINEAR, 1);
+			check(status, "set_lazy_constraint_callback", "Couldn't remove the lazy constraint callback.");
+		}
+	}
+#endif // ALG_USE_CPLEX
+
+
+
+#ifdef ALG_USE_HIGHS
+	/*************************************************************************************************************************/
+	/******************************************************    HIGHS    ******************************************************/
+	/*************************************************************************************************************************/
+
+	highs_backend::highs_backend(const std::string& name)
+	{
+		_highs = Highs_create();
+		if (_highs == nullptr)
+			throw std::runtime_error("Error in function highs_backend::highs_backend(). \nCouldn't create the HiGHS problem " + name + ".");
+
+		check(Highs_changeObjectiveSense(_highs, kHighsObjSenseMinimize), "highs_backend", "Couldn't set the objective sense.");
+	}
+
+
+	highs_backend::~highs_backend()
+	{
+		if (_highs != nullptr)
+			Highs_destroy(_highs);
+	}
+
+
+	void highs_backend::check(int status, const std::string& function, const std::string& what) const
+	{
+		if (status == kHighsStatusError)
+			throw std::runtime_error("Error in function highs_backend::" + function + "(). \n" + what);
+	}
+
+
+	void highs_backend::row_bounds(char sense, double rhs, double& lower, double& upper) const
+	{
+		const double infinity = Highs_getInfinity(_highs);
+		lower = (sense == 'L') ? -infinity : rhs;
+		upper = (sense == 'G') ? infinity : rhs;
+	}
+
+
+	void highs_backend::add_columns(int nb_columns, const double* obj, const double* lb, const double* ub, const char* type, char** names)
+	{
+		if (nb_columns <= 0)
+			return;
+
+		const std::string first = (names != NULL) ? std::string(names[0]) : std::string();
+		const double infinity = Highs_getInfinity(_highs);
+		const int first_column = get_nb_columns();
+
+		std::vector<double> cost(nb_columns), lower(nb_columns), upper(nb_columns);
+		std::vector<HighsInt> integrality(nb_columns);
+		for (int j = 0; j < nb_columns; ++j)
+		{
+			cost[j] = (obj != NULL) ? obj[j] : 0.0;
+			lower[j] = (lb != NULL) ? lb[j] : 0.0;
+			upper[j] = (ub != NULL) ? ub[j] : infinity;
+			integrality[j] = kHighsVarTypeContinuous;
+			if (type != NULL && (type[j] == 'B' || type[j] == 'I'))
+				integrality[j] = kHighsVarTypeInteger;
+			if (type != NULL && type[j] == 'B' && upper[j] > 1.0)
+				upper[j] = 1.0;
+		}
+
+		check(Highs_addCols(_highs, nb_columns, cost.data(), lower.data(), upper.data(), 0, NULL, NULL, NULL), "add_columns", "Couldn't add variable " + first + ".");
+		check(Highs_changeColsIntegralityByRange(_highs, first_column, first_column + nb_columns - 1, integrality.data()), "add_columns", "Couldn't set the type of variable " + first + ".");
+		if (names != NULL)
+		{
+			for (int j = 0; j < nb_columns; ++j)
+				check(Highs_passColName(_highs, first_column + j, names[j]), "add_columns", "Couldn't name variable " + std::string(names[j]) + ".");
+		}
+
+		_lb.insert(_lb.end(), lower.begin(), lower.end());
+		_ub.insert(_ub.end(), upper.begin(), upper.end());
+	}
+
+
+	void highs_backend::add_rows(int nb_rows, int nb_nonzeros, const double* rhs, const char* sense, const int* matbeg, const int* matind, const double* matval, char** names)
+	{
+		if (nb_rows <= 0)
+			return;
+
+		const std::string first = (names != NULL) ? std::string(names[0]) : std::string();
+		const int first_row = get_nb_rows();
+
+		std::vector<double> lower(nb_rows), upper(nb_rows);
+		for (int i = 0; i < nb_rows; ++i)
+			row_bounds(sense[i], rhs[i], lower[i], upper[i]);
+
+		std::vector<HighsInt> start(matbeg, matbeg + nb_rows);
+		std::vector<HighsInt> index(matind, matind + nb_nonzeros);
+		check(Highs_addRows(_highs, nb_rows, lower.data(), upper.data(), nb_nonzeros, start.data(), index.data(), matval), "add_rows", "Couldn't add constraint " + first + ".");
+		if (names != NULL)
+		{
+			for (int i = 0; i < nb_rows; ++i)
+				check(Highs_passRowName(_highs, first_row + i, names[i]), "add_rows", "Couldn't name constraint " + std::string(names[i]) + ".");
+		}
+
+		_sense.insert(_sense.end(), sense, sense + nb_rows);
+	}
+
+
+	void highs_backend::change_objective(int nb_columns, const int* indices, const double* values)
+	{
+		for (int j = 0; j < nb_columns; ++j)
+			check(Highs_changeColCost(_highs, indices[j], values[j]), "change_objective", "Couldn't change the objective coefficients.");
+	}
+
+
+	void highs_backend::change_rhs(int nb_rows, const int* indices, const double* values)
+	{
+		double lower, upper;
+		for (int i = 0; i < nb_rows; ++i)
+		{
+			row_bounds(_sense.at(indices[i]), values[i], lower, upper);
+			check(Highs_changeRowBounds(_highs, indices[i], lower, upper), "change_rhs", "Couldn't change the right-hand sides.");
+		}
+	}
+
+
+	void highs_backend::get_bounds(std::vector<double>& lb, std::vector<double>& ub) const
+	{
+		lb = _lb;
+		ub = _ub;
+	}
+
+
+	void highs_backend::change_bounds(int nb_bounds, const int* indices, const char* lu, const double* bd)
+	{
+		for (int k = 0; k < nb_bounds; ++k)
+		{
+			const int j = indices[k];
+			if (lu[k] == 'L' || lu[k] == 'B')
+				_lb.at(j) = bd[k];
+			if (lu[k] == 'U' || lu[k] == 'B')
+				_ub.at(j) = bd[k];
+			check(Highs_changeColBounds(_highs, j, _lb[j], _ub[j]), "change_bounds", "Couldn't change the bounds of the variables.");
+		}
+	}
+
+
+	void highs_backend::add_mip_start(const std::vector<int>& columns, const std::vector<double>& values, const std::string& name)
+	{
+		if (columns.size() != values.size())
+			throw std::runtime_error("Error in function highs_backend::add_mip_start(). \nReason: The number of columns and values differ.");
+
+		// HiGHS keeps a single start, completed by the solver
+		std::vector<HighsInt> index(columns.begin(), columns.end());
+		check(Highs_setSparseSolution(_highs, static_cast<HighsInt>(index.size()), index.data(), values.data()), "add_mip_start", "Couldn't add MIP start " + name + ".");
+	}
+
+
+	void highs_backend::clear_mip_starts()
+	{
+		check(Highs_clearSolver(_highs), "clear_mip_starts", "Couldn't delete the MIP starts.");
+	}
+
+
+	void highs_backend::set_output(bool on)
+	{
+		check(Highs_setBoolOptionValue(_highs, "output_flag", on ? 1 : 0), "set_output", "Couldn't set the output option.");
+	}
+
+
+	void highs_backend::set_optimality_tolerance(double tolerance)
+	{
+		check(Highs_setDoubleOptionValue(_highs, "mip_rel_gap", tolerance), "set_optimality_tolerance", "Couldn't set the optimality tolerance.");
+	}
+
+
+	void highs_backend::set_time_limit(double seconds)
+	{
+		check(Highs_setDoubleOptionValue(_highs, "time_limit", seconds), "set_time_limit", "Couldn't set the time limit.");
+	}
+
+
+	void highs_backend::set_resources(const solver_resources& resources)
+	{
+		// HiGHS is always deterministic and has no memory or node file options, only the threads are set
+		check(Highs_setIntOptionValue(_highs, "threads", std::max(0, resources.threads)), "set_resources", "Couldn't set the number of threads.");
+	}
+
+
+	mip_status highs_backend::solve()
+	{
+		const auto start_time = std::chrono::steady_clock::now();
+		check(Highs_run(_highs), "solve", "Highs_run failed.");
+
+		HighsInt primal_status = kHighsSolutionStatusNone;
+		Highs_getIntInfoValue(_highs, "primal_solution_status", &primal_status);
+		const bool feasible = (primal_status == kHighsSolutionStatusFeasible);
+
+		// Only the final point is recorded, the progress during the solve is not traced for HiGHS
+		if (_trace != nullptr)
+		{
+			mip_progress_point point;
+			point.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+			point.incumbent_exists = feasible;
+			point.incumbent = feasible ? Highs_getObjectiveValue(_highs) : 0.0;
+			Highs_getDoubleInfoValue(_highs, "mip_dual_bound", &point.bound);
+			if (feasible)
+				Highs_getDoubleInfoValue(_highs, "mip_gap", &point.gap);
+			_trace->points.assign(1, point);
+		}
+
+		const HighsInt model_status = Highs_getModelStatus(_highs);
+		if (model_status == kHighsModelStatusOptimal)
+		{
+			double gap = 0.0;
+			Highs_getDoubleInfoValue(_highs, "mip_gap", &gap);
+			return (gap > 1e-9) ? mip_status::optimal_tolerance : mip_status::optimal;
+		}
+		else if (model_status == kHighsModelStatusInfeasible)
+			return mip_status::infeasible;
+		else if (model_status == kHighsModelStatusUnbounded)
+			return mip_status::unbounded;
+		else if (model_status == kHighsModelStatusUnboundedOrInfeasible)
+			return mip_status::infeasible_or_unbounded;
+		else if (model_status == kHighsModelStatusTimeLimit)
+			return feasible ? mip_status::time_limit_feasible : mip_status::time_limit_infeasible;
+		else if (model_status == kHighsModelStatusMemoryLimit)
+			return feasible ? mip_status::memory_limit_feasible : mip_status::memory_limit_infeasible;
+		else
+			return mip_status::other;
+	}
+
+
+	double highs_backend::get_objective_value() const
+	{
+		return Highs_getObjectiveValue(_highs);
+	}
+
+
+	double highs_backend::get_best_bound() const
+	{
+		double bound = 0.0;
+		check(Highs_getDoubleInfoValue(_highs, "mip_dual_bound", &bound), "get_best_bound", "Couldn't get the best bound.");
+		return bound;
+	}
+
+
+	void highs_backend::get_solution(std::vector<double>& x) const
+	{
+		const int nb_columns = get_nb_columns();
+		std::vector<double> row_value(get_nb_rows());
+		x.assign(nb_columns, 0.0);
+		check(Highs_getSolution(_highs, x.data(), NULL, row_value.data(), NULL), "get_solution", "Couldn't get the solution.");
+	}
+
+
+	int highs_backend::get_nb_columns() const
+	{
+		return static_cast<int>(Highs_getNumCol(_highs));
+	}
+
+
+	int highs_backend::get_nb_rows() const
+	{
+		return static_cast<int>(Highs_getNumRow(_highs));
+	}
+
+
+	void highs_backend::write(const std::string& file_name) const
+	{
+		check(Highs_writeModel(_highs, file_name.c_str()), "write", "Couldn't write the problem to " + file_name + ".");
+	}
+#endif // ALG_USE_HIGHS
+
+} // namespace alg
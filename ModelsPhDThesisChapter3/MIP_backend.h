@@ -0,0 +1,451 @@
+/*!
+*	@file	MIP_backend.h
+*	@author		Hendrik Vermuyten
+*	@brief	Solver-independent interface to build and solve the MIP models, with CPLEX and HiGHS implementations.
+*	The CPLEX implementation is only compiled if ALG_USE_CPLEX is defined and the HiGHS implementation only if ALG_USE_HIGHS is defined
+*	(add the include and library directories of the solver to the project).
+*/
+
+#ifndef MIP_BACKEND_H
+#define MIP_BACKEND_H
+
+#ifdef ALG_USE_CPLEX
+#include "ilcplex/cplex.h"
+#endif // ALG_USE_CPLEX
+#include "MIP_utilities.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+*	@namespace	alg
+*	@brief	The main namespace containing all algorithm elements.
+*/
+namespace alg
+{
+	/*!
+	*	@brief	The available MIP solvers.
+	*/
+	enum class mip_solver
+	{
+		cplex,	///< IBM ILOG CPLEX, requires ALG_USE_CPLEX
+		highs,	///< HiGHS (open source), requires ALG_USE_HIGHS
+	};
+
+	/*!
+	*	@brief	The solver of the MIP models if none is chosen: CPLEX if it is available in this build, HiGHS otherwise.
+	*/
+#ifdef ALG_USE_CPLEX
+	constexpr mip_solver default_mip_solver = mip_solver::cplex;
+#else
+	constexpr mip_solver default_mip_solver = mip_solver::highs;
+#endif // ALG_USE_CPLEX
+
+	/*!
+	*	@brief	The outcome of a MIP solve.
+	*/
+	enum class mip_status
+	{
+		optimal,					///< Optimal solution found
+		optimal_tolerance,			///< Solution found within the optimality tolerance
+		time_limit_feasible,		///< Time limit reached with a solution
+		memory_limit_feasible,		///< Memory limit reached with a solution
+		infeasible,					///< Problem is infeasible
+		unbounded,					///< Problem is unbounded
+		infeasible_or_unbounded,	///< Problem is infeasible or unbounded
+		time_limit_infeasible,		///< Time limit reached without a solution
+		memory_limit_infeasible,	///< Memory limit reached without a solution
+		other,						///< Other reason for failure
+	};
+
+	/*!
+	*	@brief	Check whether a solve with the given outcome has a solution.
+	*	@param	status	The outcome of the solve.
+	*	@returns	True if a solution exists, false otherwise.
+	*/
+	extern bool mip_status_has_solution(mip_status status);
+
+	/*!
+	*	@brief	Describe the outcome of a solve, for the output.
+	*	@param	status	The outcome of the solve.
+	*	@returns	The description.
+	*/
+	extern std::string mip_status_description(mip_status status);
+
+
+	/*!
+	*	@brief	A MIP problem in a solver. The problem is a minimization problem.
+	*	Columns and rows are added in bulk, in the same format as the CPLEX callable library.
+	*	All errors are reported by throwing a std::runtime_error.
+	*/
+	class mip_backend
+	{
+	protected:
+		/*!
+		*	@brief	The trace into which the progress of a solve is recorded (NULL: no recording).
+		*/
+		mip_solve_trace* _trace{ nullptr };
+
+	public:
+		/*!
+		*	@brief	Destructor. Frees the problem.
+		*/
+		virtual ~mip_backend() = default;
+
+		/*!
+		*	@brief	Add columns (variables) to the problem.
+		*	@param	nb_columns	The number of columns.
+		*	@param	obj		The objective coefficients (NULL: 0).
+		*	@param	lb		The lower bounds (NULL: 0).
+		*	@param	ub		The upper bounds (NULL: infinity).
+		*	@param	type	The types: 'C' (continuous), 'B' (binary) or 'I' (integer) (NULL: continuous).
+		*	@param	names	The names (NULL: no names).
+		*/
+		virtual void add_columns(int nb_columns, const double* obj, const double* lb, const double* ub, const char* type, char** names) = 0;
+
+		/*!
+		*	@brief	Add rows (constraints) to the problem.
+		*	@param	nb_rows		The number of rows.
+		*	@param	nb_nonzeros	The number of nonzero coefficients of all rows.
+		*	@param	rhs		The right-hand sides.
+		*	@param	sense	The senses: 'L' (<=), 'G' (>=) or 'E' (=).
+		*	@param	matbeg	The position of the first coefficient of each row in matind and matval.
+		*	@param	matind	The column of each coefficient.
+		*	@param	matval	The value of each coefficient.
+		*	@param	names	The names (NULL: no names).
+		*/
+		virtual void add_rows(int nb_rows, int nb_nonzeros, const double* rhs, const char* sense, const int* matbeg, const int* matind, const double* matval, char** names) = 0;
+
+		/*!
+		*	@brief	Change objective coefficients.
+		*	@param	nb_columns	The number of coefficients to change.
+		*	@param	indices	The columns.
+		*	@param	values	The new coefficients.
+		*/
+		virtual void change_objective(int nb_columns, const int* indices, const double* values) = 0;
+
+		/*!
+		*	@brief	Change right-hand sides.
+		*	@param	nb_rows	The number of right-hand sides to change.
+		*	@param	indices	The rows.
+		*	@param	values	The new right-hand sides.
+		*/
+		virtual void change_rhs(int nb_rows, const int* indices, const double* values) = 0;
+
+		/*!
+		*	@brief	Get the bounds of all columns.
+		*	@param	lb	The lower bounds.
+		*	@param	ub	The upper bounds.
+		*/
+		virtual void get_bounds(std::vector<double>& lb, std::vector<double>& ub) const = 0;
+
+		/*!
+		*	@brief	Change bounds of columns.
+		*	@param	nb_bounds	The number of bounds to change.
+		*	@param	indices	The columns.
+		*	@param	lu		The bounds: 'L' (lower), 'U' (upper) or 'B' (both).
+		*	@param	bd		The new bounds.
+		*/
+		virtual void change_bounds(int nb_bounds, const int* indices, const char* lu, const double* bd) = 0;
+
+		/*!
+		*	@brief	Add a MIP start. Values of the columns that are not given are completed by the solver.
+		*	@param	columns	The column indices.
+		*	@param	values	The value of each column.
+		*	@param	name	The name of the MIP start.
+		*/
+		virtual void add_mip_start(const std::vector<int>& columns, const std::vector<double>& values, const std::string& name) = 0;
+
+		/*!
+		*	@brief	Remove all MIP starts.
+		*/
+		virtual void clear_mip_starts() = 0;
+
+		/*!
+		*	@brief	Switch the output of the solver to the screen on or off.
+		*	@param	on	True to switch the output on.
+		*/
+		virtual void set_output(bool on) = 0;
+
+		/*!
+		*	@brief	Set the relative optimality tolerance.
+		*	@param	tolerance	The tolerance, from 0.0 to 1.0.
+		*/
+		virtual void set_optimality_tolerance(double tolerance) = 0;
+
+		/*!
+		*	@brief	Set the time limit.
+		*	@param	seconds	The time limit (in seconds).
+		*/
+		virtual void set_time_limit(double seconds) = 0;
+
+		/*!
+		*	@brief	Set the computing resources (threads, memory, node files, determinism) of the solves.
+		*	Settings that the solver does not support are ignored.
+		*	@param	resources	The resource settings.
+		*/
+		virtual void set_resources(const solver_resources& resources) = 0;
+
+		/*!
+		*	@brief	Record the progress of the next solves.
+		*	@param	trace	The trace to record into, NULL to stop recording.
+		*/
+		void set_progress_trace(mip_solve_trace* trace) { _trace = trace; }
+
+		/*!
+		*	@brief	Solve the problem.
+		*	@returns	The outcome of the solve.
+		*/
+		virtual mip_status solve() = 0;
+
+		/*!
+		*	@brief	Get the objective value of the solution of the last solve.
+		*	@returns	The objective value.
+		*/
+		virtual double get_objective_value() const = 0;
+
+		/*!
+		*	@brief	Get the best bound on the objective value of the last solve.
+		*	@returns	The best bound.
+		*/
+		virtual double get_best_bound() const = 0;
+
+		/*!
+		*	@brief	Get the solution of the last solve.
+		*	@param	x	The value of every column.
+		*/
+		virtual void get_solution(std::vector<double>& x) const = 0;
+
+		/*!
+		*	@brief	Get the number of columns.
+		*	@returns	The number of columns.
+		*/
+		virtual int get_nb_columns() const = 0;
+
+		/*!
+		*	@brief	Get the number of rows.
+		*	@returns	The number of rows.
+		*/
+		virtual int get_nb_rows() const = 0;
+
+		/*!
+		*	@brief	Write the problem to a file. The format is given by the extension (e.g. .lp).
+		*	@param	file_name	The name of the file.
+		*/
+		virtual void write(const std::string& file_name) const = 0;
+	};
+
+	/*!
+	*	@brief	Create an empty minimization problem in the given solver.
+	*	@param	solver	The solver.
+	*	@param	name	The name of the problem.
+	*	@returns	The problem.
+	*/
+	extern std::unique_ptr<mip_backend> create_mip_backend(mip_solver solver, const std::string& name);
+
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	A CPLEX lazy constraint callback.
+	*/
+	typedef int (CPXPUBLIC *cplex_lazy_constraint_callback)(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p);
+
+	/*!
+	*	@brief	A MIP problem in CPLEX.
+	*	Besides the interface, it offers the features that only CPLEX has: lazy constraint callbacks and the model cache (SAV files).
+	*/
+	class cplex_backend : public mip_backend
+	{
+		/*!
+		*	@brief	Pointer to the CPLEX environment.
+		*/
+		CPXENVptr _env{ nullptr };
+
+		/*!
+		*	@brief	Pointer to the CPLEX problem.
+		*/
+		CPXLPptr _problem{ nullptr };
+
+		/*!
+		*	@brief	True if the problem and environment are freed and released by this object.
+		*/
+		bool _owner = false;
+
+		/*!
+		*	@brief	Store for CPLEX error messages.
+		*/
+		mutable char _error_text[CPXMESSAGEBUFSIZE];
+
+		/*!
+		*	@brief	Throw an exception if a CPLEX function failed.
+		*	@param	status		The status returned by CPLEX.
+		*	@param	function	The name of the calling function.
+		*	@param	what		What failed.
+		*/
+		void check(int status, const std::string& function, const std::string& what) const;
+
+	public:
+		/*!
+		*	@brief	Constructor. Creates a problem in an environment from the process-wide pool.
+		*	@param	name	The name of the problem.
+		*/
+		explicit cplex_backend(const std::string& name);
+
+		/*!
+		*	@brief	Constructor. Wraps an existing problem, which is not freed by this object.
+		*	@param	env		The CPLEX environment.
+		*	@param	problem	The CPLEX problem.
+		*/
+		cplex_backend(CPXENVptr env, CPXLPptr problem) : _env(env), _problem(problem), _owner(false) { }
+
+		/*!
+		*	@brief	Destructor. Frees the problem and returns the environment to the pool, if they are owned.
+		*/
+		~cplex_backend() override;
+
+		cplex_backend(const cplex_backend&) = delete;
+		cplex_backend& operator=(const cplex_backend&) = delete;
+
+		/*!
+		*	@brief	Get the CPLEX environment, for settings that are not part of the interface.
+		*	@returns	The CPLEX environment.
+		*/
+		CPXENVptr get_env() const { return _env; }
+
+		/*!
+		*	@brief	Get the CPLEX problem, for functionality that is not part of the interface.
+		*	@returns	The CPLEX problem.
+		*/
+		CPXLPptr get_problem() const { return _problem; }
+
+		/*!
+		*	@brief	Replace the problem by a cached model, see alg::read_cached_model().
+		*	@param	layout		Column indices of the variable families, read from the cache.
+		*	@param	directory	The directory of the cache.
+		*	@param	key			The key of the model.
+		*	@returns	True if the model was found and read, false if it has to be built.
+		*/
+		bool read_cached_model(variable_layout& layout, const std::string& directory, const std::string& key);
+
+		/*!
+		*	@brief	Write the problem to the cache, see alg::write_cached_model().
+		*	@param	layout		Column indices of the variable families in the problem.
+		*	@param	directory	The directory of the cache, which must exist.
+		*	@param	key			The key of the model.
+		*/
+		void write_cached_model(const variable_layout& layout, const std::string& directory, const std::string& key) const;
+
+		/*!
+		*	@brief	Install a lazy constraint callback on the environment. Reductions that are invalid with lazy constraints
+		*	(linear reductions in presolve, callbacks on the reduced problem) are switched off while the callback is installed.
+		*	@param	callback	The callback, NULL to remove the callback and restore the default settings.
+		*	@param	handle		The handle that is passed to the callback.
+		*/
+		void set_lazy_constraint_callback(cplex_lazy_constraint_callback callback, void* handle);
+
+		void add_columns(int nb_columns, const double* obj, const double* lb, const double* ub, const char* type, char** names) override;
+		void add_rows(int nb_rows, int nb_nonzeros, const double* rhs, const char* sense, const int* matbeg, const int* matind, const double* matval, char** names) override;
+		void change_objective(int nb_columns, const int* indices, const double* values) override;
+		void change_rhs(int nb_rows, const int* indices, const double* values) override;
+		void get_bounds(std::vector<double>& lb, std::vector<double>& ub) const override;
+		void change_bounds(int nb_bounds, const int* indices, const char* lu, const double* bd) override;
+		void add_mip_start(const std::vector<int>& columns, const std::vector<double>& values, const std::string& name) override;
+		void clear_mip_starts() override;
+		void set_output(bool on) override;
+		void set_optimality_tolerance(double tolerance) override;
+		void set_time_limit(double seconds) override;
+		void set_resources(const solver_resources& resources) override;
+		mip_status solve() override;
+		double get_objective_value() const override;
+		double get_best_bound() const override;
+		void get_solution(std::vector<double>& x) const override;
+		int get_nb_columns() const override;
+		int get_nb_rows() const override;
+		void write(const std::string& file_name) const override;
+	};
+#endif // ALG_USE_CPLEX
+
+
+#ifdef ALG_USE_HIGHS
+	/*!
+	*	@brief	A MIP problem in HiGHS.
+	*/
+	class highs_backend : public mip_backend
+	{
+		/*!
+		*	@brief	Pointer to the HiGHS instance.
+		*/
+		void* _highs{ nullptr };
+
+		/*!
+		*	@brief	The lower bounds of the columns.
+		*/
+		std::vector<double> _lb;
+
+		/*!
+		*	@brief	The upper bounds of the columns.
+		*/
+		std::vector<double> _ub;
+
+		/*!
+		*	@brief	The sense of each row, needed to change right-hand sides.
+		*/
+		std::vector<char> _sense;
+
+		/*!
+		*	@brief	Throw an exception if a HiGHS function failed.
+		*	@param	status		The status returned by HiGHS.
+		*	@param	function	The name of the calling function.
+		*	@param	what		What failed.
+		*/
+		void check(int status, const std::string& function, const std::string& what) const;
+
+		/*!
+		*	@brief	Get the lower and upper bound of a row with the given sense and right-hand side.
+		*	@param	sense	The sense of the row.
+		*	@param	rhs		The right-hand side of the row.
+		*	@param	lower	The lower bound of the row.
+		*	@param	upper	The upper bound of the row.
+		*/
+		void row_bounds(char sense, double rhs, double& lower, double& upper) const;
+
+	public:
+		/*!
+		*	@brief	Constructor. Creates an empty problem.
+		*	@param	name	The name of the problem.
+		*/
+		explicit highs_backend(const std::string& name);
+
+		/*!
+		*	@brief	Destructor. Frees the problem.
+		*/
+		~highs_backend() override;
+
+		highs_backend(const highs_backend&) = delete;
+		highs_backend& operator=(const highs_backend&) = delete;
+
+		void add_columns(int nb_columns, const double* obj, const double* lb, const double* ub, const char* type, char** names) override;
+		void add_rows(int nb_rows, int nb_nonzeros, const double* rhs, const char* sense, const int* matbeg, const int* matind, const double* matval, char** names) override;
+		void change_objective(int nb_columns, const int* indices, const double* values) override;
+		void change_rhs(int nb_rows, const int* indices, const double* values) override;
+		void get_bounds(std::vector<double>& lb, std::vector<double>& ub) const override;
+		void change_bounds(int nb_bounds, const int* indices, const char* lu, const double* bd) override;
+		void add_mip_start(const std::vector<int>& columns, const std::vector<double>& values, const std::string& name) override;
+		void clear_mip_starts() override;
+		void set_output(bool on) override;
+		void set_optimality_tolerance(double tolerance) override;
+		void set_time_limit(double seconds) override;
+		void set_resources(const solver_resources& resources) override;
+		mip_status solve() override;
+		double get_objective_value() const override;
+		double get_best_bound() const override;
+		void get_solution(std::vector<double>& x) const override;
+		int get_nb_columns() const override;
+		int get_nb_rows() const override;
+		void write(const std::string& file_name) const override;
+	};
+#endif // ALG_USE_HIGHS
+
+} // namespace alg
+
+#endif // !MIP_BACKEND_H
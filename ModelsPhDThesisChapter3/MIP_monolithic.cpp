@@ -3,10 +3,15 @@
 #include "building_data.h"
 #include "initial_solution.h"
 #include "logger.h"
+#include "MIP_utilities.h"
 
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
 
 
 namespace alg
@@ -15,12 +20,13 @@ namespace alg
 	{
 		auto start_time = std::chrono::system_clock::now();
 
-		initialize_cplex();
+		initialize_solver();
 		build_problem();
 		if (constraint_on_preferences)
 			add_constraint_preferences(value_pref);
 		if (constraint_on_T)
 			add_constraint_TT(value_T);
+		add_mip_start_solution(mip_start_lecture_timeslot, mip_start_lecture_room);
 
 		solve_problem();
 
@@ -38,52 +44,299 @@ namespace alg
 
 		write_output();
 
-		clear_cplex();
+		clear_solver();
 	}
 
 
-	void MIP_monolithic::initialize_cplex()
+	void MIP_monolithic::run_pareto_sweep(const std::vector<std::pair<double, double>>& weights)
 	{
-		int status = 0;
+		pareto_points.clear();
+		pareto_points.reserve(weights.size());
 
-		// Open the cplex environment
-		env = CPXopenCPLEX(&status);
-		if (status != 0)
+		// The constraints do not depend on the weights, so the model is built only once
+		initialize_solver();
+		build_problem();
+
+		for (auto&& weight : weights)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::initialize_cplex(). \nCouldn't open CPLEX. \nReason: " + std::string(error_text));
+			auto start_time = std::chrono::system_clock::now();
+
+			_lambda = weight.first;
+			_alpha = weight.second;
+			update_objective_coefficients();
+
+			// Warm start from the solution of the previous point (still feasible, only the objective has changed)
+			backend->clear_mip_starts();
+			if (!pareto_points.empty() && pareto_points.back().solution_exists)
+				add_mip_start_solution(pareto_points.back().lecture_timeslot, pareto_points.back().lecture_room);
+			else
+				add_mip_start_solution(mip_start_lecture_timeslot, mip_start_lecture_room);
+
+			solve_problem();
+
+			computation_time = std::chrono::system_clock::now() - start_time;
+
+			write_output();
+
+			pareto_point point;
+			point.lambda = _lambda;
+			point.alpha = _alpha;
+			point.solution_exists = solution_exists;
+			point.solution_info = solution_info;
+			point.computation_time = get_computation_time();
+			if (solution_exists)
+			{
+				point.objective_value = objective_value;
+				point.preferences = compute_preferences(solution_lecture_timeslot);
+				point.travel_times = solution_travel_times;
+				point.evacuation_times = solution_evacuation_times;
+				point.lecture_timeslot = solution_lecture_timeslot;
+				point.lecture_room = solution_lecture_room;
+			}
+			pareto_points.push_back(point);
 		}
 
-		// Set the output to screen on/off
-		status = CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_ON);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::initialize_cplex(). \nCouldn't set the output to screen off. \nReason: " + std::string(error_text));
+		clear_solver();
+	}
+
+
+	void MIP_monolithic::run_epsilon_constraint(int nb_points)
+	{
+		if (nb_points < 2)
+			throw std::runtime_error("Error in function MIP_monolithic::run_epsilon_constraint(). \nReason: At least two points are needed for the front.");
+
+		auto start_time = std::chrono::system_clock::now();
+
+		// 1. extreme points: best preferences (lambda = 1) and best travel / evacuation times (lambda = 0),
+		// each with the other objective as tie-breaker, so that both are efficient and the grid spans the true range
+		const double lambda = _lambda;
+		initialize_solver();
+		build_problem();
+
+		// A non-binding bound on each objective, tightened by solve_lexicographic_anchor()
+		_lambda = 1;
+		add_constraint_objective(1e10);
+		_lambda = 0;
+		add_constraint_objective(1e10);
+		const int row_preferences = backend->get_nb_rows() - 2;
+		const int row_times = backend->get_nb_rows() - 1;
+
+		const pareto_point anchor_preferences = solve_lexicographic_anchor(1.0, row_preferences, mip_start_lecture_timeslot, mip_start_lecture_room);
+		if (!anchor_preferences.solution_exists)
+			throw std::runtime_error("Error in function MIP_monolithic::run_epsilon_constraint(). \nReason: No solution for the extreme points of the front. " + anchor_preferences.solution_info);
+		const pareto_point anchor_times = solve_lexicographic_anchor(0.0, row_times, anchor_preferences.lecture_timeslot, anchor_preferences.lecture_room);
+		if (!anchor_times.solution_exists)
+			throw std::runtime_error("Error in function MIP_monolithic::run_epsilon_constraint(). \nReason: No solution for the extreme points of the front. " + anchor_times.solution_info);
+
+		clear_solver();
+		_lambda = lambda;
+
+		// 2. epsilon values, from the tightest to the loosest bound on the preferences
+		const int pref_min = anchor_preferences.preferences;
+		const int pref_max = std::max(anchor_times.preferences, pref_min);
+		std::vector<pareto_point> points(nb_points);
+		constexpr double augmentation_delta = 1e-3;
+		const double preference_augmentation = augmentation_delta / std::max(1, pref_max - pref_min);
+		for (int k = 0; k < nb_points; ++k)
+		{
+			points[k].lambda = 0;
+			points[k].alpha = _alpha;
+			points[k].epsilon = pref_min + static_cast<double>(pref_max - pref_min) * k / (nb_points - 1);
+		}
+
+		// 3. solve the points in parallel, dividing the thread budget over the workers
+		int nb_threads = _nb_threads_epsilon;
+		if (nb_threads <= 0)
+			nb_threads = _resources.threads;
+		if (nb_threads <= 0)
+			nb_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		const int nb_workers = std::min(nb_threads, nb_points);
+		const solver_resources worker_resources = share_solver_resources(_resources, nb_threads, nb_workers);
+
+		std::vector<bool> solved(nb_points, false);
+		std::vector<mip_solve_trace> traces(nb_points);
+		std::atomic<int> next_point{ 0 };
+		std::mutex points_mutex;
+
+		std::vector<std::future<void>> workers;
+		workers.reserve(nb_workers);
+		for (int w = 0; w < nb_workers; ++w)
+			workers.push_back(std::async(std::launch::async, &MIP_monolithic::solve_epsilon_points, this, std::ref(points), std::ref(solved), std::cref(anchor_preferences), preference_augmentation, std::ref(next_point), std::ref(points_mutex), std::ref(traces), std::cref(worker_resources)));
+
+		// Wait for all workers, rethrowing the first error
+		for (auto&& w : workers)
+			w.get();
+		progress_traces.insert(progress_traces.end(), traces.begin(), traces.end());
+
+		// 4. keep the non-dominated points
+		pareto_points.clear();
+		for (auto&& point : points)
+		{
+			bool dominated = !point.solution_exists;
+			for (auto&& other : points)
+			{
+				if (!dominated && other.solution_exists && other.preferences <= point.preferences && other.objective_value <= point.objective_value
+					&& (other.preferences < point.preferences || other.objective_value < point.objective_value))
+					dominated = true;
+			}
+			if (!dominated)
+				pareto_points.push_back(point);
 		}
 
-		// Set tolerance gap
-		status = CPXsetdblparam(env, CPX_PARAM_EPGAP, _optimality_tolerance);
-		if (status != 0)
+		computation_time = std::chrono::system_clock::now() - start_time;
+
+		write_output_pareto_front();
+	}
+
+
+	void MIP_monolithic::solve_epsilon_points(std::vector<pareto_point>& points, std::vector<bool>& solved, const pareto_point& anchor, double preference_augmentation, std::atomic<int>& next_point, std::mutex& points_mutex, std::vector<mip_solve_trace>& traces, const solver_resources& resources) const
+	{
+		// Own copy of the model, minimizing the travel / evacuation times with the preferences as tie-breaker
+		MIP_monolithic model;
+		model._lambda = 0;
+		model._preference_augmentation = preference_augmentation;
+		model._alpha = _alpha;
+		model._optimality_tolerance = _optimality_tolerance;
+		model._time_limit = _time_limit;
+		model._objective_type = _objective_type;
+		model._solver = _solver;
+		model._lazy_travel_constraints = _lazy_travel_constraints;
+		model._model_cache_directory = _model_cache_directory;
+		model._progress_trace_file.clear();
+		model._resources = resources;
+		model.write_model_file = false;
+
+		// The problem is freed with the model, also if an exception is thrown
+		model.initialize_solver();
+		model.backend->set_output(false);
+		model.build_problem();
+
+		// The right-hand side of this constraint is changed for every point
+		model.add_constraint_preferences(anchor.preferences);
+		const int row = model.backend->get_nb_rows() - 1;
+
+		for (int k = next_point++; k < static_cast<int>(points.size()); k = next_point++)
+		{
+			auto start_time = std::chrono::system_clock::now();
+
+			double rhs[1] = { points[k].epsilon };
+			model.backend->change_rhs(1, &row, rhs);
+
+			// MIP start: the nearest solved point with a tighter bound, which is feasible for this point
+			std::vector<int> start_timeslot = anchor.lecture_timeslot;
+			std::vector<int> start_room = anchor.lecture_room;
+			{
+				std::lock_guard<std::mutex> lock(points_mutex);
+				for (int j = k - 1; j >= 0; --j)
+				{
+					if (solved[j] && points[j].solution_exists)
+					{
+						start_timeslot = points[j].lecture_timeslot;
+						start_room = points[j].lecture_room;
+						break;
+					}
+				}
+			}
+			model.backend->clear_mip_starts();
+			model.add_mip_start_solution(start_timeslot, start_room);
+
+			model.solve_problem();
+
+			pareto_point point = points[k];
+			point.solution_exists = model.solution_exists;
+			point.solution_info = model.solution_info;
+			point.computation_time = std::chrono::duration<double>(std::chrono::system_clock::now() - start_time).count();
+			if (model.solution_exists)
+			{
+				point.preferences = compute_preferences(model.solution_lecture_timeslot);
+				point.objective_value = model.objective_value - preference_augmentation * point.preferences;
+				point.travel_times = model.solution_travel_times;
+				point.evacuation_times = model.solution_evacuation_times;
+				point.lecture_timeslot = model.solution_lecture_timeslot;
+				point.lecture_room = model.solution_lecture_room;
+			}
+
+			std::lock_guard<std::mutex> lock(points_mutex);
+			points[k] = point;
+			solved[k] = true;
+			traces[k] = model.progress_traces.back();
+			traces[k].name = "monolithic epsilon=" + std::to_string(points[k].epsilon);
+		}
+
+		model.clear_solver();
+	}
+
+
+	pareto_point MIP_monolithic::solve_lexicographic_anchor(double lambda, int row_first, const std::vector<int>& start_timeslot, const std::vector<int>& start_room)
+	{
+		auto start_time = std::chrono::system_clock::now();
+
+		// 1. minimize the first objective
+		_lambda = lambda;
+		update_objective_coefficients();
+		backend->clear_mip_starts();
+		add_mip_start_solution(start_timeslot, start_room);
+		solve_problem();
+
+		// 2. bound the first objective at its optimum and minimize the second, starting from the first solution
+		if (solution_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::initialize_cplex(). \nCouldn't set the tolerance gap. \nReason: " + std::string(error_text));
+			double rhs[1] = { objective_value + 1e-6 * std::max(1.0, std::abs(objective_value)) };
+			backend->change_rhs(1, &row_first, rhs);
+
+			const std::vector<int> first_timeslot = solution_lecture_timeslot;
+			const std::vector<int> first_room = solution_lecture_room;
+			_lambda = 1 - lambda;
+			update_objective_coefficients();
+			backend->clear_mip_starts();
+			add_mip_start_solution(first_timeslot, first_room);
+			solve_problem();
+
+			rhs[0] = 1e10;
+			backend->change_rhs(1, &row_first, rhs);
 		}
 
-		// Time limit for the MIP
-		status = CPXsetdblparam(env, CPX_PARAM_TILIM, _time_limit);
-		if (status != 0)
+		computation_time = std::chrono::system_clock::now() - start_time;
+
+		write_output();
+
+		pareto_point point;
+		point.lambda = _lambda;
+		point.alpha = _alpha;
+		point.solution_exists = solution_exists;
+		point.solution_info = solution_info;
+		point.computation_time = get_computation_time();
+		if (solution_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::initialize_cplex(). \nCouldn't set the time limit. \nReason: " + std::string(error_text));
+			point.objective_value = objective_value;
+			point.preferences = compute_preferences(solution_lecture_timeslot);
+			point.travel_times = solution_travel_times;
+			point.evacuation_times = solution_evacuation_times;
+			point.lecture_timeslot = solution_lecture_timeslot;
+			point.lecture_room = solution_lecture_room;
 		}
+		return point;
+	}
+
+
+	void MIP_monolithic::initialize_solver()
+	{
+		progress_traces.clear();
+
+		// Create an empty minimization problem in the chosen solver
+		backend = create_mip_backend(_solver, "problem");
+
+		// Set the output to screen on, the tolerance gap and the time limit for the MIP
+		backend->set_output(true);
+		backend->set_optimality_tolerance(_optimality_tolerance);
+		backend->set_time_limit(_time_limit);
+		backend->set_resources(_resources);
 	}
 
 
 	void MIP_monolithic::build_problem()
 	{
 		constexpr int Big_M = 10000;
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -99,27 +352,31 @@ namespace alg
 
 
 											// Create arrays
-		matind = std::make_unique<int[]>(10000000);
-		matval = std::make_unique<double[]>(10000000);
-
-		// Create the problem
-		problem = CPXcreateprob(env, &status, "problem");
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't create the CPLEX problem. \nReason: " + std::string(error_text));
-		}
-
-		// Problem is minimization
-		CPXchgobjsen(env, problem, CPX_MIN);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't set the problem type to minimization. \nReason: " + std::string(error_text));
+		const int max_row_length = std::max(max_row_length_timetable(), max_row_length_flows());
+		matind = std::make_unique<int[]>(max_row_length);
+		matval = std::make_unique<double[]>(max_row_length);
+
+#ifdef ALG_USE_CPLEX
+		// Read the model from the cache if it has been built before (CPLEX only, the cache holds SAV files)
+		std::string cache_key;
+		cplex_backend* cplex_problem = dynamic_cast<cplex_backend*>(backend.get());
+		if (cplex_problem != nullptr && !_model_cache_directory.empty())
+		{
+			const double objective_type_value = (_objective_type == objective_type::maximum_over_timeslots ? 0 : 1);
+			cache_key = model_cache_key("monolithic", { _lambda, _alpha, _preference_augmentation, objective_type_value, lazy_travel_constraints_enabled() ? 1.0 : 0.0 });
+			if (cplex_problem->read_cached_model(layout, _model_cache_directory, cache_key))
+			{
+				finish_build_problem();
+				return;
+			}
 		}
+#endif // ALG_USE_CPLEX
 
 		// VARIABLES
+		layout.clear();
+
 		// Add the X_ltc variables
+		layout.add_family(variable_family::x_ltc, nb_sessions, nb_timeslots, nb_locations);
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int t = 0; t < nb_timeslots; ++t)
@@ -129,23 +386,20 @@ namespace alg
 					std::string name = "x_" + std::to_string(l + 1) + "_" + std::to_string(t + 1) + "_" + std::to_string(c + 1);
 					colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = _lambda * (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t));
+					obj[0] = (_lambda + _preference_augmentation) * (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t));
 
 					lb[0] = 0;
 					ub[0] = 1;
 					type[0] = 'B';
 
-					status = CPXnewcols(env, problem, 1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::x_ltc, l, t, c);
+					backend->add_columns(1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the U(travel)_tsp variables
+		layout.add_family(variable_family::U_travel_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -158,17 +412,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::U_travel_tsp, t, s, p);
+					backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel_arc)_tij variables
+		layout.add_family(variable_family::T_travel_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -179,16 +430,13 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout.add_column(variable_family::T_travel_arc_tij, t, ij);
+				backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(travel)_tsp variables
+		layout.add_family(variable_family::T_travel_total_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -201,17 +449,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::T_travel_total_tsp, t, s, p);
+					backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel)_t,max variables
+		layout.add_family(variable_family::T_travel_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_travel_max_" + std::to_string(t + 1);
@@ -223,15 +468,12 @@ namespace alg
 				obj[0] = (1 - _lambda)*(1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_travel_max_t, t);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the U(evac)_tlp variables
+		layout.add_family(variable_family::U_evac_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
@@ -244,17 +486,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::U_evac_tlp, t, l, p);
+					backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(evac_arc)_tij variables
+		layout.add_family(variable_family::T_evac_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -265,16 +504,13 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout.add_column(variable_family::T_evac_arc_tij, t, ij);
+				backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(evac)_tlp variables
+		layout.add_family(variable_family::T_evac_total_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
@@ -287,17 +523,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::T_evac_total_tlp, t, l, p);
+					backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(evac)_t,max variables
+		layout.add_family(variable_family::T_evac_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_evac_max_" + std::to_string(t + 1);
@@ -309,15 +542,12 @@ namespace alg
 				obj[0] = (1 - _lambda)*_alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_evac_max_t, t);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(travel)_max_overall variable
+		layout.add_family(variable_family::T_travel_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_travel_max_overall";
@@ -326,15 +556,12 @@ namespace alg
 			obj[0] = (1 - _lambda)*(1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_travel_max_overall);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(evac)_max_overall variable
+		layout.add_family(variable_family::T_evac_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_evac_max_overall";
@@ -343,12 +570,8 @@ namespace alg
 			obj[0] = (1 - _lambda)*_alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_evac_max_overall);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 
@@ -372,19 +595,14 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c))
 					{
-						matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+						matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 			}
 
-			status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-			}
+			backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 		}
 
 
@@ -406,18 +624,13 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c))
 					{
-						matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+						matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -443,25 +656,20 @@ namespace alg
 						{
 							if (get_sessionlocationpossible(l, c))
 							{
-								matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 								matval[f] = 1;
 								++f;
 							}
 
 							if (get_sessionlocationpossible(m, c))
 							{
-								matind[f] = m * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, m, t, c);
 								matval[f] = 1;
 								++f;
 							}
 						}
 
-						status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -492,7 +700,7 @@ namespace alg
 							{
 								if (get_sessionlocationpossible(l, c))
 								{
-									matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+									matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 									matval[f] = 1;
 									++f;
 								}
@@ -501,12 +709,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -535,22 +738,22 @@ namespace alg
 								if (get_sessionlocationpossible(l, c))
 								{
 									// t
-									matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+									matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 									matval[f] = 1;
 									++f;
 
 									// t + 1
-									matind[f] = l * nb_timeslots*nb_locations + (t + 1) * nb_locations + c;
+									matind[f] = layout.index(variable_family::x_ltc, l, t + 1, c);
 									matval[f] = 1;
 									++f;
 
 									// t + 2
-									matind[f] = l * nb_timeslots*nb_locations + (t + 2) * nb_locations + c;
+									matind[f] = layout.index(variable_family::x_ltc, l, t + 2, c);
 									matval[f] = 1;
 									++f;
 
 									// t + 3
-									matind[f] = l * nb_timeslots*nb_locations + (t + 3) * nb_locations + c;
+									matind[f] = layout.index(variable_family::x_ltc, l, t + 3, c);
 									matval[f] = 1;
 									++f;
 								}
@@ -559,12 +762,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -591,12 +789,12 @@ namespace alg
 							if (get_sessionlocationpossible(l, c))
 							{
 								// first timeslot of day
-								matind[f] = l * nb_timeslots*nb_locations + day * nb_timeslots_per_day * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, day * nb_timeslots_per_day, c);
 								matval[f] = 1;
 								++f;
 
 								// last timeslot of day
-								matind[f] = l * nb_timeslots*nb_locations + ((day + 1)*nb_timeslots_per_day - 1) * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, (day + 1)*nb_timeslots_per_day - 1, c);
 								matval[f] = 1;
 								++f;
 							}
@@ -604,12 +802,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -636,12 +829,12 @@ namespace alg
 							if (get_sessionlocationpossible(l, c))
 							{
 								// last timeslot of day
-								matind[f] = l * nb_timeslots*nb_locations + ((day + 1)*nb_timeslots_per_day - 1) * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, (day + 1)*nb_timeslots_per_day - 1, c);
 								matval[f] = 1;
 								++f;
 
 								// first timeslot of next day
-								matind[f] = l * nb_timeslots*nb_locations + (day + 1)*nb_timeslots_per_day * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, (day + 1)*nb_timeslots_per_day, c);
 								matval[f] = 1;
 								++f;
 
@@ -651,12 +844,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -689,17 +877,17 @@ namespace alg
 										if (get_sessionlocationpossible(l, c))
 										{
 											// timeslot t
-											matind[f] = l * nb_timeslots*nb_locations + (day*nb_timeslots_per_day + t) * nb_locations + c;
+											matind[f] = layout.index(variable_family::x_ltc, l, day*nb_timeslots_per_day + t, c);
 											matval[f] = 1;
 											++f;
 
 											// timeslot t + 2
-											matind[f] = l * nb_timeslots*nb_locations + (day*nb_timeslots_per_day + t + 2) * nb_locations + c;
+											matind[f] = layout.index(variable_family::x_ltc, l, day*nb_timeslots_per_day + t + 2, c);
 											matval[f] = 1;
 											++f;
 
 											// timeslot t + 1
-											matind[f] = l * nb_timeslots*nb_locations + (day*nb_timeslots_per_day + t + 1) * nb_locations + c;
+											matind[f] = layout.index(variable_family::x_ltc, l, day*nb_timeslots_per_day + t + 1, c);
 											matval[f] = -1;
 											++f;
 										}
@@ -707,12 +895,7 @@ namespace alg
 								}
 							}
 
-							status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-							}
+							backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 						}
 					}
 				}
@@ -725,60 +908,59 @@ namespace alg
 
 		// FLOWS BETWEEN EVENTS IN CONSECUTIVE TIMESLOTS
 		// Constraint set 8: U_tsp constraints 
-		for (int t = 0; t < nb_timeslots; ++t)
+		// Left out if they are separated in the lazy constraint callback
+		if (!lazy_travel_constraints_enabled())
 		{
-			for (int s = 0; s < nb_series; ++s)
+			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				for (int l = 0; l < nb_sessions; ++l)
+				for (int s = 0; s < nb_series; ++s)
 				{
-					if (get_seriessession(s, l))
+					for (int l = 0; l < nb_sessions; ++l)
 					{
-						for (int m = 0; m < nb_sessions; ++m)
+						if (get_seriessession(s, l))
 						{
-							if (get_seriessession(s, m))
+							for (int m = 0; m < nb_sessions; ++m)
 							{
-								for (int c = 0; c < nb_locations; ++c)
+								if (get_seriessession(s, m))
 								{
-									if (get_sessionlocationpossible(l, c))
+									for (int c = 0; c < nb_locations; ++c)
 									{
-										for (int d = 0; d < nb_locations; ++d)
+										if (get_sessionlocationpossible(l, c))
 										{
-											if (get_sessionlocationpossible(m, d))
+											for (int d = 0; d < nb_locations; ++d)
 											{
-												for (int p = 0; p < nb_paths; ++p)
+												if (get_sessionlocationpossible(m, d))
 												{
-													if (get_roomroompath(c, d, p) > 0)
+													for (int p = 0; p < nb_paths; ++p)
 													{
-														sense[0] = 'L';
-														rhs[0] = get_roomroompath(c, d, p);
+														if (get_roomroompath(c, d, p) > 0)
+														{
+															sense[0] = 'L';
+															rhs[0] = get_roomroompath(c, d, p);
 
-														std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
-														rowname[0] = const_cast<char*>(name.c_str());
+															std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
+															rowname[0] = const_cast<char*>(name.c_str());
 
-														matbeg[0] = 0;
-														f = 0;
+															matbeg[0] = 0;
+															f = 0;
 
-														// x_ltc
-														matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
-														matval[f] = get_roomroompath(c, d, p);
-														++f;
+															// x_ltc
+															matind[f] = layout.index(variable_family::x_ltc, l, t, c);
+															matval[f] = get_roomroompath(c, d, p);
+															++f;
 
-														// x_l,t+1,d
-														matind[f] = m * nb_timeslots*nb_locations + (t + 1) * nb_locations + d;
-														matval[f] = get_roomroompath(c, d, p);
-														++f;
+															// x_l,t+1,d
+															matind[f] = layout.index(variable_family::x_ltc, m, t + 1, d);
+															matval[f] = get_roomroompath(c, d, p);
+															++f;
 
-														// U_tsp
-														matind[f] = nb_sessions * nb_timeslots*nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-														matval[f] = -1;
-														++f;
+															// U_tsp
+															matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
+															matval[f] = -1;
+															++f;
 
 
-														status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+															backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 														}
 													}
 												}
@@ -820,7 +1002,7 @@ namespace alg
 										f = 0;
 
 										// x_ltc
-										matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+										matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -834,7 +1016,7 @@ namespace alg
 													if (get_sessionlocationpossible(m, d))
 													{
 														// x_m,t+1,d
-														matind[f] = m * nb_timeslots*nb_locations + (t + 1) * nb_locations + d;
+														matind[f] = layout.index(variable_family::x_ltc, m, t + 1, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -843,16 +1025,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_timeslots*nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -889,7 +1066,7 @@ namespace alg
 										f = 0;
 
 										// x_l,t+1,c
-										matind[f] = l * nb_timeslots*nb_locations + (t + 1) * nb_locations + c;
+										matind[f] = layout.index(variable_family::x_ltc, l, t + 1, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -902,7 +1079,7 @@ namespace alg
 												{
 													if (get_sessionlocationpossible(m, d))
 													{
-														matind[f] = m * nb_timeslots*nb_locations + t * nb_locations + d;
+														matind[f] = layout.index(variable_family::x_ltc, m, t, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -911,16 +1088,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_timeslots*nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -948,17 +1120,12 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_timeslots*nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij);
 						++f;
 					}
 				}
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -981,7 +1148,7 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_timeslots*nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
 						if (arc_stairs[ij])
 							matval[f] *= speed_correction_stairs;
@@ -990,16 +1157,11 @@ namespace alg
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+				matind[f] = layout.index(variable_family::T_travel_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1038,34 +1200,29 @@ namespace alg
 														f = 0;
 
 														// x_ltc
-														matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+														matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 														matval[f] = Big_M;
 														++f;
 
 														// x_m,t+1,d
-														matind[f] = m * nb_timeslots*nb_locations + (t + 1) * nb_locations + d;
+														matind[f] = layout.index(variable_family::x_ltc, m, t + 1, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = layout.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = -get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = 1;
 														++f;
 
-														status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 													}
 												}
 											}
@@ -1114,34 +1271,29 @@ namespace alg
 														f = 0;
 
 														// x_ltc
-														matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+														matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 														matval[f] = Big_M;
 														++f;
 
 														// x_m,t+1,d
-														matind[f] = m * nb_timeslots*nb_locations + (t + 1) * nb_locations + d;
+														matind[f] = layout.index(variable_family::x_ltc, m, t + 1, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = layout.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = -1;
 														++f;
 
-														status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 													}
 												}
@@ -1173,29 +1325,22 @@ namespace alg
 					f = 0;
 
 					// T(travel)_tsp
-					matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+					matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 					matval[f] = 1;
 					++f;
 
 					// T(travel)_t,max
-					matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + t;
+					matind[f] = layout.index(variable_family::T_travel_max_t, t);
 					matval[f] = -1;
 					++f;
 
-					status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
+					backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 				}
 			}
 		}
 
 
 		// EVACUATIONS
-		const int nb_variables_first_part = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + nb_timeslots;
-
 		// Constraint set 13: U_tlp constraints 
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
@@ -1219,22 +1364,17 @@ namespace alg
 								f = 0;
 
 								// x_ltc
-								matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 								matval[f] = get_roomroompath(c, nb_locations, p);
 								++f;
 
 								// U_tlp
-								matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
+								matind[f] = layout.index(variable_family::U_evac_tlp, t, l, p);
 								matval[f] = -1;
 								++f;
 
 
-								status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-								}
+								backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 							}
 						}
 					}
@@ -1260,18 +1400,13 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
+						matind[f] = layout.index(variable_family::U_evac_tlp, t, l, p);
 						matval[f] = -session_nb_people[l] * get_patharc(p, ij);
 						++f;
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1294,7 +1429,7 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
+						matind[f] = layout.index(variable_family::U_evac_tlp, t, l, p);
 						matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
 						if (arc_stairs[ij])
 							matval[f] *= speed_correction_stairs;
@@ -1303,16 +1438,11 @@ namespace alg
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+				matind[f] = layout.index(variable_family::T_evac_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1339,29 +1469,24 @@ namespace alg
 								f = 0;
 
 								// x_ltc
-								matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 								matval[f] = Big_M;
 								++f;
 
 								// sum of T_arc_t,ij
 								for (int ij = 0; ij < nb_arcs; ++ij)
 								{
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+									matind[f] = layout.index(variable_family::T_evac_arc_tij, t, ij);
 									matval[f] = -get_patharc(p, ij);
 									++f;
 								}
 
 								// T_tot_tsp
-								matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+								matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
 								matval[f] = 1;
 								++f;
 
-								status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-								}
+								backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 							}
 						}
 					}
@@ -1392,29 +1517,24 @@ namespace alg
 								f = 0;
 
 								// x_ltc
-								matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 								matval[f] = Big_M;
 								++f;
 
 								// sum of T_arc_t,ij
 								for (int ij = 0; ij < nb_arcs; ++ij)
 								{
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+									matind[f] = layout.index(variable_family::T_evac_arc_tij, t, ij);
 									matval[f] = get_patharc(p, ij);
 									++f;
 								}
 
 								// T_tot_tsp
-								matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+								matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
 								matval[f] = -1;
 								++f;
 
-								status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-								}
+								backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 							}
 						}
 					}
@@ -1439,21 +1559,16 @@ namespace alg
 					f = 0;
 
 					// T(evac)_tlp
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+					matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
 					matval[f] = 1;
 					++f;
 
 					// T(evac)_t,max
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t;
+					matind[f] = layout.index(variable_family::T_evac_max_t, t);
 					matval[f] = -1;
 					++f;
 
-					status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
+					backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 				}
 			}
 		}
@@ -1479,21 +1594,16 @@ namespace alg
 						f = 0;
 
 						// T(total)_tsp variable
-						matind[f] = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 						matval[f] = -1;
 						++f;
 
 						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, problem) - 2;
+						matind[f] = layout.index(variable_family::T_travel_max_overall);
 						matval[f] = 1;
 						++f;
 
-						status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -1518,21 +1628,16 @@ namespace alg
 						f = 0;
 
 						// T(total)_tsp variable
-						matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+						matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
 						matval[f] = -1;
 						++f;
 
 						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, problem) - 1;
+						matind[f] = layout.index(variable_family::T_evac_max_overall);
 						matval[f] = 1;
 						++f;
 
-						status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -1540,18 +1645,36 @@ namespace alg
 
 
 		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_monolithic.lp", NULL);
-		if (status != 0)
+		if (write_model_file)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
+			backend->write("MIP_model_monolithic.lp");
 		}
 
+#ifdef ALG_USE_CPLEX
+		// Store the model in the cache
+		if (!cache_key.empty())
+			cplex_problem->write_cached_model(layout, _model_cache_directory, cache_key);
+#endif // ALG_USE_CPLEX
+
+		finish_build_problem();
+	}
+
+
+	void MIP_monolithic::finish_build_problem()
+	{
+		// Travel constraints in a lazy constraint callback
+		if (lazy_travel_constraints_enabled())
+			enable_lazy_travel_constraints();
+
 		// Get info
-		numcols_problem = CPXgetnumcols(env, problem);
-		numrows_problem = CPXgetnumrows(env, problem);
+		numcols_problem = backend->get_nb_columns();
+		numrows_problem = backend->get_nb_rows();
 
-		// Initialize vectors
+		// Initialize vectors (the solution of a previous run is kept until here)
+		solution_lecture_timeslot.clear();
+		solution_lecture_room.clear();
+		solution_evacuation_times.clear();
+		solution_travel_times.clear();
 		solution_lecture_timeslot.reserve(nb_sessions*nb_timeslots);
 		solution_lecture_room.reserve(nb_sessions*nb_locations);
 		for (int l = 0; l < nb_sessions; ++l)
@@ -1579,76 +1702,29 @@ namespace alg
 
 	void MIP_monolithic::solve_problem()
 	{
-		int status = 0;
-		int solstat;
-		std::unique_ptr<double[]> solution_CPLEX = std::make_unique<double[]>(numcols_problem);
+		std::vector<double> solution_values;
 
 
 		// Optimize the problem
-		std::cout << "\n\nCPLEX is solving the monolithic MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		status = CPXmipopt(env, problem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::solve_problem(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
+		std::cout << "\n\nThe solver is solving the monolithic MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
+		progress_traces.push_back(mip_solve_trace());
+		progress_traces.back().name = "monolithic lambda=" + std::to_string(_lambda) + " alpha=" + std::to_string(_alpha);
+		backend->set_progress_trace(&progress_traces.back());
+		const mip_status status = backend->solve();
+		backend->set_progress_trace(nullptr);
+
+		// Check the solution status
+		solution_exists = mip_status_has_solution(status);
+		solution_info = mip_status_description(status);
 
 		// Get the solution
-		status = CPXsolution(env, problem, &solstat, &objective_value, solution_CPLEX.get(), NULL, NULL, NULL);
-		if (status != 0)
+		if (solution_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::solve_problem(). \nCPXsolution failed. \nReason: " + std::string(error_text));
+			objective_value = backend->get_objective_value();
+			backend->get_solution(solution_values);
 		}
 
-
-		// Check the solution status
-		if (solstat == CPXMIP_OPTIMAL) {
-			solution_exists = true;
-			solution_info = "Optimal solution found";
-		}
-		else if (solstat == CPXMIP_OPTIMAL_TOL) {
-			solution_exists = true;
-			solution_info = "Solution found within tolerance limit";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_FEAS) {
-			solution_exists = true;
-			solution_info = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_FEAS) {
-			solution_exists = true;
-			solution_info = "Tree memory limit exceeded";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_exists = false;
-			solution_info = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_exists = false;
-			solution_info = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_UNBOUNDED) {
-			solution_exists = false;
-			solution_info = "Problem is unbounded";
-		}
-		else if (solstat == CPXMIP_INForUNBD) {
-			solution_exists = false;
-			solution_info = "Problem is infeasible or unbounded";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_INFEAS) {
-			solution_exists = false;
-			solution_info = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_INFEAS) {
-			solution_exists = false;
-			solution_info = "Tree memory limit exceeded";
-		}
-		else {
-			solution_exists = false;
-			solution_info = "Other reason for failure";
-		}
-
-		std::cout << "\nCPLEX has finished: " << solution_info << "\n";
+		std::cout << "\nThe solver has finished: " << solution_info << "\n";
 
 
 		if (solution_exists)
@@ -1665,7 +1741,7 @@ namespace alg
 				{
 					for (int r = 0; r < nb_locations; ++r)
 					{
-						if (solution_CPLEX[l*nb_timeslots*nb_locations + t * nb_locations + r] > 0.99)
+						if (solution_values[layout.index(variable_family::x_ltc, l, t, r)] > 0.99)
 						{
 							solution_lecture_timeslot.at(l) = t;
 							solution_lecture_room.at(l) = r;
@@ -1677,21 +1753,18 @@ namespace alg
 
 			// 2. travel times
 			{
-				const int index_travels = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths;
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					double time = solution_CPLEX[index_travels + t];
+					double time = solution_values[layout.index(variable_family::T_travel_max_t, t)];
 					solution_travel_times.at(t) = time;
 				}
 			}
 
 			// 3. evacuation times
 			{
-				const int index_evacs = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-					+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					double time = solution_CPLEX[index_evacs + t];
+					double time = solution_values[layout.index(variable_family::T_evac_max_t, t)];
 					solution_evacuation_times.at(t) = time;
 				}
 			}
@@ -1700,31 +1773,13 @@ namespace alg
 	}
 
 
-	void MIP_monolithic::clear_cplex()
+	void MIP_monolithic::clear_solver()
 	{
-		int status = 0;
-
-		// Clear vectors
-		solution_lecture_timeslot.clear();
-		solution_lecture_room.clear();
-		solution_evacuation_times.clear();
-		solution_travel_times.clear();
-
-		// Free the problem
-		status = CPXfreeprob(env, &problem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::clear_cplex(). \nCouldn't free the CPLEX problem. \nReason: " + std::string(error_text));
-		}
-
-		// Close the cplex environment
-		status = CPXcloseCPLEX(&env);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::clear_cplex(). \nCouldn't close CPLEX environment. \nReason: " + std::string(error_text));
-		}
+		// Free the problem (a CPLEX environment is returned to the pool)
+		if (lazy_travel_constraints_enabled())
+			disable_lazy_travel_constraints();
+		fixed_solution.clear();
+		backend.reset();
 	}
 
 
@@ -1747,29 +1802,22 @@ namespace alg
 			text += "sum over timeslots";
 		text += "\n\tTime limit (seconds): " + std::to_string(_time_limit);
 		text += "\n\tOptimality tolerance: " + std::to_string(_optimality_tolerance);
+		text += "\n\tSolver resources: " + describe_solver_resources(_resources);
 
 
 		// 3. results
 		text += "\nSolution status: " + solution_info;
 		text += "\nElapsed time (seconds): " + std::to_string(get_computation_time());
+		if (!_progress_trace_file.empty() && !progress_traces.empty())
+		{
+			write_progress_traces(progress_traces, _progress_trace_file);
+			text += "\nProgress of the solver written to: " + _progress_trace_file;
+		}
 
 
 		// 4. results
 		text += "\nObjective value: " + std::to_string(objective_value);
-		{
-			int pref = 0;
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				for (int t = 0; t < nb_timeslots; ++t)
-				{
-					if (solution_lecture_timeslot.at(l) == t)
-					{
-						pref += get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t);
-					}
-				}
-			}
-			text += "\n\tPreferences: " + std::to_string(pref);
-		}
+		text += "\n\tPreferences: " + std::to_string(compute_preferences(solution_lecture_timeslot));
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			if (_alpha > 0.01)
@@ -1798,80 +1846,195 @@ namespace alg
 
 
 
+#ifdef ALG_USE_CPLEX
+	int CPXPUBLIC MIP_monolithic::lazy_travel_callback(CPXCENVptr callback_env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p)
+	{
+		const MIP_monolithic* model = static_cast<const MIP_monolithic*>(cbhandle);
+		const variable_layout& layout = model->layout;
+		*useraction_p = CPX_CALLBACK_DEFAULT;
+
+		std::vector<double> x(layout.get_nb_columns());
+		int status = CPXgetcallbacknodex(callback_env, cbdata, wherefrom, x.data(), 0, layout.get_nb_columns() - 1);
+		if (status != 0)
+			return status;
+
+		// Timeslots and rooms in the integer solution
+		std::vector<int> lecture_timeslot(nb_sessions, -1);
+		std::vector<int> lecture_room(nb_sessions, -1);
+		std::vector<int> lecture_column(nb_sessions, -1);
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			for (int t = 0; t < nb_timeslots; ++t)
+			{
+				for (int c = 0; c < nb_locations; ++c)
+				{
+					if (layout.exists(variable_family::x_ltc, l, t, c) && x[layout.index(variable_family::x_ltc, l, t, c)] > 0.5)
+					{
+						lecture_timeslot[l] = t;
+						lecture_room[l] = c;
+						lecture_column[l] = layout.index(variable_family::x_ltc, l, t, c);
+					}
+				}
+			}
+		}
+
+		return separate_travel_constraints(callback_env, cbdata, wherefrom, layout, x, lecture_timeslot, lecture_room, lecture_column, useraction_p);
+	}
+
+
+#endif // ALG_USE_CPLEX
+
+
+	void MIP_monolithic::enable_lazy_travel_constraints()
+	{
+#ifdef ALG_USE_CPLEX
+		// The callback adds rows in terms of the original columns
+		dynamic_cast<cplex_backend&>(*backend).set_lazy_constraint_callback(&MIP_monolithic::lazy_travel_callback, this);
+#endif // ALG_USE_CPLEX
+	}
+
+
+	void MIP_monolithic::disable_lazy_travel_constraints()
+	{
+#ifdef ALG_USE_CPLEX
+		dynamic_cast<cplex_backend&>(*backend).set_lazy_constraint_callback(NULL, NULL);
+#endif // ALG_USE_CPLEX
+	}
+
+
+	void MIP_monolithic::write_output_pareto_front()
+	{
+		std::string text;
+
+		// 1. instance name
+		text = "Algorithm: "; text.append(algorithm_name); text += " (epsilon-constraint method)";
+		text += "\nProblem: " + instance_name_timetable + " + " + instance_name_building;
+
+		// 2. settings
+		text += "\nSettings:";
+		text += "\n\tAlpha: " + std::to_string(_alpha);
+		text += "\n\tObjective type: ";
+		if (_objective_type == objective_type::maximum_over_timeslots)
+			text += "maximum over timeslots";
+		else
+			text += "sum over timeslots";
+		text += "\n\tTime limit per point (seconds): " + std::to_string(_time_limit);
+		text += "\n\tOptimality tolerance: " + std::to_string(_optimality_tolerance);
+		text += "\n\tSolver resources: " + describe_solver_resources(_resources);
+		text += "\nElapsed time (seconds): " + std::to_string(get_computation_time());
+		if (!_progress_trace_file.empty() && !progress_traces.empty())
+		{
+			write_progress_traces(progress_traces, _progress_trace_file);
+			text += "\nProgress of the solver written to: " + _progress_trace_file;
+		}
+
+
+		// 3. front
+		text += "\nNon-dominated points: " + std::to_string(pareto_points.size());
+		for (auto&& point : pareto_points)
+		{
+			text += "\n\tEpsilon: " + std::to_string(point.epsilon);
+			text += "\tPreferences: " + std::to_string(point.preferences);
+			text += "\tTravel / evacuation times: " + std::to_string(point.objective_value);
+			text += "\tStatus: " + point.solution_info;
+			text += "\tTime (seconds): " + std::to_string(point.computation_time);
+		}
+
+
+		// Write single item to logger
+		_logger << logger::log_type::INFORMATION << text;
+	}
+
+
+
 	void MIP_monolithic::evaluate_solution(const std::vector<int> lecture_timeslot, const std::vector<int> lecture_room)
 	{
-		initialize_cplex();
+		initialize_solver();
 		build_problem();
 		fix_solution(lecture_timeslot, lecture_room);
 		solve_problem();
-		clear_cplex();
+		clear_solver();
 
 		write_output();
 	}
 
 
-	void MIP_monolithic::fix_solution(const std::vector<int> lecture_timeslot, const std::vector<int> lecture_room)
+	void MIP_monolithic::set_mip_start(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room)
 	{
-		int status = 0;
-		double obj[1];						// Objective function
-		double lb[1];						// Lower bound variables
-		double ub[1];						// Upper bound variables
-		double rhs[1];						// Right-hand side constraints
-		char *colname[1];					// Variable names
-		char *rowname[1];					// Constraint names
-		char sense[1];						// Sign of constraint
-		int matbeg[1];						// Begin position of the constraint
-		std::unique_ptr<int[]> matind;		// Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval;	// Value of each element in constraint matrix
-		char type[1];						// Type of variable (integer, binary, fractional)
-		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
+		if (lecture_timeslot.size() != static_cast<size_t>(nb_sessions) || lecture_room.size() != static_cast<size_t>(nb_sessions))
+			throw std::runtime_error("Error in function MIP_monolithic::set_mip_start(). \nReason: The MIP start should assign a timeslot and room to every lecture.");
 
-											// Create arrays
-		matind = std::make_unique<int[]>(1000000);
-		matval = std::make_unique<double[]>(1000000);
+		mip_start_lecture_timeslot = lecture_timeslot;
+		mip_start_lecture_room = lecture_room;
+	}
 
-		// Fix x_ltc variables
+
+	void MIP_monolithic::add_mip_start_solution(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room)
+	{
+		if (lecture_timeslot.empty())
+			return;
+
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_timeslots * nb_locations);
+		values.reserve(nb_sessions * nb_timeslots * nb_locations);
+
+		// x_ltc variables, the other variables are completed by CPLEX
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int t = 0; t < nb_timeslots; ++t)
 			{
 				for (int c = 0; c < nb_locations; ++c)
 				{
-					sense[0] = 'E';
-
-					if (lecture_timeslot.at(l) == t && lecture_room.at(l) == c)
-						rhs[0] = 1;
-					else
-						rhs[0] = 0;
+					if (layout.exists(variable_family::x_ltc, l, t, c))
+					{
+						columns.push_back(layout.index(variable_family::x_ltc, l, t, c));
+						if (lecture_timeslot.at(l) == t && lecture_room.at(l) == c)
+							values.push_back(1);
+						else
+							values.push_back(0);
+					}
+				}
+			}
+		}
 
-					std::string name = "Fix_x_" + std::to_string(l + 1) + "_" + std::to_string(t + 1) + "_" + std::to_string(c + 1);
-					rowname[0] = const_cast<char*>(name.c_str());
+		backend->add_mip_start(columns, values, "start_solution");
+	}
 
-					matbeg[0] = 0;
-					f = 0;
 
-					matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
-					matval[f] = 1;
-					++f;
+	void MIP_monolithic::fix_solution(const std::vector<int> lecture_timeslot, const std::vector<int> lecture_room)
+	{
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_timeslots * nb_locations);
+		values.reserve(nb_sessions * nb_timeslots * nb_locations);
 
-					status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
+		// Fix x_ltc variables
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			for (int t = 0; t < nb_timeslots; ++t)
+			{
+				for (int c = 0; c < nb_locations; ++c)
+				{
+					if (layout.exists(variable_family::x_ltc, l, t, c))
 					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_monolithic::fix_solution(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+						columns.push_back(layout.index(variable_family::x_ltc, l, t, c));
+						if (lecture_timeslot.at(l) == t && lecture_room.at(l) == c)
+							values.push_back(1);
+						else
+							values.push_back(0);
 					}
 				}
 			}
 		}
 
+		fixed_solution.fix(*backend, columns, values);
+	}
 
-		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_monolithic.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
-		}
+
+	void MIP_monolithic::unfix_solution()
+	{
+		fixed_solution.restore(*backend);
 	}
 
 
@@ -1880,89 +2043,65 @@ namespace alg
 		_lambda = 0.5;
 		_alpha = 0.5;
 
-		if (_objective_type == objective_type::maximum_over_timeslots)
-		{
-			int nonzeros = nb_sessions * nb_timeslots * nb_locations + 2;
-			std::unique_ptr<int[]> indices = std::make_unique<int[]>(nonzeros);
-			std::unique_ptr<double[]> values = std::make_unique<double[]>(nonzeros);
+		update_objective_coefficients();
+	}
 
-			// x_ltc
-			int index = -1;
-			for (int l = 0; l < nb_sessions; ++l)
+
+	void MIP_monolithic::update_objective_coefficients()
+	{
+		std::vector<int> indices;
+		std::vector<double> values;
+		get_objective_coefficients(indices, values);
+
+		backend->change_objective((int)indices.size(), indices.data(), values.data());
+	}
+
+
+	void MIP_monolithic::get_objective_coefficients(std::vector<int>& indices, std::vector<double>& values) const
+	{
+		indices.clear();
+		values.clear();
+
+		// x_ltc
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				for (int t = 0; t < nb_timeslots; ++t)
+				for (int c = 0; c < nb_locations; ++c)
 				{
-					for (int c = 0; c < nb_locations; ++c)
+					if (layout.exists(variable_family::x_ltc, l, t, c))
 					{
-						++index;
-						indices[index] = index;
-						values[index] = _lambda * (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t)); // lambda == 1
+						indices.push_back(layout.index(variable_family::x_ltc, l, t, c));
+						values.push_back((_lambda + _preference_augmentation) * (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t)));
 					}
 				}
 			}
+		}
 
+		if (_objective_type == objective_type::maximum_over_timeslots)
+		{
 			// travels
-			indices[index] = CPXgetnumcols(env, problem) - 2;
-			values[index] = (1 - _lambda) * (1 - _alpha);
-			++index;
+			indices.push_back(layout.index(variable_family::T_travel_max_overall));
+			values.push_back((1 - _lambda) * (1 - _alpha));
 
 			// evac
-			indices[index] = CPXgetnumcols(env, problem) - 2;
-			values[index] = (1 - _lambda) * _alpha;
-			++index;
-
-			int status = CPXchgobj(env, problem, nonzeros, indices.get(), values.get());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::update_objective_coefficients_analysis(). \nCouldn't change objective function coefficients.\nReason: " + std::string(error_text));
-			}
+			indices.push_back(layout.index(variable_family::T_evac_max_overall));
+			values.push_back((1 - _lambda) * _alpha);
 		}
 		else // if (_objective_type == objective_type::sum_over_timeslots)
 		{
-			int nonzeros = nb_sessions * nb_timeslots * nb_locations + 2 * nb_timeslots;
-			std::unique_ptr<int[]> indices = std::make_unique<int[]>(nonzeros);
-			std::unique_ptr<double[]> values = std::make_unique<double[]>(nonzeros);
-
-			// x_ltc
-			int index = -1;
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				for (int t = 0; t < nb_timeslots; ++t)
-				{
-					for (int c = 0; c < nb_locations; ++c)
-					{
-						++index;
-						indices[index] = index;
-						values[index] = _lambda * (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t)); // lambda == 1
-					}
-				}
-			}
-
 			// travels
-			const int index_travels = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths;
 			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				indices[index] = index_travels + t;
-				values[index] = (1 - _lambda) * (1 - _alpha);
-				++index;
+				indices.push_back(layout.index(variable_family::T_travel_max_t, t));
+				values.push_back((1 - _lambda) * (1 - _alpha));
 			}
 
 			// evac
-			const int index_evacs = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-				+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
 			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				indices[index] = index_evacs + t;
-				values[index] = (1 - _lambda) * _alpha;
-				++index;
-			}
-
-			int status = CPXchgobj(env, problem, nonzeros, indices.get(), values.get());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_monolithic::update_objective_coefficients_analysis(). \nCouldn't change objective function coefficients.\nReason: " + std::string(error_text));
+				indices.push_back(layout.index(variable_family::T_evac_max_t, t));
+				values.push_back((1 - _lambda) * _alpha);
 			}
 		}
 	}
@@ -1972,7 +2111,6 @@ namespace alg
 
 	void MIP_monolithic::add_constraint_preferences(double value)
 	{
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -1987,8 +2125,8 @@ namespace alg
 		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
 
 											// Create arrays
-		matind = std::make_unique<int[]>(100000);
-		matval = std::make_unique<double[]>(100000);
+		matind = std::make_unique<int[]>(nb_sessions * nb_timeslots * nb_locations);
+		matval = std::make_unique<double[]>(nb_sessions * nb_timeslots * nb_locations);
 
 
 		sense[0] = 'L';
@@ -2008,7 +2146,7 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c))
 					{
-						matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+						matind[f] = layout.index(variable_family::x_ltc, l, t, c);
 						matval[f] = (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t));
 						++f;
 					}
@@ -2016,27 +2154,19 @@ namespace alg
 			}
 		}
 
-		status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::add_constraint_preferences(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-		}
+		backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 
 		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_monolithic.lp", NULL);
-		if (status != 0)
+		if (write_model_file)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::add_constraint_preferences(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
+			backend->write("MIP_model_monolithic.lp");
 		}
 	}
 
 
 	void MIP_monolithic::add_constraint_TT(double value)
 	{
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -2051,8 +2181,8 @@ namespace alg
 		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
 
 											// Create arrays
-		matind = std::make_unique<int[]>(100000);
-		matval = std::make_unique<double[]>(100000);
+		matind = std::make_unique<int[]>(2 * nb_timeslots);
+		matval = std::make_unique<double[]>(2 * nb_timeslots);
 
 
 		sense[0] = 'L';
@@ -2069,14 +2199,14 @@ namespace alg
 			// 2. travel times
 			{
 				// Theta (Tmax) variable
-				matind[f] = CPXgetnumcols(env, problem) - 2;
+				matind[f] = layout.index(variable_family::T_travel_max_overall);
 				matval[f] = 1;
 				++f;
 			}
 
 			// 3. evacuation times
 			{
-				matind[f] = CPXgetnumcols(env, problem) - 1;
+				matind[f] = layout.index(variable_family::T_evac_max_overall);
 				matval[f] = 1;
 				++f;
 			}
@@ -2086,32 +2216,41 @@ namespace alg
 			for (int t = 0; t < nb_timeslots; ++t)
 			{
 				// T(travel)_t,max
-				matind[f] = nb_sessions * nb_timeslots*nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + t;
+				matind[f] = layout.index(variable_family::T_travel_max_t, t);
 				matval[f] = 1;
 				++f;
 
 				// T(evac)_t,max
-				const int nb_variables_first_part = nb_sessions * nb_timeslots * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + nb_timeslots;
-				matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t;
+				matind[f] = layout.index(variable_family::T_evac_max_t, t);
 				matval[f] = 1;
 				++f;
 			}
 		}
 
-		status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::add_constraint_TT(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-		}
+		backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 
 		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_monolithic.lp", NULL);
-		if (status != 0)
+		if (write_model_file)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::add_constraint_TT(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
+			backend->write("MIP_model_monolithic.lp");
 		}
 	}
+
+
+	void MIP_monolithic::add_constraint_objective(double value)
+	{
+		std::vector<int> indices;
+		std::vector<double> values;
+		get_objective_coefficients(indices, values);
+
+		double rhs[1] = { value };
+		char sense[1] = { 'L' };
+		int matbeg[1] = { 0 };
+
+		std::string name = "Constraint_on_objective_lambda_" + std::to_string(_lambda);
+		char *rowname[1] = { const_cast<char*>(name.c_str()) };
+
+		backend->add_rows(1, (int)indices.size(), rhs, sense, matbeg, indices.data(), values.data(), rowname);
+	}
 }
\ No newline at end of file
@@ -7,9 +7,15 @@
 #ifndef MIP_MONOLITHIC_H
 #define MIP_MONOLITHIC_H
 
-#include "ilcplex\cplex.h"
+#include "MIP_backend.h"
+#include "MIP_utilities.h"
+#include <memory>
 #include <vector>
+#include <string>
 #include <chrono>
+#include <utility>
+#include <atomic>
+#include <mutex>
 
 /*!
 *	@namespace	alg
@@ -28,19 +34,19 @@ namespace alg
 		static constexpr const char * algorithm_name = "Monolithic MIP";
 
 		/*!
-		*	@brief	Pointer to the CPLEX environment.
+		*	@brief	The problem in the chosen solver.
 		*/
-		CPXENVptr env{ nullptr };
+		std::unique_ptr<mip_backend> backend;
 
 		/*!
-		*	@brief	Pointer to the CPLEX problem.
+		*	@brief	Column indices of the variable families in the problem.
 		*/
-		CPXLPptr problem{ nullptr };
+		variable_layout layout;
 
 		/*!
-		*	@brief	Store for CPLEX error messages.
+		*	@brief	The variables fixed by fix_solution(), with their original bounds.
 		*/
-		char error_text[CPXMESSAGEBUFSIZE];
+		column_fixing fixed_solution;
 
 		/*!
 		*	@brief	Number of columns (variables) in the problem formulation.
@@ -58,15 +64,20 @@ namespace alg
 		bool solution_exists = false;
 
 		/*!
-		*	@brief	Information on the CPLEX solution status.
+		*	@brief	Information on the solution status.
 		*/
 		std::string solution_info;
 
 		/*!
-		*	@brief	Objective value of the CPLEX solution.
+		*	@brief	Objective value of the solution.
 		*/
 		double objective_value;
 
+		/*!
+		*	@brief	The progress of every solve of the current run.
+		*/
+		std::vector<mip_solve_trace> progress_traces;
+
 		/*!
 		*	@brief	Solution of the problem w.r.t. timeslot assignments.
 		*/
@@ -92,11 +103,38 @@ namespace alg
 		*/
 		std::vector<double> solution_evacuation_times;
 
+		/*!
+		*	@brief	MIP start w.r.t. timeslot assignments (empty if no start is given).
+		*/
+		std::vector<int> mip_start_lecture_timeslot;
+
+		/*!
+		*	@brief	MIP start w.r.t. room assignments (empty if no start is given).
+		*/
+		std::vector<int> mip_start_lecture_room;
+
 		/*!
 		*	@brief	The computation time for the algorithm.
 		*/
 		std::chrono::duration<double, std::ratio<1, 1>> computation_time;
 
+		/*!
+		*	@brief	The solutions found by run_pareto_sweep().
+		*/
+		std::vector<pareto_point> pareto_points;
+
+		/*!
+		*	@brief	Indicates whether the model is written to an .lp file when it is built.
+		*	Switched off for the model copies of the epsilon-constraint workers, which are built concurrently.
+		*/
+		bool write_model_file = true;
+
+		/*!
+		*	@brief	Weight of the preferences in the objective function on top of lambda.
+		*	Set by the epsilon-constraint workers (AUGMECON), so that ties in the travel / evacuation times are broken by the preferences.
+		*/
+		double _preference_augmentation = 0;
+
 	public:
 		/*!
 		*	@brief	Run the algorithm.
@@ -107,6 +145,26 @@ namespace alg
 		*/
 		void run_algorithm(bool constraint_on_preferences, bool constraint_on_T, double value_pref = 1e10, double value_T = 1e10);
 
+		/*!
+		*	@brief	Solve the model for a sequence of objective weights to trace the trade-off between the objectives.
+		*	The model is built once. For each pair of weights only the objective function is updated,
+		*	and the solution of the previous pair is given as MIP start. The first pair uses the MIP start, if one is given.
+		*	Each solution is written to the logger and can be retrieved with get_pareto_points().
+		*	@param	weights	The pairs (lambda, alpha) in the order in which they are solved.
+		*/
+		void run_pareto_sweep(const std::vector<std::pair<double, double>>& weights);
+
+		/*!
+		*	@brief	Generate the non-dominated front between the preferences and the travel / evacuation times with the epsilon-constraint method.
+		*	The extreme points of the front are found first, each lexicographically: the other objective is minimized with the first fixed at its optimum.
+		*	Then the travel / evacuation times are minimized for nb_points equidistant upper bounds (epsilon) on the preferences,
+		*	with a small weight on the preferences (AUGMECON), so that every point is efficient and not only weakly efficient.
+		*	These points are solved in parallel, each worker on its own copy of the model, with the solution of the nearest
+		*	solved point with a tighter bound as MIP start. The non-dominated points can be retrieved with get_pareto_points().
+		*	@param	nb_points	The number of values of epsilon, including both extreme points (at least 2).
+		*/
+		void run_epsilon_constraint(int nb_points);
+
 		/*!
 		*	@brief	Evaluate a solution.
 		*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
@@ -114,12 +172,36 @@ namespace alg
 		*/
 		void evaluate_solution(const std::vector<int> lecture_timeslot, const std::vector<int> lecture_room);
 
+		/*!
+		*	@brief	Give a solution (e.g. found by the heuristic) as MIP start for the next runs of the algorithm.
+		*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
+		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
+		*/
+		void set_mip_start(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room);
+
+		/*!
+		*	@brief	Remove the MIP start.
+		*/
+		void clear_mip_start() { mip_start_lecture_timeslot.clear(); mip_start_lecture_room.clear(); }
+
 		/*!
 		*	@brief	Get the computation time for the algorithm.
 		*	@returns The computation time for the algorithm.
 		*/
 		double get_computation_time() const { return computation_time.count(); }
 
+		/*!
+		*	@brief	Get the solutions found by the last call to run_pareto_sweep().
+		*	@returns	The solution for each pair of weights, in the order of the sweep.
+		*/
+		const std::vector<pareto_point>& get_pareto_points() const { return pareto_points; }
+
+		/*!
+		*	@brief	Get the progress (incumbent, bound and gap over time) of every solve of the last run.
+		*	@returns	The progress of every solve.
+		*/
+		const std::vector<mip_solve_trace>& get_progress_traces() const { return progress_traces; }
+
 		/*!
 		*	@brief	Check whether a solution exists.
 		*	@returns	True if a solution exists, false otherwise.
@@ -187,6 +269,40 @@ namespace alg
 		*/
 		double _time_limit = 3600;
 
+		/*!
+		*	@brief	The solver for the MIP model. CPLEX is only available if ALG_USE_CPLEX is defined and HiGHS if ALG_USE_HIGHS is defined.
+		*/
+		mip_solver _solver = default_mip_solver;
+
+		/*!
+		*	@brief	Leave the travel constraints (constraint set 8) out of the model and add the violated ones in a lazy constraint callback.
+		*	Only the rows that bind for the integer solutions found by CPLEX are generated. CPLEX only, ignored for the other solvers.
+		*/
+		bool _lazy_travel_constraints = false;
+
+		/*!
+		*	@brief	Directory in which the built model is cached, keyed by a hash of the instance data and the model parameters.
+		*	A cached model is read instead of built. Empty: no cache. The directory must exist. CPLEX only, ignored for the other solvers.
+		*/
+		std::string _model_cache_directory;
+
+		/*!
+		*	@brief	The number of threads used by run_epsilon_constraint(), divided over the workers that solve the epsilon points.
+		*	0 means the threads of _resources, or the number of hardware threads if those are not limited either.
+		*/
+		int _nb_threads_epsilon = 0;
+
+		/*!
+		*	@brief	The threads, memory, node files and determinism of the solver.
+		*	The epsilon-constraint workers share the threads and memory evenly.
+		*/
+		solver_resources _resources;
+
+		/*!
+		*	@brief	The file to which the progress of the solves is written with the output, empty for no file.
+		*/
+		std::string _progress_trace_file = "MIP_progress_monolithic.csv";
+
 		/*!
 		*	@brief	The type of objective function.
 		*/
@@ -198,35 +314,117 @@ namespace alg
 
 	private:
 		/*!
-		*	@brief	Initialize the CPLEX environment.
+		*	@brief	Create the problem in the chosen solver and set its parameters.
 		*/
-		void initialize_cplex();
+		void initialize_solver();
 
 		/*!
-		*	@brief	Build the CPLEX problem.
+		*	@brief	Build the problem.
 		*/
 		void build_problem();
 
 		/*!
-		*	@brief	Solve the CPLEX problem.
+		*	@brief	Steps of build_problem() that are also needed for a model read from the cache.
+		*/
+		void finish_build_problem();
+
+		/*!
+		*	@brief	Solve the problem.
 		*/
 		void solve_problem();
 
 		/*!
-		*	@brief	Clear CPLEX.
+		*	@brief	Free the problem.
 		*/
-		void clear_cplex();
+		void clear_solver();
 
 		/*!
 		*	@brief	Write output.
 		*/
 		void write_output();
 
+		/*!
+		*	@brief	Check whether the travel constraints are separated in a lazy constraint callback, which requires CPLEX.
+		*	@returns	True if the travel constraints are lazy, false if they are part of the model.
+		*/
+		bool lazy_travel_constraints_enabled() const { return _lazy_travel_constraints && _solver == mip_solver::cplex; }
+
+#ifdef ALG_USE_CPLEX
+		/*!
+		*	@brief	Lazy constraint callback of CPLEX, which separates the travel constraints (constraint set 8) for an integer solution.
+		*	@param	callback_env	The CPLEX environment of the callback.
+		*	@param	cbdata			The callback data.
+		*	@param	wherefrom		Where the callback was called from.
+		*	@param	cbhandle		The MIP_monolithic object.
+		*	@param	useraction_p	Set to CPX_CALLBACK_SET if rows are added.
+		*	@returns	0 if successful, the CPLEX error code otherwise.
+		*/
+		static int CPXPUBLIC lazy_travel_callback(CPXCENVptr callback_env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p);
+#endif // ALG_USE_CPLEX
+
+		/*!
+		*	@brief	Register the lazy constraint callback for the travel constraints in the CPLEX environment of the problem. Only used if lazy_travel_constraints_enabled().
+		*/
+		void enable_lazy_travel_constraints();
+
+		/*!
+		*	@brief	Remove the lazy constraint callback from the CPLEX environment, which is reused for other problems.
+		*/
+		void disable_lazy_travel_constraints();
+
+		/*!
+		*	@brief	Write the front found by run_epsilon_constraint() to the logger.
+		*/
+		void write_output_pareto_front();
+
+		/*!
+		*	@brief	Worker of run_epsilon_constraint(). Builds its own copy of the model and solves epsilon points until none are left.
+		*	@param	points			The epsilon points, from the tightest to the loosest bound. The results are written here.
+		*	@param	solved			Indicates for each point whether it has been solved.
+		*	@param	anchor			The solution that minimizes the preferences, a MIP start that is feasible for every point.
+		*	@param	preference_augmentation	The weight of the preferences in the objective of the points (AUGMECON).
+		*	@param	next_point		The index of the next point to be solved, shared by the workers.
+		*	@param	points_mutex	Protects points, solved and traces.
+		*	@param	traces			The progress of the solve of each point. The results are written here.
+		*	@param	resources		The resources of the worker's solver.
+		*/
+		void solve_epsilon_points(std::vector<pareto_point>& points, std::vector<bool>& solved, const pareto_point& anchor, double preference_augmentation, std::atomic<int>& next_point, std::mutex& points_mutex, std::vector<mip_solve_trace>& traces, const solver_resources& resources) const;
+
+		/*!
+		*	@brief	Find an extreme point of the front for run_epsilon_constraint(): minimize one objective, bound it at its optimum and minimize the other.
+		*	The bound is released again afterwards.
+		*	@param	lambda				The weight of the preferences in the first objective, 1 (preferences first) or 0 (travel / evacuation times first).
+		*	@param	row_first			The row of the constraint that bounds the first objective.
+		*	@param	start_timeslot		MIP start w.r.t. timeslot assignments for the first objective (empty for none).
+		*	@param	start_room			MIP start w.r.t. room assignments for the first objective (empty for none).
+		*	@returns	The solution of the second objective, with lambda = 1 - lambda.
+		*/
+		pareto_point solve_lexicographic_anchor(double lambda, int row_first, const std::vector<int>& start_timeslot, const std::vector<int>& start_room);
+
+		/*!
+		*	@brief	Compute the objective function coefficients for the current values of lambda, alpha and the preference augmentation.
+		*	@param	indices		The columns with an objective coefficient. The results are written here.
+		*	@param	values		The objective coefficients of these columns. The results are written here.
+		*/
+		void get_objective_coefficients(std::vector<int>& indices, std::vector<double>& values) const;
+
+		/*!
+		*	@brief	Update the objective function coefficients of the problem to the current values of lambda and alpha.
+		*/
+		void update_objective_coefficients();
+
 		/*!
 		*	@brief	Update the objective function coefficients for the analysis of a solution.
 		*/
 		void update_objective_coefficients_analysis();
 
+		/*!
+		*	@brief	Add a MIP start to the problem. Nothing is added if the given solution is empty.
+		*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
+		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
+		*/
+		void add_mip_start_solution(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room);
+
 		/*!
 		*	@brief	Fix the assignments for the solution that is to be evaluated.
 		*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
@@ -234,6 +432,11 @@ namespace alg
 		*/
 		void fix_solution(const std::vector<int> lecture_timeslot, const std::vector<int> lecture_room);
 
+		/*!
+		*	@brief	Undo fix_solution() by restoring the original bounds of the fixed variables.
+		*/
+		void unfix_solution();
+
 		/*!
 		*	@brief	Add a constraint for the maximum preference score.
 		*	@param	value	The right-hand-side value for the constraint.
@@ -245,6 +448,12 @@ namespace alg
 		*	@param	value	The right-hand-side value for the constraint.
 		*/
 		void add_constraint_TT(double value);
+
+		/*!
+		*	@brief	Add a constraint that bounds the objective function for the current values of lambda and alpha.
+		*	@param	value	The right-hand-side value for the constraint.
+		*/
+		void add_constraint_objective(double value);
 	};
 
 } // namespace alg
@@ -3,6 +3,7 @@
 #include "building_data.h"
 #include "initial_solution.h"
 #include "logger.h"
+#include "MIP_utilities.h"
 
 #include <stdexcept>
 #include <iostream>
@@ -16,62 +17,39 @@ namespace alg
 	{
 		auto start_time = std::chrono::system_clock::now();
 
-		initialize_cplex();
+		initialize_solver();
 		build_problem();
 		if (constraint_on_evacuation_time)
 			add_constraint_maximum_evacuation_time(value);
+		add_mip_start_solution();
 		solve_problem();
 
 		computation_time = std::chrono::system_clock::now() - start_time;
 
 		write_output();
 
-		clear_cplex();
+		clear_solver();
 	}
 
 
-	void MIP_only_second_stage::initialize_cplex()
+	void MIP_only_second_stage::initialize_solver()
 	{
-		int status = 0;
+		progress_traces.clear();
 
-		// Open the cplex environment
-		env = CPXopenCPLEX(&status);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::initialize_cplex(). \nCouldn't open CPLEX. \nReason: " + std::string(error_text));
-		}
-
-		// Set the output to screen on/off
-		status = CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_OFF);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::initialize_cplex(). \nCouldn't set the output to screen off. \nReason: " + std::string(error_text));
-		}
-
-		// Set tolerance gap
-		status = CPXsetdblparam(env, CPX_PARAM_EPGAP, _optimality_tolerance);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::initialize_cplex(). \nCouldn't set the tolerance gap. \nReason: " + std::string(error_text));
-		}
+		// Create an empty minimization problem in the chosen solver
+		backend = create_mip_backend(_solver, "problem_second_stage");
 
-		// Time limit for the MIP
-		status = CPXsetdblparam(env, CPX_PARAM_TILIM, _time_limit);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::initialize_cplex(). \nCouldn't set the time limit. \nReason: " + std::string(error_text));
-		}
+		// Set the output to screen off, the tolerance gap and the time limit for the MIP
+		backend->set_output(false);
+		backend->set_optimality_tolerance(_optimality_tolerance);
+		backend->set_time_limit(_time_limit);
+		backend->set_resources(_resources);
 	}
 
 
 	void MIP_only_second_stage::build_problem()
 	{
 		constexpr int Big_M = 10000;
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -87,27 +65,18 @@ namespace alg
 
 
 											// Create arrays
-		matind = std::make_unique<int[]>(10000000);
-		matval = std::make_unique<double[]>(10000000);
+		const int max_row_length = max_row_length_flows();
+		matind = std::make_unique<int[]>(max_row_length);
+		matval = std::make_unique<double[]>(max_row_length);
 
-		// Create the problem
-		problem = CPXcreateprob(env, &status, "problem_second_stage");
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't create the CPLEX problem. \nReason: " + std::string(error_text));
-		}
+		// VARIABLES
+		layout.clear();
 
-		// Problem is minimization
-		CPXchgobjsen(env, problem, CPX_MIN);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't set the problem type to minimization. \nReason: " + std::string(error_text));
-		}
+		// paths that lead from a possible room of each session to the outside
+		const std::vector<bool> session_evacuation_paths = compute_session_evacuation_paths();
 
-		// VARIABLES
 		// Add the W_lc variables
+		layout.add_family(variable_family::w_lc, nb_sessions, nb_locations);
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int c = 0; c < nb_locations; ++c)
@@ -121,16 +90,13 @@ namespace alg
 				ub[0] = 1;
 				type[0] = 'B';
 
-				status = CPXnewcols(env, problem, 1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout.add_column(variable_family::w_lc, l, c);
+				backend->add_columns(1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the U(travel)_tsp variables
+		layout.add_family(variable_family::U_travel_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -143,17 +109,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::U_travel_tsp, t, s, p);
+					backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel_arc)_tij variables
+		layout.add_family(variable_family::T_travel_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -164,16 +127,13 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout.add_column(variable_family::T_travel_arc_tij, t, ij);
+				backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(travel)_tsp variables
+		layout.add_family(variable_family::T_travel_total_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -186,17 +146,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout.add_column(variable_family::T_travel_total_tsp, t, s, p);
+					backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel)_t,max variables
+		layout.add_family(variable_family::T_travel_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_travel_max_" + std::to_string(t + 1);
@@ -208,38 +165,35 @@ namespace alg
 				obj[0] = (1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_travel_max_t, t);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the U(evac)_tlp variables
+		layout.add_family(variable_family::U_evac_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
+					if (initial_solution_lecture_timing[l] == t && session_evacuation_paths[l * nb_paths + p])
+					{
+						std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
+						colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = 0;
-					lb[0] = 0;
+						obj[0] = 0;
+						lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						layout.add_column(variable_family::U_evac_tlp, t, l, p);
+						backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 					}
 				}
 			}
 		}
 
 		// Add the T(evac_arc)_tij variables
+		layout.add_family(variable_family::T_evac_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -250,39 +204,36 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout.add_column(variable_family::T_evac_arc_tij, t, ij);
+				backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(evac)_tlp variables
+		layout.add_family(variable_family::T_evac_total_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
+					if (initial_solution_lecture_timing[l] == t && session_evacuation_paths[l * nb_paths + p])
+					{
+						std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
+						colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = 0;
-					lb[0] = 0;
+						obj[0] = 0;
+						lb[0] = 0;
 
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						layout.add_column(variable_family::T_evac_total_tlp, t, l, p);
+						backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 					}
 				}
 			}
 		}
 
 		// Add the T(evac)_t,max variables
+		layout.add_family(variable_family::T_evac_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_evac_max_" + std::to_string(t + 1);
@@ -294,15 +245,12 @@ namespace alg
 				obj[0] = _alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_evac_max_t, t);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(travel)_max_overall variable
+		layout.add_family(variable_family::T_travel_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_travel_max_overall";
@@ -311,15 +259,12 @@ namespace alg
 			obj[0] = (1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_travel_max_overall);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(evac)_max_overall variable
+		layout.add_family(variable_family::T_evac_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_evac_max_overall";
@@ -328,12 +273,8 @@ namespace alg
 			obj[0] = _alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout.add_column(variable_family::T_evac_max_overall);
+			backend->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 
@@ -355,18 +296,13 @@ namespace alg
 			{
 				if (get_sessionlocationpossible(l, c))
 				{
-					matind[f] = l * nb_locations + c;
+					matind[f] = layout.index(variable_family::w_lc, l, c);
 					matval[f] = 1;
 					++f;
 				}
 			}
 
-			status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-			}
+			backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 		}
 
 
@@ -388,18 +324,13 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c) && initial_solution_lecture_timing[l] == t)
 					{
-						matind[f] = l * nb_locations + c;
+						matind[f] = layout.index(variable_family::w_lc, l, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -440,27 +371,22 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = layout.index(variable_family::w_lc, l, c);
 														matval[f] = get_roomroompath(c, d, p);
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout.index(variable_family::w_lc, m, d);
 														matval[f] = get_roomroompath(c, d, p);
 														++f;
 
 														// U_tsp
-														matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 														matval[f] = -1;
 														++f;
 
 
-														status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 													}
 												}
 											}
@@ -501,7 +427,7 @@ namespace alg
 										f = 0;
 
 										// w_lc
-										matind[f] = l * nb_locations + c;
+										matind[f] = layout.index(variable_family::w_lc, l, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -515,7 +441,7 @@ namespace alg
 													if (get_sessionlocationpossible(m, d))
 													{
 														// x_m,t+1,d
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout.index(variable_family::w_lc, m, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -524,16 +450,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -570,7 +491,7 @@ namespace alg
 										f = 0;
 
 										// w_lc
-										matind[f] = l * nb_locations + c;
+										matind[f] = layout.index(variable_family::w_lc, l, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -583,7 +504,7 @@ namespace alg
 												{
 													if (get_sessionlocationpossible(m, d))
 													{
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout.index(variable_family::w_lc, m, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -592,16 +513,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -629,17 +545,12 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij);;
 						++f;
 					}
 				}
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -662,7 +573,7 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
 						if (arc_stairs[ij])
 							matval[f] *= speed_correction_stairs;
@@ -671,16 +582,11 @@ namespace alg
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+				matind[f] = layout.index(variable_family::T_travel_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -719,34 +625,29 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = layout.index(variable_family::w_lc, l, c);
 														matval[f] = Big_M;
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout.index(variable_family::w_lc, m, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = layout.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = -get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = 1;
 														++f;
 
-														status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 													}
 												}
 											}
@@ -795,34 +696,29 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = layout.index(variable_family::w_lc, l, c);
 														matval[f] = Big_M;
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout.index(variable_family::w_lc, m, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = layout.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = -1;
 														++f;
 
-														status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 													}
 												}
@@ -854,29 +750,22 @@ namespace alg
 					f = 0;
 
 					// T(travel)_tsp
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+					matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 					matval[f] = 1;
 					++f;
 
 					// T(travel)_t,max
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + t;
+					matind[f] = layout.index(variable_family::T_travel_max_t, t);
 					matval[f] = -1;
 					++f;
 
-					status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
+					backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 				}
 			}
 		}
 
 
 		// EVACUATIONS
-		const int nb_variables_first_part = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + nb_timeslots;
-
 		// Constraint set 13: U_tlp constraints 
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
@@ -902,22 +791,17 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = layout.index(variable_family::w_lc, l, c);
 									matval[f] = get_roomroompath(c, nb_locations, p);
 									++f;
 
 									// U_tlp
-									matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = layout.index(variable_family::U_evac_tlp, t, l, p);
 									matval[f] = -1;
 									++f;
 
 
-									status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -944,18 +828,16 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij);
-						++f;
+						if (layout.exists(variable_family::U_evac_tlp, t, l, p))
+						{
+							matind[f] = layout.index(variable_family::U_evac_tlp, t, l, p);
+							matval[f] = -session_nb_people[l] * get_patharc(p, ij);
+							++f;
+						}
 					}
 				}
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -978,25 +860,23 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
-						if (arc_stairs[ij])
-							matval[f] *= speed_correction_stairs;
-						++f;
+						if (layout.exists(variable_family::U_evac_tlp, t, l, p))
+						{
+							matind[f] = layout.index(variable_family::U_evac_tlp, t, l, p);
+							matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
+							if (arc_stairs[ij])
+								matval[f] *= speed_correction_stairs;
+							++f;
+						}
 					}
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+				matind[f] = layout.index(variable_family::T_evac_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1025,29 +905,24 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = layout.index(variable_family::w_lc, l, c);
 									matval[f] = Big_M;
 									++f;
 
 									// sum of T_arc_t,ij
 									for (int ij = 0; ij < nb_arcs; ++ij)
 									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+										matind[f] = layout.index(variable_family::T_evac_arc_tij, t, ij);
 										matval[f] = -get_patharc(p, ij);
 										++f;
 									}
 
 									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
 									matval[f] = 1;
 									++f;
 
-									status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -1081,29 +956,24 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = layout.index(variable_family::w_lc, l, c);
 									matval[f] = Big_M;
 									++f;
 
 									// sum of T_arc_t,ij
 									for (int ij = 0; ij < nb_arcs; ++ij)
 									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+										matind[f] = layout.index(variable_family::T_evac_arc_tij, t, ij);
 										matval[f] = get_patharc(p, ij);
 										++f;
 									}
 
 									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
 									matval[f] = -1;
 									++f;
 
-									status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -1119,30 +989,28 @@ namespace alg
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					sense[0] = 'L';
-					rhs[0] = 0;
+					if (layout.exists(variable_family::T_evac_total_tlp, t, l, p))
+					{
+						sense[0] = 'L';
+						rhs[0] = 0;
 
-					std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-					rowname[0] = const_cast<char*>(name.c_str());
+						std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
+						rowname[0] = const_cast<char*>(name.c_str());
 
-					matbeg[0] = 0;
-					f = 0;
+						matbeg[0] = 0;
+						f = 0;
 
-					// T(evac)_tlp
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-					matval[f] = 1;
-					++f;
+						// T(evac)_tlp
+						matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
+						matval[f] = 1;
+						++f;
 
-					// T(travel)_t,max
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t;
-					matval[f] = -1;
-					++f;
+						// T(travel)_t,max
+						matind[f] = layout.index(variable_family::T_evac_max_t, t);
+						matval[f] = -1;
+						++f;
 
-					status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+						backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -1169,21 +1037,16 @@ namespace alg
 						f = 0;
 
 						// T(total)_tsp variable
-						matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout.index(variable_family::T_travel_total_tsp, t, s, p);
 						matval[f] = -1;
 						++f;
 
 						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, problem) - 2;
+						matind[f] = layout.index(variable_family::T_travel_max_overall);
 						matval[f] = 1;
 						++f;
 
-						status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -1198,30 +1061,28 @@ namespace alg
 				{
 					for (int p = 0; p < nb_paths; ++p)
 					{
-						sense[0] = 'G';
-						rhs[0] = 0;
+						if (layout.exists(variable_family::T_evac_total_tlp, t, l, p))
+						{
+							sense[0] = 'G';
+							rhs[0] = 0;
 
-						std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-						rowname[0] = const_cast<char*>(name.c_str());
+							std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
+							rowname[0] = const_cast<char*>(name.c_str());
 
-						matbeg[0] = 0;
-						f = 0;
+							matbeg[0] = 0;
+							f = 0;
 
-						// T(total)_tsp variable
-						matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -1;
-						++f;
+							// T(total)_tsp variable
+							matind[f] = layout.index(variable_family::T_evac_total_tlp, t, l, p);
+							matval[f] = -1;
+							++f;
 
-						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, problem) - 1;
-						matval[f] = 1;
-						++f;
+							// Theta (Tmax) variable
+							matind[f] = layout.index(variable_family::T_evac_max_overall);
+							matval[f] = 1;
+							++f;
 
-						status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+							backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 						}
 					}
 				}
@@ -1230,16 +1091,11 @@ namespace alg
 
 
 		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_second_stage.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::build_problem(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
-		}
+		backend->write("MIP_model_second_stage.lp");
 
 		// Get info
-		numcols_problem = CPXgetnumcols(env, problem);
-		numrows_problem = CPXgetnumrows(env, problem);
+		numcols_problem = backend->get_nb_columns();
+		numrows_problem = backend->get_nb_rows();
 
 
 
@@ -1266,93 +1122,41 @@ namespace alg
 
 	void MIP_only_second_stage::solve_problem()
 	{
-		int status = 0;
-		int solstat;
-		std::unique_ptr<double[]> solution_CPLEX = std::make_unique<double[]>(numcols_problem);
+		std::vector<double> solution_values;
 
 
 		// Optimize the problem
-		std::cout << "\n\nCPLEX is solving the second stage MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		status = CPXmipopt(env, problem);
-		if (status != 0)
+		std::cout << "\n\nThe solver is solving the second stage MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
+		if (record_progress)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
+			progress_traces.push_back(mip_solve_trace());
+			progress_traces.back().name = "second_stage";
+			backend->set_progress_trace(&progress_traces.back());
 		}
+		const mip_status status = backend->solve();
+		backend->set_progress_trace(nullptr);
+
+		// Check the solution status
+		solution_exists = mip_status_has_solution(status);
+		solution_info = mip_status_description(status);
 
 		// Get the solution
-		status = CPXsolution(env, problem, &solstat, &objective_value, solution_CPLEX.get(), NULL, NULL, NULL);
-		if (status != 0)
+		if (solution_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXsolution failed. \nReason: " + std::string(error_text));
+			objective_value = backend->get_objective_value();
+			backend->get_solution(solution_values);
 		}
 
-
-		// Check the solution status
-		if (solstat == CPXMIP_OPTIMAL) {
-			solution_exists = true;
-			solution_info = "Optimal solution found";
-		}
-		else if (solstat == CPXMIP_OPTIMAL_TOL) {
-			solution_exists = true;
-			solution_info = "Solution found within tolerance limit";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_FEAS) {
-			solution_exists = true;
-			solution_info = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_FEAS) {
-			solution_exists = true;
-			solution_info = "Tree memory limit exceeded";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_exists = false;
-			solution_info = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_exists = false;
-			solution_info = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_UNBOUNDED) {
-			solution_exists = false;
-			solution_info = "Problem is unbounded";
-		}
-		else if (solstat == CPXMIP_INForUNBD) {
-			solution_exists = false;
-			solution_info = "Problem is infeasible or unbounded";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_INFEAS) {
-			solution_exists = false;
-			solution_info = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_INFEAS) {
-			solution_exists = false;
-			solution_info = "Tree memory limit exceeded";
-		}
-		else {
-			solution_exists = false;
-			solution_info = "Other reason for failure";
-		}
-
-		std::cout << "\nCPLEX has finished: " << solution_info << "\n";
+		std::cout << "\nThe solver has finished: " << solution_info << "\n";
 
 
 
 		/////
 		/*{
-		const int index_evacs = nb_sessions * nb_locations	// w_lc
-		+ nb_timeslots * nb_series * nb_paths			// U_travel_tsp
-		+ nb_timeslots * nb_arcs						// T_travel_arc_tij
-		+ nb_timeslots * nb_series * nb_paths			// T_travel_total_tsp
-		+ nb_timeslots;									// T_travel_max_t
-
-		//+nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
-
 		std::cout << "\n\nObjective value = " << objective_value << "\n";
 		for (int l = 0; l < nb_sessions; ++l) {
 		for (int c = 0; c < nb_locations; ++c) {
-		if (solution_CPLEX[l*nb_locations + c] > 0.99)
+		if (solution_values[layout.index(variable_family::w_lc, l, c)] > 0.99)
 		std::cout << "\nLecture " << l + 1 << " assigned to room " << c + 1;
 		}
 		}
@@ -1360,31 +1164,31 @@ namespace alg
 		for (int t = 0; t < nb_timeslots; ++t) {
 		for (int l = 0; l < nb_sessions; ++l) {
 		for (int p = 0; p < nb_paths; ++p) {
-		if (solution_CPLEX[index_evacs + t * nb_sessions*nb_paths + l * nb_paths + p] > 0.01)
-		std::cout << "\nU_evac_t_" << t + 1 << "_l_" << l + 1 << "_p_" << p + 1 << " = " << solution_CPLEX[index_evacs + t * nb_sessions*nb_paths + l * nb_paths + p];
+		if (layout.exists(variable_family::U_evac_tlp, t, l, p) && solution_values[layout.index(variable_family::U_evac_tlp, t, l, p)] > 0.01)
+		std::cout << "\nU_evac_t_" << t + 1 << "_l_" << l + 1 << "_p_" << p + 1 << " = " << solution_values[layout.index(variable_family::U_evac_tlp, t, l, p)];
 		}
 		}
 		}
 
 		for (int t = 0; t < nb_timeslots; ++t) {
 		for (int ij = 0; ij < nb_arcs; ++ij) {
-		if (solution_CPLEX[index_evacs + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij] > 0.01)
-		std::cout << "\nT_evac_arc_t" << t + 1 << "_ij_" << ij + 1 << " = " << solution_CPLEX[index_evacs + nb_timeslots*nb_sessions*nb_paths + t*nb_arcs + ij];
+		if (solution_values[layout.index(variable_family::T_evac_arc_tij, t, ij)] > 0.01)
+		std::cout << "\nT_evac_arc_t" << t + 1 << "_ij_" << ij + 1 << " = " << solution_values[layout.index(variable_family::T_evac_arc_tij, t, ij)];
 		}
 		}
 
 		for (int t = 0; t < nb_timeslots; ++t) {
 		for (int l = 0; l < nb_sessions; ++l) {
 		for (int p = 0; p < nb_paths; ++p) {
-		if (solution_CPLEX[index_evacs + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p] > 0.01)
-		std::cout << "\nT_evac_total_t_" << t + 1 << "_l_" << l + 1 << "_p_" << p + 1 << " = " << solution_CPLEX[index_evacs + nb_timeslots*nb_sessions*nb_paths + nb_timeslots*nb_arcs + t*nb_sessions*nb_paths + l*nb_paths + p];
+		if (layout.exists(variable_family::T_evac_total_tlp, t, l, p) && solution_values[layout.index(variable_family::T_evac_total_tlp, t, l, p)] > 0.01)
+		std::cout << "\nT_evac_total_t_" << t + 1 << "_l_" << l + 1 << "_p_" << p + 1 << " = " << solution_values[layout.index(variable_family::T_evac_total_tlp, t, l, p)];
 		}
 		}
 		}
 
 		for (int t = 0; t < nb_timeslots; ++t) {
-		if (solution_CPLEX[index_evacs + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t] > 0.01)
-		std::cout << "\nT_evac_total_max_t_" << t + 1 << " = " << solution_CPLEX[index_evacs + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t];
+		if (solution_values[layout.index(variable_family::T_evac_max_t, t)] > 0.01)
+		std::cout << "\nT_evac_total_max_t_" << t + 1 << " = " << solution_values[layout.index(variable_family::T_evac_max_t, t)];
 		}
 		}*/
 
@@ -1399,7 +1203,7 @@ namespace alg
 				solution_lecture_room.at(l) = -1;
 				for (int r = 0; r < nb_locations; ++r)
 				{
-					if (solution_CPLEX[l*nb_locations + r] > 0.99)
+					if (solution_values[layout.index(variable_family::w_lc, l, r)] > 0.99)
 					{
 						solution_lecture_room.at(l) = r;
 						break;
@@ -1409,21 +1213,18 @@ namespace alg
 
 			// 2. travel times
 			{
-				const int index_travels = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths;
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					double time = solution_CPLEX[index_travels + t];
+					double time = solution_values[layout.index(variable_family::T_travel_max_t, t)];
 					solution_travel_times.at(t) = time;
 				}
 			}
 
 			// 3. evacuation times
 			{
-				const int index_evacs = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-					+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					double time = solution_CPLEX[index_evacs + t];
+					double time = solution_values[layout.index(variable_family::T_evac_max_t, t)];
 					solution_evacuation_times.at(t) = time;
 				}
 			}
@@ -1431,30 +1232,16 @@ namespace alg
 	}
 
 
-	void MIP_only_second_stage::clear_cplex()
+	void MIP_only_second_stage::clear_solver()
 	{
-		int status = 0;
-
 		// Clear vectors
 		solution_lecture_room.clear();
 		solution_travel_times.clear();
 		solution_evacuation_times.clear();
 
-		// Free the problem
-		status = CPXfreeprob(env, &problem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::clear_cplex(). \nCouldn't free the master problem. \nReason: " + std::string(error_text));
-		}
-
-		// Close the cplex environment
-		status = CPXcloseCPLEX(&env);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::clear_cplex(). \nCouldn't close CPLEX environment. \nReason: " + std::string(error_text));
-		}
+		// Free the problem (a CPLEX environment is returned to the pool)
+		fixed_solution.clear();
+		backend.reset();
 	}
 
 
@@ -1472,8 +1259,9 @@ namespace alg
 		_logger << logger::log_type::INFORMATION;
 
 		// build cplex
-		initialize_cplex();
+		initialize_solver();
 		build_problem();
+		record_progress = false;
 
 		// reset counter
 		exhaustive_search_solutions_number = 0;
@@ -1501,7 +1289,8 @@ namespace alg
 		std::cout << "\n\nExhaustive search finished";
 
 		// clear cplex
-		clear_cplex();
+		record_progress = true;
+		clear_solver();
 	}
 
 
@@ -1513,7 +1302,7 @@ namespace alg
 		{
 			fix_solution(solution_lecture_room);
 			solve_problem();
-			CPXdelrows(env, problem, CPXgetnumrows(env, problem) - nb_sessions, CPXgetnumrows(env, problem) - 1);
+			unfix_solution();
 
 			++exhaustive_search_solutions_number;
 			std::string text;
@@ -1551,7 +1340,7 @@ namespace alg
 		{
 			fix_solution(solution_lecture_room);
 			solve_problem();
-			CPXdelrows(env, problem, CPXgetnumrows(env, problem) - nb_sessions, CPXgetnumrows(env, problem) - 1);
+			unfix_solution();
 
 			++exhaustive_search_solutions_number;
 			std::string text;
@@ -1593,80 +1382,85 @@ namespace alg
 
 	void MIP_only_second_stage::evaluate_solution(const std::vector<int> lecture_room)
 	{
-		initialize_cplex();
+		initialize_solver();
 		build_problem();
 		fix_solution(lecture_room);
 		solve_problem();
-		clear_cplex();
+		clear_solver();
 
 		write_output();
 	}
 
 
-	void MIP_only_second_stage::fix_solution(const std::vector<int> lecture_room)
+	void MIP_only_second_stage::set_mip_start(const std::vector<int>& lecture_room)
 	{
-		int status = 0;
-		double obj[1];						// Objective function
-		double lb[1];						// Lower bound variables
-		double ub[1];						// Upper bound variables
-		double rhs[1];						// Right-hand side constraints
-		char *colname[1];					// Variable names
-		char *rowname[1];					// Constraint names
-		char sense[1];						// Sign of constraint
-		int matbeg[1];						// Begin position of the constraint
-		std::unique_ptr<int[]> matind;		// Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval;	// Value of each element in constraint matrix
-		char type[1];						// Type of variable (integer, binary, fractional)
-		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
+		if (lecture_room.size() != static_cast<size_t>(nb_sessions))
+			throw std::runtime_error("Error in function MIP_only_second_stage::set_mip_start(). \nReason: The MIP start should assign a room to every lecture.");
 
-											// Create arrays
-		matind = std::make_unique<int[]>(100000);
-		matval = std::make_unique<double[]>(100000);
+		mip_start_lecture_room = lecture_room;
+	}
+
+
+	void MIP_only_second_stage::add_mip_start_solution()
+	{
+		if (mip_start_lecture_room.empty())
+			return;
+
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_locations);
+		values.reserve(nb_sessions * nb_locations);
 
-		// Fix x_ltc variables
+		// w_lc variables, the other variables are completed by CPLEX
 		for (int l = 0; l < nb_sessions; ++l)
 		{
-			for (int t = 0; t < nb_timeslots; ++t)
+			for (int c = 0; c < nb_locations; ++c)
 			{
-				if (initial_solution_lecture_timing.at(l) == t)
+				if (layout.exists(variable_family::w_lc, l, c))
 				{
-					for (int c = 0; c < nb_locations; ++c)
-					{
-						if (lecture_room.at(l) == c)
-						{
-							sense[0] = 'E';
-							rhs[0] = 1;
+					columns.push_back(layout.index(variable_family::w_lc, l, c));
+					if (mip_start_lecture_room.at(l) == c)
+						values.push_back(1);
+					else
+						values.push_back(0);
+				}
+			}
+		}
 
-							std::string name = "Fix_w_" + std::to_string(l + 1) + "_" + std::to_string(c + 1);
-							rowname[0] = const_cast<char*>(name.c_str());
+		backend->add_mip_start(columns, values, "start_solution");
+	}
 
-							matbeg[0] = 0;
-							f = 0;
 
-							matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
-							matval[f] = 1;
-							++f;
+	void MIP_only_second_stage::fix_solution(const std::vector<int> lecture_room)
+	{
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_locations);
+		values.reserve(nb_sessions * nb_locations);
 
-							status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function MIP_monolithic::fix_solution(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-							}
-						}
-					}
+		// Fix w_lc variables
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			for (int c = 0; c < nb_locations; ++c)
+			{
+				if (layout.exists(variable_family::w_lc, l, c))
+				{
+					columns.push_back(layout.index(variable_family::w_lc, l, c));
+					if (lecture_room.at(l) == c)
+						values.push_back(1);
+					else
+						values.push_back(0);
 				}
 			}
 		}
 
+		fixed_solution.fix(*backend, columns, values);
+	}
 
-		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_second_stage.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
-		}
+
+	void MIP_only_second_stage::unfix_solution()
+	{
+		fixed_solution.restore(*backend);
 	}
 
 
@@ -1691,11 +1485,17 @@ namespace alg
 			text += "sum over timeslots";
 		text += "\n\tTime limit (seconds): " + std::to_string(_time_limit);
 		text += "\n\tOptimality tolerance: " + std::to_string(_optimality_tolerance);
+		text += "\n\tSolver resources: " + describe_solver_resources(_resources);
 
 
 		// 3. results
 		text += "\nSolution status: " + solution_info;
 		text += "\nElapsed time (seconds): " + std::to_string(get_computation_time());
+		if (!_progress_trace_file.empty() && !progress_traces.empty())
+		{
+			write_progress_traces(progress_traces, _progress_trace_file);
+			text += "\nProgress of the solver written to: " + _progress_trace_file;
+		}
 
 
 		// 4. results
@@ -1743,7 +1543,6 @@ namespace alg
 
 	void MIP_only_second_stage::add_constraint_maximum_evacuation_time(double value)
 	{
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -1758,8 +1557,8 @@ namespace alg
 		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
 
 											// Create arrays
-		matind = std::make_unique<int[]>(100000);
-		matval = std::make_unique<double[]>(100000);
+		matind = std::make_unique<int[]>(nb_timeslots);
+		matval = std::make_unique<double[]>(nb_timeslots);
 
 
 		sense[0] = 'L';
@@ -1773,38 +1572,26 @@ namespace alg
 
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
-			matind[f] = CPXgetnumcols(env, problem) - 1;
+			matind[f] = layout.index(variable_family::T_evac_max_overall);
 			matval[f] = 1;
 			++f;
 		}
 		else // if (_objective_type == objective_type::sum_over_timeslots)
 		{
-			const int index_evacs = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-				+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
 
 			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				matind[f] = index_evacs + t;
+				matind[f] = layout.index(variable_family::T_evac_max_t, t);
 				matval[f] = 1;
 				++f;
 			}
 		}
 
-		status = CPXaddrows(env, problem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::add_constraint_maximum_evacuation_time(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-		}
+		backend->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 
 		// Write to file
-		status = CPXwriteprob(env, problem, "MIP_model_second_stage.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::add_constraint_maximum_evacuation_time(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
-		}
+		backend->write("MIP_model_second_stage.lp");
 	}
 
 
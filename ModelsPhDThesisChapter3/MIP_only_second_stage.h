@@ -7,7 +7,10 @@
 #ifndef MIP_ONLY_SECOND_STAGE_H
 #define MIP_ONLY_SECOND_STAGE_H
 
-#include "ilcplex\cplex.h"
+#include "MIP_backend.h"
+#include "MIP_utilities.h"
+#include <memory>
+#include <string>
 #include <vector>
 #include <chrono>
 
@@ -29,19 +32,19 @@ namespace alg
 
 
 		/*!
-		*	@brief	Pointer to the CPLEX environment.
+		*	@brief	The problem in the chosen solver.
 		*/
-		CPXENVptr env{ nullptr };
+		std::unique_ptr<mip_backend> backend;
 
 		/*!
-		*	@brief	Pointer to the CPLEX problem.
+		*	@brief	Column indices of the variable families in the problem.
 		*/
-		CPXLPptr problem{ nullptr };
+		variable_layout layout;
 
 		/*!
-		*	@brief	Store for CPLEX error messages.
+		*	@brief	The variables fixed by fix_solution(), with their original bounds.
 		*/
-		char error_text[CPXMESSAGEBUFSIZE];
+		column_fixing fixed_solution;
 
 		/*!
 		*	@brief	Number of columns (variables) in the problem formulation.
@@ -68,6 +71,16 @@ namespace alg
 		*/
 		double objective_value;
 
+		/*!
+		*	@brief	The progress of every solve since the problem was built.
+		*/
+		std::vector<mip_solve_trace> progress_traces;
+
+		/*!
+		*	@brief	False while the progress of the solves is not recorded (the many solves of the exhaustive search).
+		*/
+		bool record_progress = true;
+
 		/*!
 		*	@brief	Solution of the problem.
 		*/
@@ -83,6 +96,11 @@ namespace alg
 		*/
 		std::vector<double> solution_evacuation_times;
 
+		/*!
+		*	@brief	MIP start w.r.t. room assignments (empty if no start is given).
+		*/
+		std::vector<int> mip_start_lecture_room;
+
 		/*!
 		*	@brief	The computation time for the algorithm.
 		*/
@@ -112,6 +130,17 @@ namespace alg
 		*/
 		void evaluate_solution(const std::vector<int> lecture_room);
 
+		/*!
+		*	@brief	Give room assignments (e.g. found by the heuristic) as MIP start for the next runs of the algorithm.
+		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
+		*/
+		void set_mip_start(const std::vector<int>& lecture_room);
+
+		/*!
+		*	@brief	Remove the MIP start.
+		*/
+		void clear_mip_start() { mip_start_lecture_room.clear(); }
+
 		/*!
 		*	@brief	Get the computation time for the algorithm.
 		*	@returns The computation time for the algorithm.
@@ -130,6 +159,12 @@ namespace alg
 		*/
 		const std::string& get_solution_info() const { return solution_info; }
 
+		/*!
+		*	@brief	Get the progress (incumbent, bound and gap over time) of every solve of the last run.
+		*	@returns	The progress of every solve.
+		*/
+		const std::vector<mip_solve_trace>& get_progress_traces() const { return progress_traces; }
+
 		/*!
 		*	@brief	Get the room assigned to the given lecture in the solution.
 		*	@param	lecture	The lecture for which we want to know the room.
@@ -167,6 +202,21 @@ namespace alg
 		*/
 		double _time_limit = 3600;
 
+		/*!
+		*	@brief	The solver for the MIP model. CPLEX is only available if ALG_USE_CPLEX is defined and HiGHS if ALG_USE_HIGHS is defined.
+		*/
+		mip_solver _solver = default_mip_solver;
+
+		/*!
+		*	@brief	The threads, memory, node files and determinism of the solver.
+		*/
+		solver_resources _resources;
+
+		/*!
+		*	@brief	The file to which the progress of the solves is written with the output, empty for no file.
+		*/
+		std::string _progress_trace_file = "MIP_progress_second_stage.csv";
+
 		/*!
 		*	@brief	The type of objective function.
 		*/
@@ -178,24 +228,24 @@ namespace alg
 
 	private:
 		/*!
-		*	@brief	Initialize the CPLEX environment.
+		*	@brief	Create the problem in the chosen solver and set its parameters.
 		*/
-		void initialize_cplex();
+		void initialize_solver();
 
 		/*!
-		*	@brief	Build the CPLEX problem.
+		*	@brief	Build the problem.
 		*/
 		void build_problem();
 
 		/*!
-		*	@brief	Solve the CPLEX problem.
+		*	@brief	Solve the problem.
 		*/
 		void solve_problem();
 
 		/*!
-		*	@brief	Clear CPLEX.
+		*	@brief	Free the problem.
 		*/
-		void clear_cplex();
+		void clear_solver();
 
 		/*!
 		*	@brief	Write output.
@@ -215,12 +265,22 @@ namespace alg
 		*/
 		void generate_all_possible_solutions_independently(int timeslot, int current_event);
 
+		/*!
+		*	@brief	Add the MIP start, if one is given, to the problem.
+		*/
+		void add_mip_start_solution();
+
 		/*!
 		*	@brief	Fix the assignments for the solution that is to be evaluated.
 		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
 		*/
 		void fix_solution(const std::vector<int> lecture_room);
 
+		/*!
+		*	@brief	Undo fix_solution() by restoring the original bounds of the fixed variables.
+		*/
+		void unfix_solution();
+
 		/*!
 		*	@brief		Check which event is planned in the given timeslot and location.
 		*	@param      timeslot        The timeslot to check.
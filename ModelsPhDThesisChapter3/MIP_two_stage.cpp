@@ -3,10 +3,18 @@
 #include "building_data.h"
 #include "initial_solution.h"
 #include "logger.h"
+#include "MIP_utilities.h"
 
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <map>
+#include <limits>
+#include <cmath>
 
 
 
@@ -16,7 +24,7 @@ namespace alg
 	{
 		auto start_time = std::chrono::system_clock::now();
 
-		initialize_cplex();
+		initialize_solver();
 
 		build_masterproblem();
 		solve_masterproblem();
@@ -29,15 +37,44 @@ namespace alg
 		start_time = std::chrono::system_clock::now();
 
 		objective_value_secondstage = 0;
+		nb_variables_secondstage = 0;
+		nb_constraints_secondstage = 0;
 		double TT = 0, ET = 0;
+		std::vector<subproblem_part> parts;
+		parts.reserve(2 * nb_days);
 		for (int day = 0; day < nb_days; ++day)
 		{
 			for (int afternoon = 0; afternoon < 2; ++afternoon)
 			{
-				build_subproblem(day, afternoon);
-				solve_subproblem(day, afternoon);
+				// for which timeslots does this decomposed problem need to be constructed
+				subproblem_part part;
+
+				if (nb_timeslots_per_day == 5)
+				{
+					part.first_timeslot = day * nb_timeslots_per_day + afternoon * 2;
+					part.last_timeslot = day * nb_timeslots_per_day + 1 + afternoon * 3;
+				}
+				else if (nb_timeslots_per_day == 6)
+				{
+					part.first_timeslot = day * nb_timeslots_per_day + afternoon * 2;
+					part.last_timeslot = day * nb_timeslots_per_day + 1 + afternoon * 4;
+				}
+				else if (nb_timeslots_per_day == 9)
+				{
+					part.first_timeslot = day * nb_timeslots_per_day + afternoon * 3;
+					part.last_timeslot = day * nb_timeslots_per_day + 2 + afternoon * 6;
+				}
+				else
+				{
+					part.first_timeslot = 0;
+					part.last_timeslot = nb_timeslots - 1;
+				}
+
+				part.description = "day " + std::to_string(day + 1) + (afternoon == 0 ? " morning" : " afternoon");
+				parts.push_back(std::move(part));
 			}
 		}
+		solve_subproblem_parts(parts);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			for (auto&& tt : solution_travel_times)
@@ -56,8 +93,7 @@ namespace alg
 		}
 		objective_value_secondstage = _alpha * ET + (1 - _alpha) * TT;
 
-		clear_subproblem();
-		clear_cplex();
+		clear_solver();
 
 		computation_time_secondstage = std::chrono::system_clock::now() - start_time;
 
@@ -69,7 +105,7 @@ namespace alg
 	{
 		auto start_time = std::chrono::system_clock::now();
 
-		initialize_cplex();
+		initialize_solver();
 
 		build_masterproblem();
 		solve_masterproblem();
@@ -82,12 +118,17 @@ namespace alg
 		start_time = std::chrono::system_clock::now();
 
 		objective_value_secondstage = 0;
+		nb_variables_secondstage = 0;
+		nb_constraints_secondstage = 0;
 		double TT = 0, ET = 0;
+		std::vector<subproblem_part> parts(nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
-			build_subproblem(t);
-			solve_subproblem(t);
+			parts[t].first_timeslot = t;
+			parts[t].last_timeslot = t;
+			parts[t].description = "timeslot " + std::to_string(t + 1);
 		}
+		solve_subproblem_parts(parts);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			for (auto&& tt : solution_travel_times)
@@ -106,8 +147,7 @@ namespace alg
 		}
 		objective_value_secondstage = _alpha * ET + (1 - _alpha) * TT;
 
-		clear_subproblem();
-		clear_cplex();
+		clear_solver();
 
 		computation_time_secondstage = std::chrono::system_clock::now() - start_time;
 
@@ -120,7 +160,7 @@ namespace alg
 	{
 		auto start_time = std::chrono::system_clock::now();
 
-		initialize_cplex();
+		initialize_solver();
 
 		build_masterproblem();
 		solve_masterproblem();
@@ -139,7 +179,7 @@ namespace alg
 		solve_subproblem();
 		clear_subproblem();
 
-		clear_cplex();
+		clear_solver();
 
 		computation_time_secondstage = std::chrono::system_clock::now() - start_time;
 
@@ -147,60 +187,450 @@ namespace alg
 	}
 
 
-	void MIP_two_stage::run_only_first_stage()
+	void MIP_two_stage::run_algorithm_benders()
 	{
 		auto start_time = std::chrono::system_clock::now();
 
-		initialize_cplex();
+		initialize_solver();
 
 		build_masterproblem();
-		solve_masterproblem();
+		add_benders_variables_masterproblem();
+
+		// The subproblems of the timeslots only minimize the evacuation time
+		const double alpha = _alpha;
+		_alpha = 1;
+
+		// (bound, evacuation time of the incumbent) of each evaluated set of lectures, (-1, -1) if proven infeasible
+		std::map<std::vector<int>, std::pair<double, double>> evacuation_time_cache;
+		std::vector<int> best_lecture_timeslot;
+		std::vector<int> best_lecture_room;
+		bool converged = false;
+		bool subproblem_unsolved = false;	// a subproblem reached a limit without solution, so nothing is known about its set
+		bool bounds_not_tight = false;		// no new sets, but some bounds of the timetable are below their incumbents
+		benders_iterations = 0;
+		benders_nb_subproblems = 0;
+		benders_lower_bound = -std::numeric_limits<double>::infinity();
+		benders_upper_bound = std::numeric_limits<double>::infinity();
+
+		try
+		{
+			while (!converged && benders_iterations < _benders_max_iterations)
+			{
+				++benders_iterations;
+
+				// 1. masterproblem, warm started from the best timetable so far
+				if (!best_lecture_timeslot.empty())
+				{
+					masterproblem->clear_mip_starts();
+					add_timetable_start_masterproblem(best_lecture_timeslot, best_lecture_room);
+				}
+				solve_masterproblem();
+				if (!solution_firststage_exists)
+					break;
+
+				const double bound = masterproblem->get_best_bound();
+				benders_lower_bound = std::max(benders_lower_bound, bound);
+				const std::vector<int> master_lecture_room = solution_lecture_room;	// replaced by the rooms of the subproblems below
+
+				// 2. subproblems for the sets of lectures that have not been evaluated yet, solved in parallel
+				std::vector<std::vector<int>> timeslot_lectures(nb_timeslots);
+				for (int l = 0; l < nb_sessions; ++l)
+					timeslot_lectures.at(solution_lecture_timeslot.at(l)).push_back(l);
+
+				std::vector<subproblem_part> parts;
+				for (int t = 0; t < nb_timeslots; ++t)
+				{
+					if (!timeslot_lectures[t].empty() && evacuation_time_cache.count(timeslot_lectures[t]) == 0)
+					{
+						subproblem_part part;
+						part.first_timeslot = t;
+						part.last_timeslot = t;
+						part.description = "timeslot " + std::to_string(t + 1);
+						parts.push_back(std::move(part));
+					}
+				}
+
+				nb_variables_secondstage = 0;
+				nb_constraints_secondstage = 0;
+				solution_travel_times.clear();
+				solution_evacuation_times.clear();
+				solve_subproblem_parts(parts);
+				benders_nb_subproblems += static_cast<int>(parts.size());
+
+				// 3. cuts for the new sets: optimality cuts with the proven bound of the subproblem, feasibility cuts only for proven infeasibility
+				// (a subproblem that reached a limit without solution gets no cut and isn't cached)
+				std::vector<std::vector<int>> new_sets;
+				std::vector<double> new_bounds;
+				for (auto&& part : parts)
+				{
+					if (part.solution_exists)
+					{
+						new_sets.push_back(timeslot_lectures[part.first_timeslot]);
+						new_bounds.push_back(part.objective_bound);
+						evacuation_time_cache[new_sets.back()] = std::make_pair(part.objective_bound, part.evacuation_times.at(0));
+					}
+					else if (part.proven_infeasible)
+					{
+						new_sets.push_back(timeslot_lectures[part.first_timeslot]);
+						new_bounds.push_back(-1);
+						evacuation_time_cache[new_sets.back()] = std::make_pair(-1.0, -1.0);
+					}
+					else
+						subproblem_unsolved = true;
+				}
+				if (!new_sets.empty())
+					add_benders_cuts(new_sets, new_bounds);
+				if (subproblem_unsolved)
+					break;
+
+				// 4. upper bound: the objective value of the timetable of the masterproblem with the incumbents of the subproblems
+				bool feasible = true;
+				bool tight = true;
+				double evacuation = 0;
+				for (int t = 0; t < nb_timeslots; ++t)
+				{
+					if (!timeslot_lectures[t].empty())
+					{
+						const std::pair<double, double>& times = evacuation_time_cache.at(timeslot_lectures[t]);
+						const double time = times.second;
+						if (time < 0)
+							feasible = false;
+						else if (_objective_type == objective_type::maximum_over_timeslots)
+							evacuation = std::max(evacuation, time);
+						else
+							evacuation += time;
+
+						if (time - times.first > _optimality_tolerance * std::max(1.0, std::abs(time)))
+							tight = false;
+					}
+				}
+				if (feasible)
+				{
+					const double value = _lambda * compute_preferences(solution_lecture_timeslot) + (1 - _lambda) * evacuation;
+					if (value < benders_upper_bound)
+					{
+						benders_upper_bound = value;
+						best_lecture_timeslot = solution_lecture_timeslot;
+						best_lecture_room = master_lecture_room;
+					}
+				}
+
+				// Without new sets the masterproblem already knows the evacuation times of its timetable, but only if these are proven optimal;
+				// otherwise it would propose the same timetable again
+				converged = (benders_upper_bound - benders_lower_bound <= _optimality_tolerance * std::max(1.0, std::abs(benders_upper_bound)));
+				if (!converged && new_sets.empty())
+				{
+					converged = tight;
+					bounds_not_tight = !tight;
+					if (bounds_not_tight)
+						break;
+				}
+			}
+		}
+		catch (...)
+		{
+			_alpha = alpha;
+			clear_solver();
+			throw;
+		}
+		_alpha = alpha;
 		clear_masterproblem();
-		clear_cplex();
+
+		if (best_lecture_timeslot.empty())
+		{
+			clear_solver();
+			if (subproblem_unsolved)
+				throw std::runtime_error("Couldn't solve second stage, because no solution for first stage exists. Reason: a subproblem reached a limit without finding a solution");
+			throw std::runtime_error("Couldn't solve second stage, because no solution for first stage exists. Reason: " + solution_info_firststage);
+		}
+
+		// The best timetable is the solution of the first stage
+		solution_firststage_exists = true;
+		if (converged)
+			solution_info_firststage = "Benders decomposition converged";
+		else if (subproblem_unsolved)
+			solution_info_firststage = "Benders decomposition did not converge: a subproblem reached a limit without finding a solution";
+		else if (bounds_not_tight)
+			solution_info_firststage = "Benders decomposition did not converge: the subproblems of the best timetable are not solved to optimality";
+		else if (benders_iterations >= _benders_max_iterations)
+			solution_info_firststage = "Benders decomposition stopped at the iteration limit";
+		else
+			solution_info_firststage = "Benders decomposition stopped, masterproblem not solved: " + solution_info_firststage;
+		solution_lecture_timeslot = best_lecture_timeslot;
+		solution_lecture_room = best_lecture_room;
+		objective_value_firststage = compute_preferences(solution_lecture_timeslot);
 
 		computation_time_firststage = std::chrono::system_clock::now() - start_time;
+		start_time = std::chrono::system_clock::now();
+
+		// Room assignments, travel and evacuation times of the best timetable, with the original second stage objective
+		build_subproblem();
+		solve_subproblem();
+		clear_subproblem();
+
+		clear_solver();
+
+		computation_time_secondstage = std::chrono::system_clock::now() - start_time;
 
 		write_output();
+		write_output_benders();
 	}
 
 
+	void MIP_two_stage::add_benders_variables_masterproblem()
+	{
+		double obj[1];						// Objective function
+		double lb[1];						// Lower bound variables
+		char *colname[1];					// Variable names
+		double rhs[1];						// Right-hand side constraints
+		char sense[1];						// Sign of constraint
+		int matbeg[1];						// Begin position of the constraint
+		int matind[2];						// Position of each element in constraint matrix
+		double matval[2];					// Value of each element in constraint matrix
+
+		// Add the T(evac)_t,max variables: the estimate of the evacuation time in each timeslot
+		layout_masterproblem.add_family(variable_family::T_evac_max_t, nb_timeslots);
+		for (int t = 0; t < nb_timeslots; ++t)
+		{
+			std::string name = "T_evac_max_" + std::to_string(t + 1);
+			colname[0] = const_cast<char*>(name.c_str());
 
+			if (_objective_type == objective_type::maximum_over_timeslots)
+				obj[0] = 0;
+			else
+				obj[0] = (1 - _lambda);
+			lb[0] = 0;
 
-	void MIP_two_stage::initialize_cplex()
-	{
-		int status = 0;
+			layout_masterproblem.add_column(variable_family::T_evac_max_t, t);
+			masterproblem->add_columns(1, obj, lb, NULL, NULL, colname);
+		}
 
-		// Open the cplex environment
-		env = CPXopenCPLEX(&status);
-		if (status != 0)
+		// Add the T(evac)_max_overall variable and its lower bounds
+		layout_masterproblem.add_family(variable_family::T_evac_max_overall);
+		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::initialize_cplex(). \nCouldn't open CPLEX. \nReason: " + std::string(error_text));
+			std::string name = "T_evac_max_overall";
+			colname[0] = const_cast<char*>(name.c_str());
+
+			obj[0] = (1 - _lambda);
+			lb[0] = 0;
+
+			layout_masterproblem.add_column(variable_family::T_evac_max_overall);
+			masterproblem->add_columns(1, obj, lb, NULL, NULL, colname);
+
+			for (int t = 0; t < nb_timeslots; ++t)
+			{
+				name = "Evacuation_max_overall_" + std::to_string(t + 1);
+				char* rowname[1] = { const_cast<char*>(name.c_str()) };
+
+				sense[0] = 'G';
+				rhs[0] = 0;
+				matbeg[0] = 0;
+				matind[0] = layout_masterproblem.index(variable_family::T_evac_max_overall);
+				matval[0] = 1;
+				matind[1] = layout_masterproblem.index(variable_family::T_evac_max_t, t);
+				matval[1] = -1;
+
+				masterproblem->add_rows(1, 2, rhs, sense, matbeg, matind, matval, rowname);
+			}
 		}
 
-		// Set the output to screen on/off
-		status = CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_OFF);
-		if (status != 0)
+		// Weigh the preferences with lambda
+		std::vector<int> indices;
+		std::vector<double> values;
+		for (int l = 0; l < nb_sessions; ++l)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::initialize_cplex(). \nCouldn't set the output to screen off. \nReason: " + std::string(error_text));
+			for (int t = 0; t < nb_timeslots; ++t)
+			{
+				for (int c = 0; c < nb_locations; ++c)
+				{
+					if (layout_masterproblem.exists(variable_family::x_ltc, l, t, c))
+					{
+						indices.push_back(layout_masterproblem.index(variable_family::x_ltc, l, t, c));
+						values.push_back(_lambda * (get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t)));
+					}
+				}
+			}
 		}
 
-		// Set tolerance gap
-		status = CPXsetdblparam(env, CPX_PARAM_EPGAP, _optimality_tolerance);
-		if (status != 0)
+		masterproblem->change_objective((int)indices.size(), indices.data(), values.data());
+
+		// Get model info
+		nb_variables_firststage = masterproblem->get_nb_columns();
+		nb_constraints_firststage = masterproblem->get_nb_rows();
+	}
+
+
+	void MIP_two_stage::add_benders_cuts(const std::vector<std::vector<int>>& lecture_sets, const std::vector<double>& evacuation_times)
+	{
+		std::vector<double> rhs;
+		std::vector<char> sense;
+		std::vector<int> matbeg;
+		std::vector<int> matind;
+		std::vector<double> matval;
+
+		for (size_t i = 0; i < lecture_sets.size(); ++i)
+		{
+			const std::vector<int>& lectures = lecture_sets[i];
+			const double time = evacuation_times[i];
+
+			for (int t = 0; t < nb_timeslots; ++t)
+			{
+				if (time > 0)
+				{
+					// Optimality cut: T_evac_max_t >= time * (1 - number of lectures of the set not in timeslot t)
+					matbeg.push_back(static_cast<int>(matind.size()));
+					sense.push_back('G');
+					rhs.push_back(time * (1 - static_cast<double>(lectures.size())));
+					matind.push_back(layout_masterproblem.index(variable_family::T_evac_max_t, t));
+					matval.push_back(1);
+					for (auto&& l : lectures)
+					{
+						for (int c = 0; c < nb_locations; ++c)
+						{
+							if (layout_masterproblem.exists(variable_family::x_ltc, l, t, c))
+							{
+								matind.push_back(layout_masterproblem.index(variable_family::x_ltc, l, t, c));
+								matval.push_back(-time);
+							}
+						}
+					}
+				}
+				else if (time < 0)
+				{
+					// Feasibility cut: the set (or a superset) is never assigned to timeslot t
+					matbeg.push_back(static_cast<int>(matind.size()));
+					sense.push_back('L');
+					rhs.push_back(static_cast<double>(lectures.size()) - 1);
+					for (auto&& l : lectures)
+					{
+						for (int c = 0; c < nb_locations; ++c)
+						{
+							if (layout_masterproblem.exists(variable_family::x_ltc, l, t, c))
+							{
+								matind.push_back(layout_masterproblem.index(variable_family::x_ltc, l, t, c));
+								matval.push_back(1);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		if (matbeg.empty())
+			return;
+
+		// All cuts in a single call
+		masterproblem->add_rows(static_cast<int>(matbeg.size()), static_cast<int>(matind.size()), rhs.data(), sense.data(), matbeg.data(), matind.data(), matval.data(), NULL);
+
+		nb_constraints_firststage = masterproblem->get_nb_rows();
+	}
+
+
+	void MIP_two_stage::run_pareto_sweep(const std::vector<double>& alpha_values)
+	{
+		pareto_points.clear();
+		pareto_points.reserve(alpha_values.size());
+
+		auto start_time = std::chrono::system_clock::now();
+
+		initialize_solver();
+
+		// The first stage does not depend on alpha, so it is solved only once
+		build_masterproblem();
+		solve_masterproblem();
+		clear_masterproblem();
+
+		if (!solution_firststage_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::initialize_cplex(). \nCouldn't set the tolerance gap. \nReason: " + std::string(error_text));
+			clear_solver();
+			throw std::runtime_error("Couldn't solve second stage, because no solution for first stage exists. Reason: " + solution_info_firststage);
 		}
 
-		// Time limit for the MIP
-		status = CPXsetdblparam(env, CPX_PARAM_TILIM, _time_limit);
-		if (status != 0)
+		computation_time_firststage = std::chrono::system_clock::now() - start_time;
+
+		// The constraints of the second stage do not depend on alpha either
+		build_subproblem();
+
+		for (auto&& alpha : alpha_values)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::initialize_cplex(). \nCouldn't set the time limit. \nReason: " + std::string(error_text));
+			start_time = std::chrono::system_clock::now();
+
+			_alpha = alpha;
+			update_objective_coefficients_subproblem();
+
+			// Warm start from the room assignments of the previous point (still feasible, only the objective has changed)
+			if (!pareto_points.empty() && pareto_points.back().solution_exists)
+			{
+				subproblem->clear_mip_starts();
+				add_room_assignment_start(*subproblem, layout_subproblem, pareto_points.back().lecture_room, 0, nb_timeslots - 1);
+			}
+
+			solve_subproblem();
+
+			computation_time_secondstage = std::chrono::system_clock::now() - start_time;
+
+			write_output();
+
+			pareto_point point;
+			point.alpha = _alpha;
+			point.solution_exists = solution_secondstage_exists;
+			point.solution_info = solution_info_secondstage;
+			point.computation_time = get_computation_time_secondstage();
+			if (solution_secondstage_exists)
+			{
+				point.objective_value = objective_value_secondstage;
+				point.preferences = compute_preferences(solution_lecture_timeslot);
+				point.travel_times = solution_travel_times;
+				point.evacuation_times = solution_evacuation_times;
+				point.lecture_timeslot = solution_lecture_timeslot;
+				point.lecture_room = solution_lecture_room;
+			}
+			pareto_points.push_back(point);
 		}
+
+		clear_subproblem();
+		clear_solver();
+	}
+
+
+	void MIP_two_stage::run_only_first_stage()
+	{
+		auto start_time = std::chrono::system_clock::now();
+
+		initialize_solver();
+
+		build_masterproblem();
+		solve_masterproblem();
+		clear_masterproblem();
+		clear_solver();
+
+		computation_time_firststage = std::chrono::system_clock::now() - start_time;
+
+		write_output();
+	}
+
+
+
+
+	void MIP_two_stage::initialize_solver()
+	{
+		// The problems are created by their build functions
+		progress_traces.clear();
+	}
+
+
+	std::unique_ptr<mip_backend> MIP_two_stage::create_problem(const std::string& name, const solver_resources& resources) const
+	{
+		// Create an empty minimization problem in the chosen solver
+		std::unique_ptr<mip_backend> problem = create_mip_backend(_solver, name);
+
+		// Set the output to screen off, the tolerance gap and the time limit for the MIP
+		problem->set_output(false);
+		problem->set_optimality_tolerance(_optimality_tolerance);
+		problem->set_time_limit(_time_limit);
+		problem->set_resources(resources);
+		return problem;
 	}
 
 
@@ -209,7 +639,6 @@ namespace alg
 	void MIP_two_stage::build_masterproblem()
 	{
 		constexpr int Big_M = 10000;
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -225,27 +654,18 @@ namespace alg
 
 
 											// Create arrays
-		matind = std::make_unique<int[]>(1000000);
-		matval = std::make_unique<double[]>(1000000);
+		const int max_row_length = max_row_length_timetable();
+		matind = std::make_unique<int[]>(max_row_length);
+		matval = std::make_unique<double[]>(max_row_length);
 
 		// Create the masterproblem
-		masterproblem = CPXcreateprob(env, &status, "masterproblem");
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't create the CPLEX masterproblem. \nReason: " + std::string(error_text));
-		}
-
-		// masterproblem is minimization
-		CPXchgobjsen(env, masterproblem, CPX_MIN);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't set the masterproblem type to minimization. \nReason: " + std::string(error_text));
-		}
+		masterproblem = create_problem("masterproblem", _resources);
 
 		// VARIABLES
+		layout_masterproblem.clear();
+
 		// Add the X_ltc variables
+		layout_masterproblem.add_family(variable_family::x_ltc, nb_sessions, nb_timeslots, nb_locations);
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int t = 0; t < nb_timeslots; ++t)
@@ -261,12 +681,8 @@ namespace alg
 					ub[0] = 1;
 					type[0] = 'B';
 
-					status = CPXnewcols(env, masterproblem, 1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout_masterproblem.add_column(variable_family::x_ltc, l, t, c);
+					masterproblem->add_columns(1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
@@ -292,19 +708,14 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c))
 					{
-						matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+						matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 			}
 
-			status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-			}
+			masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 		}
 
 
@@ -326,18 +737,13 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c))
 					{
-						matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+						matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 
-				status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -363,25 +769,20 @@ namespace alg
 						{
 							if (get_sessionlocationpossible(l, c))
 							{
-								matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t, c);
 								matval[f] = 1;
 								++f;
 							}
 
 							if (get_sessionlocationpossible(m, c))
 							{
-								matind[f] = m * nb_timeslots*nb_locations + t * nb_locations + c;
+								matind[f] = layout_masterproblem.index(variable_family::x_ltc, m, t, c);
 								matval[f] = 1;
 								++f;
 							}
 						}
 
-						status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -412,7 +813,7 @@ namespace alg
 							{
 								if (get_sessionlocationpossible(l, c))
 								{
-									matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+									matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t, c);
 									matval[f] = 1;
 									++f;
 								}
@@ -421,12 +822,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -455,22 +851,22 @@ namespace alg
 								if (get_sessionlocationpossible(l, c))
 								{
 									// t
-									matind[f] = l * nb_timeslots*nb_locations + t * nb_locations + c;
+									matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t, c);
 									matval[f] = 1;
 									++f;
 
 									// t + 1
-									matind[f] = l * nb_timeslots*nb_locations + (t + 1) * nb_locations + c;
+									matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t + 1, c);
 									matval[f] = 1;
 									++f;
 
 									// t + 2
-									matind[f] = l * nb_timeslots*nb_locations + (t + 2) * nb_locations + c;
+									matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t + 2, c);
 									matval[f] = 1;
 									++f;
 
 									// t + 3
-									matind[f] = l * nb_timeslots*nb_locations + (t + 3) * nb_locations + c;
+									matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, t + 3, c);
 									matval[f] = 1;
 									++f;
 								}
@@ -479,12 +875,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -511,12 +902,12 @@ namespace alg
 							if (get_sessionlocationpossible(l, c))
 							{
 								// first timeslot of day
-								matind[f] = l * nb_timeslots*nb_locations + day * nb_timeslots_per_day * nb_locations + c;
+								matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, day * nb_timeslots_per_day, c);
 								matval[f] = 1;
 								++f;
 
 								// last timeslot of day
-								matind[f] = l * nb_timeslots*nb_locations + ((day + 1)*nb_timeslots_per_day - 1) * nb_locations + c;
+								matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, (day + 1)*nb_timeslots_per_day - 1, c);
 								matval[f] = 1;
 								++f;
 							}
@@ -524,12 +915,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -556,12 +942,12 @@ namespace alg
 							if (get_sessionlocationpossible(l, c))
 							{
 								// last timeslot of day
-								matind[f] = l * nb_timeslots*nb_locations + ((day + 1)*nb_timeslots_per_day - 1) * nb_locations + c;
+								matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, (day + 1)*nb_timeslots_per_day - 1, c);
 								matval[f] = 1;
 								++f;
 
 								// first timeslot of next day
-								matind[f] = l * nb_timeslots*nb_locations + (day + 1)*nb_timeslots_per_day * nb_locations + c;
+								matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, (day + 1)*nb_timeslots_per_day, c);
 								matval[f] = 1;
 								++f;
 
@@ -571,12 +957,7 @@ namespace alg
 					}
 				}
 
-				status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -609,17 +990,17 @@ namespace alg
 										if (get_sessionlocationpossible(l, c))
 										{
 											// timeslot t
-											matind[f] = l * nb_timeslots*nb_locations + (day*nb_timeslots_per_day + t) * nb_locations + c;
+											matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, day*nb_timeslots_per_day + t, c);
 											matval[f] = 1;
 											++f;
 
 											// timeslot t + 2
-											matind[f] = l * nb_timeslots*nb_locations + (day*nb_timeslots_per_day + t + 2) * nb_locations + c;
+											matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, day*nb_timeslots_per_day + t + 2, c);
 											matval[f] = 1;
 											++f;
 
 											// timeslot t + 1
-											matind[f] = l * nb_timeslots*nb_locations + (day*nb_timeslots_per_day + t + 1) * nb_locations + c;
+											matind[f] = layout_masterproblem.index(variable_family::x_ltc, l, day*nb_timeslots_per_day + t + 1, c);
 											matval[f] = -1;
 											++f;
 										}
@@ -627,12 +1008,7 @@ namespace alg
 								}
 							}
 
-							status = CPXaddrows(env, masterproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function MIP_monolithic::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-							}
+							masterproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 						}
 					}
 				}
@@ -642,111 +1018,60 @@ namespace alg
 
 
 		// Write to file
-		status = CPXwriteprob(env, masterproblem, "MIP_model_first_stage.lp", NULL);
-		/*if (status != 0)
-		{
-		CPXgeterrorstring(env, status, error_text);
-		throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nFailed to write the masterproblem to a file. \nReason: " + std::string(error_text));
-		}*/
+		masterproblem->write("MIP_model_first_stage.lp");
+
+		// MIP start
+		add_mip_start_masterproblem();
+
 
 		// Get model info
-		nb_variables_firststage = CPXgetnumcols(env, masterproblem);
-		nb_constraints_firststage = CPXgetnumrows(env, masterproblem);
+		nb_variables_firststage = masterproblem->get_nb_columns();
+		nb_constraints_firststage = masterproblem->get_nb_rows();
 	}
 
 
 	void MIP_two_stage::solve_masterproblem()
 	{
-		int status = 0;
-		int solstat;
-		std::unique_ptr<double[]> solution_CPLEX = std::make_unique<double[]>(CPXgetnumcols(env, masterproblem));
+		std::vector<double> solution_values;
 
 
 		// Optimize the masterproblem
-		std::cout << "\n\nCPLEX is solving the first stage MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		status = CPXmipopt(env, masterproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::solve_problem(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
+		std::cout << "\n\nThe solver is solving the first stage MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
+		progress_traces.push_back(mip_solve_trace());
+		progress_traces.back().name = "first_stage";
+		masterproblem->set_progress_trace(&progress_traces.back());
+		const mip_status status = masterproblem->solve();
+		masterproblem->set_progress_trace(nullptr);
+
+		// Check the solution status
+		solution_firststage_exists = mip_status_has_solution(status);
+		solution_info_firststage = mip_status_description(status);
 
 		// Get the solution
-		status = CPXsolution(env, masterproblem, &solstat, &objective_value_firststage, solution_CPLEX.get(), NULL, NULL, NULL);
-		if (status != 0)
+		if (solution_firststage_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::solve_problem(). \nCPXsolution failed. \nReason: " + std::string(error_text));
+			objective_value_firststage = masterproblem->get_objective_value();
+			masterproblem->get_solution(solution_values);
 		}
 
-
-		// Check the solution status
-		if (solstat == CPXMIP_OPTIMAL) {
-			solution_firststage_exists = true;
-			solution_info_firststage = "Optimal solution found";
-		}
-		else if (solstat == CPXMIP_OPTIMAL_TOL) {
-			solution_firststage_exists = true;
-			solution_info_firststage = "Solution found within tolerance limit";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_FEAS) {
-			solution_firststage_exists = true;
-			solution_info_firststage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_FEAS) {
-			solution_firststage_exists = true;
-			solution_info_firststage = "Tree memory limit exceeded";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_firststage_exists = false;
-			solution_info_firststage = "masterproblem is infeasible";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_firststage_exists = false;
-			solution_info_firststage = "masterproblem is infeasible";
-		}
-		else if (solstat == CPXMIP_UNBOUNDED) {
-			solution_firststage_exists = false;
-			solution_info_firststage = "masterproblem is unbounded";
-		}
-		else if (solstat == CPXMIP_INForUNBD) {
-			solution_firststage_exists = false;
-			solution_info_firststage = "masterproblem is infeasible or unbounded";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_INFEAS) {
-			solution_firststage_exists = false;
-			solution_info_firststage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_INFEAS) {
-			solution_firststage_exists = false;
-			solution_info_firststage = "Tree memory limit exceeded";
-		}
-		else {
-			solution_firststage_exists = false;
-			solution_info_firststage = "Other reason for failure";
-		}
-
-		std::cout << "\nCPLEX has finished: " << solution_info_firststage << "\n";
+		std::cout << "\nThe solver has finished: " << solution_info_firststage << "\n";
 
 
 		if (solution_firststage_exists)
 		{
-			// 1. solution: assignment of lectures to timeslots and rooms
-			solution_lecture_timeslot.reserve(nb_sessions*nb_timeslots);
-			solution_lecture_room.reserve(nb_sessions*nb_locations);
+			// 1. solution: assignment of lectures to timeslots and rooms (replaces the solution of a previous solve)
+			solution_lecture_timeslot.assign(nb_sessions, -1);
+			solution_lecture_room.assign(nb_sessions, -1);
 			for (int l = 0; l < nb_sessions; ++l)
 			{
-				solution_lecture_room.push_back(-1);
-				solution_lecture_timeslot.push_back(-1);
-
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
 					for (int r = 0; r < nb_locations; ++r)
 					{
-						if (solution_CPLEX[l*nb_timeslots*nb_locations + t * nb_locations + r] > 0.99)
+						if (solution_values[layout_masterproblem.index(variable_family::x_ltc, l, t, r)] > 0.99)
 						{
-							solution_lecture_timeslot.back() = t;
-							solution_lecture_room.back() = r;
+							solution_lecture_timeslot.at(l) = t;
+							solution_lecture_room.at(l) = r;
 							break;
 						}
 					}
@@ -758,15 +1083,8 @@ namespace alg
 
 	void MIP_two_stage::clear_masterproblem()
 	{
-		int status = 0;
-
 		// Free the masterproblem
-		status = CPXfreeprob(env, &masterproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::clear_masterproblem(). \nCouldn't free the masterproblem. \nReason: " + std::string(error_text));
-		}
+		masterproblem.reset();
 	}
 
 
@@ -774,7 +1092,6 @@ namespace alg
 	void MIP_two_stage::build_subproblem()
 	{
 		constexpr int Big_M = 10000;
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -790,27 +1107,37 @@ namespace alg
 
 
 											// Create arrays
-		matind = std::make_unique<int[]>(10000000);
-		matval = std::make_unique<double[]>(10000000);
+		const int max_row_length = max_row_length_flows();
+		matind = std::make_unique<int[]>(max_row_length);
+		matval = std::make_unique<double[]>(max_row_length);
 
 		// Create the subproblem
-		subproblem = CPXcreateprob(env, &status, "problem_second_stage");
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't create the CPLEX subproblem. \nReason: " + std::string(error_text));
-		}
+		subproblem = create_problem("problem_second_stage", _resources);
 
-		// Subproblem is minimization
-		CPXchgobjsen(env, subproblem, CPX_MIN);
-		if (status != 0)
+#ifdef ALG_USE_CPLEX
+		// Read the model from the cache if it has been built before for this timetable (CPLEX only, the cache holds SAV files)
+		std::string cache_key;
+		cplex_backend* cplex_subproblem = dynamic_cast<cplex_backend*>(subproblem.get());
+		if (cplex_subproblem != nullptr && !_model_cache_directory.empty())
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't set the subproblem type to minimization. \nReason: " + std::string(error_text));
+			const double objective_type_value = (_objective_type == objective_type::maximum_over_timeslots ? 0 : 1);
+			cache_key = model_cache_key("second_stage", { _alpha, objective_type_value, lazy_travel_constraints_enabled() ? 1.0 : 0.0 }, solution_lecture_timeslot);
+			if (cplex_subproblem->read_cached_model(layout_subproblem, _model_cache_directory, cache_key))
+			{
+				finish_build_subproblem();
+				return;
+			}
 		}
+#endif // ALG_USE_CPLEX
 
 		// VARIABLES
+		layout_subproblem.clear();
+
+		// paths that lead from a possible room of each session to the outside
+		const std::vector<bool> session_evacuation_paths = compute_session_evacuation_paths();
+
 		// Add the W_lc variables
+		layout_subproblem.add_family(variable_family::w_lc, nb_sessions, nb_locations);
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int c = 0; c < nb_locations; ++c)
@@ -824,16 +1151,13 @@ namespace alg
 				ub[0] = 1;
 				type[0] = 'B';
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout_subproblem.add_column(variable_family::w_lc, l, c);
+				subproblem->add_columns(1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the U(travel)_tsp variables
+		layout_subproblem.add_family(variable_family::U_travel_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -846,17 +1170,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout_subproblem.add_column(variable_family::U_travel_tsp, t, s, p);
+					subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel_arc)_tij variables
+		layout_subproblem.add_family(variable_family::T_travel_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -867,16 +1188,13 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout_subproblem.add_column(variable_family::T_travel_arc_tij, t, ij);
+				subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(travel)_tsp variables
+		layout_subproblem.add_family(variable_family::T_travel_total_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -889,17 +1207,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					layout_subproblem.add_column(variable_family::T_travel_total_tsp, t, s, p);
+					subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel)_t,max variables
+		layout_subproblem.add_family(variable_family::T_travel_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_travel_max_" + std::to_string(t + 1);
@@ -911,38 +1226,35 @@ namespace alg
 				obj[0] = (1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout_subproblem.add_column(variable_family::T_travel_max_t, t);
+			subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the U(evac)_tlp variables
+		layout_subproblem.add_family(variable_family::U_evac_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
+					if (solution_lecture_timeslot[l] == t && session_evacuation_paths[l * nb_paths + p])
+					{
+						std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
+						colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = 0;
-					lb[0] = 0;
+						obj[0] = 0;
+						lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						layout_subproblem.add_column(variable_family::U_evac_tlp, t, l, p);
+						subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 					}
 				}
 			}
 		}
 
 		// Add the T(evac_arc)_tij variables
+		layout_subproblem.add_family(variable_family::T_evac_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -953,39 +1265,36 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				layout_subproblem.add_column(variable_family::T_evac_arc_tij, t, ij);
+				subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(evac)_tlp variables
+		layout_subproblem.add_family(variable_family::T_evac_total_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
+					if (solution_lecture_timeslot[l] == t && session_evacuation_paths[l * nb_paths + p])
+					{
+						std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
+						colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = 0;
-					lb[0] = 0;
+						obj[0] = 0;
+						lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						layout_subproblem.add_column(variable_family::T_evac_total_tlp, t, l, p);
+						subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 					}
 				}
 			}
 		}
 
 		// Add the T(evac)_t,max variables
+		layout_subproblem.add_family(variable_family::T_evac_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_evac_max_" + std::to_string(t + 1);
@@ -997,15 +1306,12 @@ namespace alg
 				obj[0] = _alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout_subproblem.add_column(variable_family::T_evac_max_t, t);
+			subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(travel)_max_overall variable
+		layout_subproblem.add_family(variable_family::T_travel_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_travel_max_overall";
@@ -1014,15 +1320,12 @@ namespace alg
 			obj[0] = (1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout_subproblem.add_column(variable_family::T_travel_max_overall);
+			subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(evac)_max_overall variable
+		layout_subproblem.add_family(variable_family::T_evac_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_evac_max_overall";
@@ -1031,12 +1334,8 @@ namespace alg
 			obj[0] = _alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			layout_subproblem.add_column(variable_family::T_evac_max_overall);
+			subproblem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 
@@ -1058,18 +1357,13 @@ namespace alg
 			{
 				if (get_sessionlocationpossible(l, c))
 				{
-					matind[f] = l * nb_locations + c;
+					matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 					matval[f] = 1;
 					++f;
 				}
 			}
 
-			status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-			}
+			subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 		}
 
 
@@ -1091,78 +1385,72 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c) && solution_lecture_timeslot[l] == t)
 					{
-						matind[f] = l * nb_locations + c;
+						matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
 
 		// FLOWS BETWEEN EVENTS IN CONSECUTIVE TIMESLOTS
 		// Constraint set 8: U_tsp constraints 
-		for (int t = 0; t < nb_timeslots; ++t)
+		// Left out if they are separated in the lazy constraint callback
+		if (!lazy_travel_constraints_enabled())
 		{
-			for (int s = 0; s < nb_series; ++s)
+			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				for (int l = 0; l < nb_sessions; ++l)
+				for (int s = 0; s < nb_series; ++s)
 				{
-					if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t) // only lectures planned in this timeslot
+					for (int l = 0; l < nb_sessions; ++l)
 					{
-						for (int m = 0; m < nb_sessions; ++m)
+						if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t) // only lectures planned in this timeslot
 						{
-							if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t + 1) // lectures planned in the next timeslot
+							for (int m = 0; m < nb_sessions; ++m)
 							{
-								for (int c = 0; c < nb_locations; ++c)
+								if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t + 1) // lectures planned in the next timeslot
 								{
-									if (get_sessionlocationpossible(l, c))
+									for (int c = 0; c < nb_locations; ++c)
 									{
-										for (int d = 0; d < nb_locations; ++d)
+										if (get_sessionlocationpossible(l, c))
 										{
-											if (get_sessionlocationpossible(m, d))
+											for (int d = 0; d < nb_locations; ++d)
 											{
-												for (int p = 0; p < nb_paths; ++p)
+												if (get_sessionlocationpossible(m, d))
 												{
-													if (get_roomroompath(c, d, p) > 0)
+													for (int p = 0; p < nb_paths; ++p)
 													{
-														sense[0] = 'L';
-														rhs[0] = get_roomroompath(c, d, p);
+														if (get_roomroompath(c, d, p) > 0)
+														{
+															sense[0] = 'L';
+															rhs[0] = get_roomroompath(c, d, p);
 
-														std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
-														rowname[0] = const_cast<char*>(name.c_str());
+															std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
+															rowname[0] = const_cast<char*>(name.c_str());
 
-														matbeg[0] = 0;
-														f = 0;
+															matbeg[0] = 0;
+															f = 0;
 
-														// w_lc
-														matind[f] = l * nb_locations + c;
-														matval[f] = get_roomroompath(c, d, p);
-														++f;
+															// w_lc
+															matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
+															matval[f] = get_roomroompath(c, d, p);
+															++f;
 
-														// w_md
-														matind[f] = m * nb_locations + d;
-														matval[f] = get_roomroompath(c, d, p);
-														++f;
+															// w_md
+															matind[f] = layout_subproblem.index(variable_family::w_lc, m, d);
+															matval[f] = get_roomroompath(c, d, p);
+															++f;
 
-														// U_tsp
-														matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-														matval[f] = -1;
-														++f;
+															// U_tsp
+															matind[f] = layout_subproblem.index(variable_family::U_travel_tsp, t, s, p);
+															matval[f] = -1;
+															++f;
 
 
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+															subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 														}
 													}
 												}
@@ -1204,7 +1492,7 @@ namespace alg
 										f = 0;
 
 										// w_lc
-										matind[f] = l * nb_locations + c;
+										matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -1218,7 +1506,7 @@ namespace alg
 													if (get_sessionlocationpossible(m, d))
 													{
 														// x_m,t+1,d
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout_subproblem.index(variable_family::w_lc, m, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -1227,16 +1515,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = layout_subproblem.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -1273,7 +1556,7 @@ namespace alg
 										f = 0;
 
 										// w_lc
-										matind[f] = l * nb_locations + c;
+										matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -1286,7 +1569,7 @@ namespace alg
 												{
 													if (get_sessionlocationpossible(m, d))
 													{
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout_subproblem.index(variable_family::w_lc, m, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -1295,16 +1578,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = layout_subproblem.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -1332,17 +1610,12 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout_subproblem.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij);;
 						++f;
 					}
 				}
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1365,7 +1638,7 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout_subproblem.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
 						if (arc_stairs[ij])
 							matval[f] *= speed_correction_stairs;
@@ -1374,16 +1647,11 @@ namespace alg
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+				matind[f] = layout_subproblem.index(variable_family::T_travel_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1422,34 +1690,29 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 														matval[f] = Big_M;
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout_subproblem.index(variable_family::w_lc, m, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = layout_subproblem.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = -get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout_subproblem.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = 1;
 														++f;
 
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 													}
 												}
 											}
@@ -1498,34 +1761,29 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 														matval[f] = Big_M;
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = layout_subproblem.index(variable_family::w_lc, m, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = layout_subproblem.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = layout_subproblem.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = -1;
 														++f;
 
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 													}
 												}
@@ -1557,29 +1815,22 @@ namespace alg
 					f = 0;
 
 					// T(travel)_tsp
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+					matind[f] = layout_subproblem.index(variable_family::T_travel_total_tsp, t, s, p);
 					matval[f] = 1;
 					++f;
 
 					// T(travel)_t,max
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + t;
+					matind[f] = layout_subproblem.index(variable_family::T_travel_max_t, t);
 					matval[f] = -1;
 					++f;
 
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
+					subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 				}
 			}
 		}
 
 
 		// EVACUATIONS
-		const int nb_variables_first_part = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + nb_timeslots;
-
 		// Constraint set 13: U_tlp constraints 
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
@@ -1605,22 +1856,17 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 									matval[f] = get_roomroompath(c, nb_locations, p);
 									++f;
 
 									// U_tlp
-									matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = layout_subproblem.index(variable_family::U_evac_tlp, t, l, p);
 									matval[f] = -1;
 									++f;
 
 
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -1647,18 +1893,16 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij);
-						++f;
+						if (layout_subproblem.exists(variable_family::U_evac_tlp, t, l, p))
+						{
+							matind[f] = layout_subproblem.index(variable_family::U_evac_tlp, t, l, p);
+							matval[f] = -session_nb_people[l] * get_patharc(p, ij);
+							++f;
+						}
 					}
 				}
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1681,25 +1925,23 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
-						if (arc_stairs[ij])
-							matval[f] *= speed_correction_stairs;
-						++f;
+						if (layout_subproblem.exists(variable_family::U_evac_tlp, t, l, p))
+						{
+							matind[f] = layout_subproblem.index(variable_family::U_evac_tlp, t, l, p);
+							matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
+							if (arc_stairs[ij])
+								matval[f] *= speed_correction_stairs;
+							++f;
+						}
 					}
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+				matind[f] = layout_subproblem.index(variable_family::T_evac_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -1728,29 +1970,24 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 									matval[f] = Big_M;
 									++f;
 
 									// sum of T_arc_t,ij
 									for (int ij = 0; ij < nb_arcs; ++ij)
 									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+										matind[f] = layout_subproblem.index(variable_family::T_evac_arc_tij, t, ij);
 										matval[f] = -get_patharc(p, ij);
 										++f;
 									}
 
 									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = layout_subproblem.index(variable_family::T_evac_total_tlp, t, l, p);
 									matval[f] = 1;
 									++f;
 
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -1784,29 +2021,24 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = layout_subproblem.index(variable_family::w_lc, l, c);
 									matval[f] = Big_M;
 									++f;
 
 									// sum of T_arc_t,ij
 									for (int ij = 0; ij < nb_arcs; ++ij)
 									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+										matind[f] = layout_subproblem.index(variable_family::T_evac_arc_tij, t, ij);
 										matval[f] = get_patharc(p, ij);
 										++f;
 									}
 
 									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = layout_subproblem.index(variable_family::T_evac_total_tlp, t, l, p);
 									matval[f] = -1;
 									++f;
 
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -1822,30 +2054,28 @@ namespace alg
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					sense[0] = 'L';
-					rhs[0] = 0;
+					if (layout_subproblem.exists(variable_family::T_evac_total_tlp, t, l, p))
+					{
+						sense[0] = 'L';
+						rhs[0] = 0;
 
-					std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-					rowname[0] = const_cast<char*>(name.c_str());
+						std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
+						rowname[0] = const_cast<char*>(name.c_str());
 
-					matbeg[0] = 0;
-					f = 0;
+						matbeg[0] = 0;
+						f = 0;
 
-					// T(evac)_tlp
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-					matval[f] = 1;
-					++f;
+						// T(evac)_tlp
+						matind[f] = layout_subproblem.index(variable_family::T_evac_total_tlp, t, l, p);
+						matval[f] = 1;
+						++f;
 
-					// T(travel)_t,max
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t;
-					matval[f] = -1;
-					++f;
+						// T(travel)_t,max
+						matind[f] = layout_subproblem.index(variable_family::T_evac_max_t, t);
+						matval[f] = -1;
+						++f;
 
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+						subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -1872,21 +2102,16 @@ namespace alg
 						f = 0;
 
 						// T(total)_tsp variable
-						matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = layout_subproblem.index(variable_family::T_travel_total_tsp, t, s, p);
 						matval[f] = -1;
 						++f;
 
 						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, subproblem) - 2;
+						matind[f] = layout_subproblem.index(variable_family::T_travel_max_overall);
 						matval[f] = 1;
 						++f;
 
-						status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -1901,30 +2126,28 @@ namespace alg
 				{
 					for (int p = 0; p < nb_paths; ++p)
 					{
-						sense[0] = 'G';
-						rhs[0] = 0;
+						if (layout_subproblem.exists(variable_family::T_evac_total_tlp, t, l, p))
+						{
+							sense[0] = 'G';
+							rhs[0] = 0;
 
-						std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-						rowname[0] = const_cast<char*>(name.c_str());
+							std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
+							rowname[0] = const_cast<char*>(name.c_str());
 
-						matbeg[0] = 0;
-						f = 0;
+							matbeg[0] = 0;
+							f = 0;
 
-						// T(total)_tsp variable
-						matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -1;
-						++f;
+							// T(total)_tsp variable
+							matind[f] = layout_subproblem.index(variable_family::T_evac_total_tlp, t, l, p);
+							matval[f] = -1;
+							++f;
 
-						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, subproblem) - 1;
-						matval[f] = 1;
-						++f;
+							// Theta (Tmax) variable
+							matind[f] = layout_subproblem.index(variable_family::T_evac_max_overall);
+							matval[f] = 1;
+							++f;
 
-						status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+							subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 						}
 					}
 				}
@@ -1933,105 +2156,72 @@ namespace alg
 
 
 		// Write to file
-		status = CPXwriteprob(env, subproblem, "MIP_model_second_stage.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nFailed to write the subproblem to a file. \nReason: " + std::string(error_text));
-		}
+		subproblem->write("MIP_model_second_stage.lp");
+
+#ifdef ALG_USE_CPLEX
+		// Store the model in the cache
+		if (!cache_key.empty())
+			cplex_subproblem->write_cached_model(layout_subproblem, _model_cache_directory, cache_key);
+#endif // ALG_USE_CPLEX
+
+		finish_build_subproblem();
+	}
+
+
+	void MIP_two_stage::finish_build_subproblem()
+	{
+		// Travel constraints in a lazy constraint callback
+		if (lazy_travel_constraints_enabled())
+			enable_lazy_travel_constraints();
+
+		// MIP start
+		add_mip_start_subproblem(*subproblem, layout_subproblem, 0, nb_timeslots - 1);
+
 
 		// Get model info
-		nb_variables_firststage = CPXgetnumcols(env, masterproblem);
-		nb_constraints_firststage = CPXgetnumrows(env, masterproblem);
+		nb_variables_secondstage = subproblem->get_nb_columns();
+		nb_constraints_secondstage = subproblem->get_nb_rows();
 	}
 
 
 	void MIP_two_stage::solve_subproblem()
 	{
-		int status = 0;
-		int solstat;
-		std::unique_ptr<double[]> solution_CPLEX = std::make_unique<double[]>(CPXgetnumcols(env, subproblem));
+		std::vector<double> solution_values;
 
 
 		// Optimize the problem
-		std::cout << "\n\nCPLEX is solving the second stage MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		status = CPXmipopt(env, subproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
+		std::cout << "\n\nThe solver is solving the second stage MIP for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
+		progress_traces.push_back(mip_solve_trace());
+		progress_traces.back().name = "second_stage";
+		subproblem->set_progress_trace(&progress_traces.back());
+		const mip_status status = subproblem->solve();
+		subproblem->set_progress_trace(nullptr);
+
+		// Check the solution status
+		solution_secondstage_exists = mip_status_has_solution(status);
+		solution_info_secondstage = mip_status_description(status);
 
 		// Get the solution
-		status = CPXsolution(env, subproblem, &solstat, &objective_value_secondstage, solution_CPLEX.get(), NULL, NULL, NULL);
-		if (status != 0)
+		if (solution_secondstage_exists)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXsolution failed. \nReason: " + std::string(error_text));
-		}
-
-
-		// Check the solution status
-		if (solstat == CPXMIP_OPTIMAL) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Optimal solution found";
-		}
-		else if (solstat == CPXMIP_OPTIMAL_TOL) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Solution found within tolerance limit";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_FEAS) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_FEAS) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Tree memory limit exceeded";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_UNBOUNDED) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is unbounded";
-		}
-		else if (solstat == CPXMIP_INForUNBD) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible or unbounded";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_INFEAS) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_INFEAS) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Tree memory limit exceeded";
-		}
-		else {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Other reason for failure";
+			objective_value_secondstage = subproblem->get_objective_value();
+			subproblem->get_solution(solution_values);
 		}
 
-		std::cout << "\nCPLEX has finished: " << solution_info_secondstage << "\n";
+		std::cout << "\nThe solver has finished: " << solution_info_secondstage << "\n";
 
 
 		if (solution_secondstage_exists)
 		{
-			// 1. solution: assignment of lectures to rooms
-			solution_lecture_room.reserve(nb_sessions*nb_locations);
+			// 1. solution: assignment of lectures to rooms (replaces the rooms of the first stage or of a previous solve)
+			solution_lecture_room.assign(nb_sessions, -1);
 			for (int l = 0; l < nb_sessions; ++l)
 			{
-				solution_lecture_room.push_back(-1);
 				for (int r = 0; r < nb_locations; ++r)
 				{
-					if (solution_CPLEX[l*nb_locations + r] > 0.99)
+					if (layout_subproblem.exists(variable_family::w_lc, l, r) && solution_values[layout_subproblem.index(variable_family::w_lc, l, r)] > 0.99)
 					{
-						solution_lecture_room.back() = r;
+						solution_lecture_room.at(l) = r;
 						break;
 					}
 				}
@@ -2039,23 +2229,22 @@ namespace alg
 
 			// 2. travel times
 			{
-				const int index_travels = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths;
+				solution_travel_times.clear();
 				solution_travel_times.reserve(nb_timeslots);
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					double time = solution_CPLEX[index_travels + t];
+					double time = solution_values[layout_subproblem.index(variable_family::T_travel_max_t, t)];
 					solution_travel_times.push_back(time);
 				}
 			}
 
 			// 3. evacuation times
 			{
-				const int index_evacs = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-					+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
+				solution_evacuation_times.clear();
 				solution_evacuation_times.reserve(nb_timeslots);
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					double time = solution_CPLEX[index_evacs + t];
+					double time = solution_values[layout_subproblem.index(variable_family::T_evac_max_t, t)];
 					solution_evacuation_times.push_back(time);
 				}
 			}
@@ -2063,10 +2252,9 @@ namespace alg
 	}
 
 
-	void MIP_two_stage::build_subproblem(int day, int afternoon)
+	void MIP_two_stage::build_subproblem_part(subproblem_part& part)
 	{
 		constexpr int Big_M = 10000;
-		int status = 0;
 		double obj[1];					// Objective function
 		double lb[1];					// Lower bound variables
 		double ub[1];					// Upper bound variables
@@ -2081,61 +2269,24 @@ namespace alg
 		int f{ 0 };						// To calculate number of nonzero coefficients in each constraint
 
 										// create arrays
-		matind = std::make_unique<int[]>(10000000);
-		matval = std::make_unique<double[]>(10000000);
-
-
-		// for which timeslots does this decomposed problem need to be constructed
-		int first_timeslot, last_timeslot;
-
-		if (nb_timeslots_per_day == 5)
-		{
-			first_timeslot = day * nb_timeslots_per_day + afternoon * 2;
-			last_timeslot = day * nb_timeslots_per_day + 1 + afternoon * 3;
-		}
-		else if (nb_timeslots_per_day == 6)
-		{
-			first_timeslot = day * nb_timeslots_per_day + afternoon * 2;
-			last_timeslot = day * nb_timeslots_per_day + 1 + afternoon * 4;
-		}
-		else if (nb_timeslots_per_day == 9)
-		{
-			first_timeslot = day * nb_timeslots_per_day + afternoon * 3;
-			last_timeslot = day * nb_timeslots_per_day + 2 + afternoon * 6;
-		}
-		else
-		{
-			first_timeslot = 0;
-			last_timeslot = nb_timeslots - 1;
-		}
+		const int max_row_length = max_row_length_flows();
+		matind = std::make_unique<int[]>(max_row_length);
+		matval = std::make_unique<double[]>(max_row_length);
 
 
-		// First delete previous problem and then create the new problem
-		status = CPXfreeprob(env, &subproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_subproblem(). \nCouldn't free the previous subproblem. \nReason: " + std::string(error_text));
-		}
+		// the timeslots covered by this decomposed part
+		const int first_timeslot = part.first_timeslot;
+		const int last_timeslot = part.last_timeslot;
 
-		subproblem = CPXcreateprob(env, &status, "subproblem");
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_subproblem(). \nCouldn't create the CPLEX problem. \nReason: " + std::string(error_text));
-		}
 
-		// Problem is minimization
-		CPXchgobjsen(env, subproblem, CPX_MIN);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_subproblem(). \nCouldn't set the problem type to minimization. \nReason: " + std::string(error_text));
-		}
+		// VARIABLES (in the problem that the worker has created for this part)
+		part.layout.clear();
 
+		// paths that lead from a possible room of each session to the outside
+		const std::vector<bool> session_evacuation_paths = compute_session_evacuation_paths();
 
-		// VARIABLES
 		// Add the W_lc variables
+		part.layout.add_family(variable_family::w_lc, nb_sessions, nb_locations);
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int c = 0; c < nb_locations; ++c)
@@ -2149,16 +2300,13 @@ namespace alg
 				ub[0] = 1;
 				type[0] = 'B';
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.layout.add_column(variable_family::w_lc, l, c);
+				part.problem->add_columns(1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the U(travel)_tsp variables
+		part.layout.add_family(variable_family::U_travel_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -2171,17 +2319,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					part.layout.add_column(variable_family::U_travel_tsp, t, s, p);
+					part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel_arc)_tij variables
+		part.layout.add_family(variable_family::T_travel_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -2192,16 +2337,13 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.layout.add_column(variable_family::T_travel_arc_tij, t, ij);
+				part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(travel)_tsp variables
+		part.layout.add_family(variable_family::T_travel_total_tsp, nb_timeslots, nb_series, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int s = 0; s < nb_series; ++s)
@@ -2214,17 +2356,14 @@ namespace alg
 					obj[0] = 0;
 					lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					part.layout.add_column(variable_family::T_travel_total_tsp, t, s, p);
+					part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 				}
 			}
 		}
 
 		// Add the T(travel)_t,max variables
+		part.layout.add_family(variable_family::T_travel_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_travel_max_" + std::to_string(t + 1);
@@ -2236,38 +2375,35 @@ namespace alg
 				obj[0] = (1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			part.layout.add_column(variable_family::T_travel_max_t, t);
+			part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the U(evac)_tlp variables
+		part.layout.add_family(variable_family::U_evac_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
+					if (t >= first_timeslot && t <= last_timeslot && solution_lecture_timeslot[l] == t && session_evacuation_paths[l * nb_paths + p])
+					{
+						std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
+						colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = 0;
-					lb[0] = 0;
+						obj[0] = 0;
+						lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						part.layout.add_column(variable_family::U_evac_tlp, t, l, p);
+						part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 					}
 				}
 			}
 		}
 
 		// Add the T(evac_arc)_tij variables
+		part.layout.add_family(variable_family::T_evac_arc_tij, nb_timeslots, nb_arcs);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int ij = 0; ij < nb_arcs; ++ij)
@@ -2278,39 +2414,36 @@ namespace alg
 				obj[0] = 0;
 				lb[0] = 0;
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.layout.add_column(variable_family::T_evac_arc_tij, t, ij);
+				part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 			}
 		}
 
 		// Add the T(evac)_tlp variables
+		part.layout.add_family(variable_family::T_evac_total_tlp, nb_timeslots, nb_sessions, nb_paths);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			for (int l = 0; l < nb_sessions; ++l)
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
+					if (t >= first_timeslot && t <= last_timeslot && solution_lecture_timeslot[l] == t && session_evacuation_paths[l * nb_paths + p])
+					{
+						std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
+						colname[0] = const_cast<char*>(name.c_str());
 
-					obj[0] = 0;
-					lb[0] = 0;
+						obj[0] = 0;
+						lb[0] = 0;
 
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						part.layout.add_column(variable_family::T_evac_total_tlp, t, l, p);
+						part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 					}
 				}
 			}
 		}
 
 		// Add the T(evac)_t,max variables
+		part.layout.add_family(variable_family::T_evac_max_t, nb_timeslots);
 		for (int t = 0; t < nb_timeslots; ++t)
 		{
 			std::string name = "T_evac_max_" + std::to_string(t + 1);
@@ -2322,15 +2455,12 @@ namespace alg
 				obj[0] = _alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			part.layout.add_column(variable_family::T_evac_max_t, t);
+			part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(travel)_max_overall variable
+		part.layout.add_family(variable_family::T_travel_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_travel_max_overall";
@@ -2339,15 +2469,12 @@ namespace alg
 			obj[0] = (1 - _alpha);
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			part.layout.add_column(variable_family::T_travel_max_overall);
+			part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 		// Add the T(evac)_max_overall variable
+		part.layout.add_family(variable_family::T_evac_max_overall);
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
 			std::string name = "T_evac_max_overall";
@@ -2356,12 +2483,8 @@ namespace alg
 			obj[0] = _alpha;
 			lb[0] = 0;
 
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
+			part.layout.add_column(variable_family::T_evac_max_overall);
+			part.problem->add_columns(1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
 		}
 
 
@@ -2387,18 +2510,13 @@ namespace alg
 					{
 						if (get_sessionlocationpossible(l, c))
 						{
-							matind[f] = l * nb_locations + c;
+							matind[f] = part.layout.index(variable_family::w_lc, l, c);
 							matval[f] = 1;
 							++f;
 						}
 					}
 
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
+					part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 				}
 			}
 		}
@@ -2423,16 +2541,11 @@ namespace alg
 							matbeg[0] = 0;
 							f = 0;
 
-							matind[f] = l * nb_locations + c;
+							matind[f] = part.layout.index(variable_family::w_lc, l, c);
 							matval[f] = 1;
 							++f;
 
-							status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function Two_Stage_Model::build_subproblem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-							}
+							part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 						}
 					}
 				}
@@ -2458,18 +2571,13 @@ namespace alg
 				{
 					if (get_sessionlocationpossible(l, c) && solution_lecture_timeslot[l] == t)
 					{
-						matind[f] = l * nb_locations + c;
+						matind[f] = part.layout.index(variable_family::w_lc, l, c);
 						matval[f] = 1;
 						++f;
 					}
 				}
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -2510,27 +2618,22 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = part.layout.index(variable_family::w_lc, l, c);
 														matval[f] = get_roomroompath(c, d, p);
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = part.layout.index(variable_family::w_lc, m, d);
 														matval[f] = get_roomroompath(c, d, p);
 														++f;
 
 														// U_tsp
-														matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = part.layout.index(variable_family::U_travel_tsp, t, s, p);
 														matval[f] = -1;
 														++f;
 
 
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 													}
 												}
 											}
@@ -2571,7 +2674,7 @@ namespace alg
 										f = 0;
 
 										// w_lc
-										matind[f] = l * nb_locations + c;
+										matind[f] = part.layout.index(variable_family::w_lc, l, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -2585,7 +2688,7 @@ namespace alg
 													if (get_sessionlocationpossible(m, d))
 													{
 														// x_m,t+1,d
-														matind[f] = m * nb_locations + d;
+														matind[f] = part.layout.index(variable_family::w_lc, m, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -2594,16 +2697,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = part.layout.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -2640,7 +2738,7 @@ namespace alg
 										f = 0;
 
 										// w_lc
-										matind[f] = l * nb_locations + c;
+										matind[f] = part.layout.index(variable_family::w_lc, l, c);
 										matval[f] = get_roomroompath(c, nb_locations, p);
 										++f;
 
@@ -2653,7 +2751,7 @@ namespace alg
 												{
 													if (get_sessionlocationpossible(m, d))
 													{
-														matind[f] = m * nb_locations + d;
+														matind[f] = part.layout.index(variable_family::w_lc, m, d);
 														matval[f] = -get_roomroompath(c, nb_locations, p);
 														++f;
 													}
@@ -2662,16 +2760,11 @@ namespace alg
 										}
 
 										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+										matind[f] = part.layout.index(variable_family::U_travel_tsp, t, s, p);
 										matval[f] = -1;
 										++f;
 
-										status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
+										part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 									}
 								}
 							}
@@ -2699,17 +2792,12 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = part.layout.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij);;
 						++f;
 					}
 				}
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -2732,7 +2820,7 @@ namespace alg
 				{
 					for (int s = 0; s < nb_series; ++s)
 					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = part.layout.index(variable_family::U_travel_tsp, t, s, p);
 						matval[f] = -series_nb_people[s] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
 						if (arc_stairs[ij])
 							matval[f] *= speed_correction_stairs;
@@ -2741,16 +2829,11 @@ namespace alg
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+				matind[f] = part.layout.index(variable_family::T_travel_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -2789,34 +2872,29 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = part.layout.index(variable_family::w_lc, l, c);
 														matval[f] = Big_M;
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = part.layout.index(variable_family::w_lc, m, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = part.layout.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = -get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = part.layout.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = 1;
 														++f;
 
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 													}
 												}
 											}
@@ -2865,34 +2943,29 @@ namespace alg
 														f = 0;
 
 														// w_lc
-														matind[f] = l * nb_locations + c;
+														matind[f] = part.layout.index(variable_family::w_lc, l, c);
 														matval[f] = Big_M;
 														++f;
 
 														// w_md
-														matind[f] = m * nb_locations + d;
+														matind[f] = part.layout.index(variable_family::w_lc, m, d);
 														matval[f] = Big_M;
 														++f;
 
 														// sum of T_arc_t,ij
 														for (int ij = 0; ij < nb_arcs; ++ij)
 														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
+															matind[f] = part.layout.index(variable_family::T_travel_arc_tij, t, ij);
 															matval[f] = get_patharc(p, ij);
 															++f;
 														}
 
 														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+														matind[f] = part.layout.index(variable_family::T_travel_total_tsp, t, s, p);
 														matval[f] = -1;
 														++f;
 
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
+														part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 													}
 												}
@@ -2924,29 +2997,22 @@ namespace alg
 					f = 0;
 
 					// T(travel)_tsp
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+					matind[f] = part.layout.index(variable_family::T_travel_total_tsp, t, s, p);
 					matval[f] = 1;
 					++f;
 
 					// T(travel)_t,max
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + t;
+					matind[f] = part.layout.index(variable_family::T_travel_max_t, t);
 					matval[f] = -1;
 					++f;
 
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
+					part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 				}
 			}
 		}
 
 
 		// EVACUATIONS
-		const int nb_variables_first_part = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + nb_timeslots;
-
 		// Constraint set 13: U_tlp constraints 
 		for (int t = first_timeslot; t <= last_timeslot; ++t)
 		{
@@ -2972,22 +3038,17 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = part.layout.index(variable_family::w_lc, l, c);
 									matval[f] = get_roomroompath(c, nb_locations, p);
 									++f;
 
 									// U_tlp
-									matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = part.layout.index(variable_family::U_evac_tlp, t, l, p);
 									matval[f] = -1;
 									++f;
 
 
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -3014,18 +3075,16 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij);
-						++f;
+						if (part.layout.exists(variable_family::U_evac_tlp, t, l, p))
+						{
+							matind[f] = part.layout.index(variable_family::U_evac_tlp, t, l, p);
+							matval[f] = -session_nb_people[l] * get_patharc(p, ij);
+							++f;
+						}
 					}
 				}
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -3048,25 +3107,23 @@ namespace alg
 				{
 					for (int l = 0; l < nb_sessions; ++l)
 					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
-						if (arc_stairs[ij])
-							matval[f] *= speed_correction_stairs;
-						++f;
+						if (part.layout.exists(variable_family::U_evac_tlp, t, l, p))
+						{
+							matind[f] = part.layout.index(variable_family::U_evac_tlp, t, l, p);
+							matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
+							if (arc_stairs[ij])
+								matval[f] *= speed_correction_stairs;
+							++f;
+						}
 					}
 				}
 
 				// T(arc)_tij variable
-				matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+				matind[f] = part.layout.index(variable_family::T_evac_arc_tij, t, ij);
 				matval[f] = 1;
 				++f;
 
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
+				part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 			}
 		}
 
@@ -3095,29 +3152,24 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = part.layout.index(variable_family::w_lc, l, c);
 									matval[f] = Big_M;
 									++f;
 
 									// sum of T_arc_t,ij
 									for (int ij = 0; ij < nb_arcs; ++ij)
 									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+										matind[f] = part.layout.index(variable_family::T_evac_arc_tij, t, ij);
 										matval[f] = -get_patharc(p, ij);
 										++f;
 									}
 
 									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = part.layout.index(variable_family::T_evac_total_tlp, t, l, p);
 									matval[f] = 1;
 									++f;
 
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -3151,29 +3203,24 @@ namespace alg
 									f = 0;
 
 									// w_lc
-									matind[f] = l * nb_locations + c;
+									matind[f] = part.layout.index(variable_family::w_lc, l, c);
 									matval[f] = Big_M;
 									++f;
 
 									// sum of T_arc_t,ij
 									for (int ij = 0; ij < nb_arcs; ++ij)
 									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
+										matind[f] = part.layout.index(variable_family::T_evac_arc_tij, t, ij);
 										matval[f] = get_patharc(p, ij);
 										++f;
 									}
 
 									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
+									matind[f] = part.layout.index(variable_family::T_evac_total_tlp, t, l, p);
 									matval[f] = -1;
 									++f;
 
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
+									part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 								}
 							}
 						}
@@ -3189,30 +3236,28 @@ namespace alg
 			{
 				for (int p = 0; p < nb_paths; ++p)
 				{
-					sense[0] = 'L';
-					rhs[0] = 0;
+					if (part.layout.exists(variable_family::T_evac_total_tlp, t, l, p))
+					{
+						sense[0] = 'L';
+						rhs[0] = 0;
 
-					std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-					rowname[0] = const_cast<char*>(name.c_str());
+						std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
+						rowname[0] = const_cast<char*>(name.c_str());
 
-					matbeg[0] = 0;
-					f = 0;
+						matbeg[0] = 0;
+						f = 0;
 
-					// T(evac)_tlp
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-					matval[f] = 1;
-					++f;
+						// T(evac)_tlp
+						matind[f] = part.layout.index(variable_family::T_evac_total_tlp, t, l, p);
+						matval[f] = 1;
+						++f;
 
-					// T(travel)_t,max
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t;
-					matval[f] = -1;
-					++f;
+						// T(travel)_t,max
+						matind[f] = part.layout.index(variable_family::T_evac_max_t, t);
+						matval[f] = -1;
+						++f;
 
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+						part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -3239,21 +3284,16 @@ namespace alg
 						f = 0;
 
 						// T(total)_tsp variable
-						matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
+						matind[f] = part.layout.index(variable_family::T_travel_total_tsp, t, s, p);
 						matval[f] = -1;
 						++f;
 
 						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, subproblem) - 2;
+						matind[f] = part.layout.index(variable_family::T_travel_max_overall);
 						matval[f] = 1;
 						++f;
 
-						status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
+						part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 					}
 				}
 			}
@@ -3268,30 +3308,28 @@ namespace alg
 				{
 					for (int p = 0; p < nb_paths; ++p)
 					{
-						sense[0] = 'G';
-						rhs[0] = 0;
+						if (part.layout.exists(variable_family::T_evac_total_tlp, t, l, p))
+						{
+							sense[0] = 'G';
+							rhs[0] = 0;
 
-						std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-						rowname[0] = const_cast<char*>(name.c_str());
+							std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
+							rowname[0] = const_cast<char*>(name.c_str());
 
-						matbeg[0] = 0;
-						f = 0;
+							matbeg[0] = 0;
+							f = 0;
 
-						// T(total)_tsp variable
-						matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -1;
-						++f;
+							// T(total)_tsp variable
+							matind[f] = part.layout.index(variable_family::T_evac_total_tlp, t, l, p);
+							matval[f] = -1;
+							++f;
 
-						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, subproblem) - 1;
-						matval[f] = 1;
-						++f;
+							// Theta (Tmax) variable
+							matind[f] = part.layout.index(variable_family::T_evac_max_overall);
+							matval[f] = 1;
+							++f;
 
-						status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+							part.problem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 						}
 					}
 				}
@@ -3299,1570 +3337,343 @@ namespace alg
 		}
 
 
-		// Write to file
-		status = CPXwriteprob(env, subproblem, "MIP_model_second_stage.lp", NULL);
-		/*if (status != 0)
-		{
-		CPXgeterrorstring(env, status, error_text);
-		throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nFailed to write the subproblem to a file. \nReason: " + std::string(error_text));
-		}*/
+		// MIP start
+		add_mip_start_subproblem(*part.problem, part.layout, first_timeslot, last_timeslot);
 
 
 		// Get model info
-		nb_variables_firststage = CPXgetnumcols(env, masterproblem);
-		nb_constraints_firststage = CPXgetnumrows(env, masterproblem);
+		part.nb_variables = part.problem->get_nb_columns();
+		part.nb_constraints = part.problem->get_nb_rows();
 	}
 
 
-	void MIP_two_stage::solve_subproblem(int day, int afternoon)
+	void MIP_two_stage::solve_subproblem_part(subproblem_part& part)
 	{
-		int status = 0;
-		int solstat;
-		std::unique_ptr<double[]> solution_CPLEX = std::make_unique<double[]>(CPXgetnumcols(env, subproblem));
+		std::vector<double> solution_values;
 
 
 		// Optimize the problem
-		if (afternoon == 0)
-			std::cout << "\n\nCPLEX is solving the second stage MIP, for day " << day + 1 << " morning, for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		else
-			std::cout << "\n\nCPLEX is solving the second stage MIP, for day " << day + 1 << " afternoon, for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		status = CPXmipopt(env, subproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
-
-		// Get the solution
-		status = CPXsolution(env, subproblem, &solstat, &objective_value_secondstage, solution_CPLEX.get(), NULL, NULL, NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXsolution failed. \nReason: " + std::string(error_text));
-		}
-
+		std::string output_text = "\n\nThe solver is solving the second stage MIP, for " + part.description + ", for instance " + instance_name_timetable + " + " + instance_name_building + " ... ";
+		std::cout << output_text;
+		part.progress_trace.name = "second_stage " + part.description;
+		part.problem->set_progress_trace(&part.progress_trace);
+		const mip_status status = part.problem->solve();
+		part.problem->set_progress_trace(nullptr);
 
 		// Check the solution status
-		if (solstat == CPXMIP_OPTIMAL) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Optimal solution found";
-		}
-		else if (solstat == CPXMIP_OPTIMAL_TOL) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Solution found within tolerance limit";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_FEAS) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_FEAS) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Tree memory limit exceeded";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_UNBOUNDED) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is unbounded";
-		}
-		else if (solstat == CPXMIP_INForUNBD) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible or unbounded";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_INFEAS) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_INFEAS) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Tree memory limit exceeded";
-		}
-		else {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Other reason for failure";
-		}
+		part.solution_exists = mip_status_has_solution(status);
+		part.solution_info = mip_status_description(status);
+		part.proven_infeasible = (status == mip_status::infeasible);
 
-		std::cout << "\nCPLEX has finished: " << solution_info_secondstage << "\n";
+		// Get the solution
+		if (part.solution_exists)
+			part.problem->get_solution(solution_values);
 
+		output_text = "\nThe solver has finished the second stage MIP, for " + part.description + ": " + part.solution_info + "\n";
+		std::cout << output_text;
 
-		if (solution_secondstage_exists)
+
+		if (part.solution_exists)
 		{
-			// for which timeslots does this decomposed problem need to be constructed
-			int first_timeslot, last_timeslot;
+			// 0. best bound: only this is a valid lower bound when the solve stopped at a limit or within the tolerance
+			part.objective_bound = part.problem->get_best_bound();
 
-			if (nb_timeslots_per_day == 5)
-			{
-				first_timeslot = day * nb_timeslots_per_day + afternoon * 2;
-				last_timeslot = day * nb_timeslots_per_day + 1 + afternoon * 3;
-			}
-			else if (nb_timeslots_per_day == 6)
-			{
-				first_timeslot = day * nb_timeslots_per_day + afternoon * 2;
-				last_timeslot = day * nb_timeslots_per_day + 1 + afternoon * 4;
-			}
-			else if (nb_timeslots_per_day == 9)
-			{
-				first_timeslot = day * nb_timeslots_per_day + afternoon * 3;
-				last_timeslot = day * nb_timeslots_per_day + 2 + afternoon * 6;
-			}
-			else
+			// 1. solution: assignment of the lectures of this part to rooms
+			part.lecture_room.assign(nb_sessions, -1);
+			for (int l = 0; l < nb_sessions; ++l)
 			{
-				first_timeslot = 0;
-				last_timeslot = nb_timeslots - 1;
+				if (solution_lecture_timeslot[l] >= part.first_timeslot && solution_lecture_timeslot[l] <= part.last_timeslot)
+				{
+					for (int r = 0; r < nb_locations; ++r)
+					{
+						if (solution_values[part.layout.index(variable_family::w_lc, l, r)] > 0.99)
+						{
+							part.lecture_room[l] = r;
+							break;
+						}
+					}
+				}
 			}
 
-			// 1. travel times
+			// 2. travel times
 			{
-				const int index_travels = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths;
-				solution_travel_times.reserve(last_timeslot - first_timeslot);
-				for (int t = first_timeslot; t < last_timeslot; ++t)
+				part.travel_times.reserve(part.last_timeslot - part.first_timeslot);
+				for (int t = part.first_timeslot; t < part.last_timeslot; ++t)
 				{
-					double time = solution_CPLEX[index_travels + t];
-					solution_travel_times.push_back(time);
+					double time = solution_values[part.layout.index(variable_family::T_travel_max_t, t)];
+					part.travel_times.push_back(time);
 				}
 			}
 
-			// 2. evacuation times
+			// 3. evacuation times
 			{
-				const int index_evacs = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-					+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
-				solution_evacuation_times.reserve(last_timeslot - first_timeslot + 1);
-				for (int t = first_timeslot; t <= last_timeslot; ++t)
+				part.evacuation_times.reserve(part.last_timeslot - part.first_timeslot + 1);
+				for (int t = part.first_timeslot; t <= part.last_timeslot; ++t)
 				{
-					double time = solution_CPLEX[index_evacs + t];
-					solution_evacuation_times.push_back(time);
+					double time = solution_values[part.layout.index(variable_family::T_evac_max_t, t)];
+					part.evacuation_times.push_back(time);
 				}
 			}
 		}
 	}
 
 
-	void MIP_two_stage::build_subproblem(int timeslot)
+	void MIP_two_stage::clear_subproblem_part(subproblem_part& part)
 	{
-		constexpr int Big_M = 10000;
-		int status = 0;
-		double obj[1];					// Objective function
-		double lb[1];					// Lower bound variables
-		double ub[1];					// Upper bound variables
-		double rhs[1];					// Right-hand side constraints
-		char *colname[1];				// Variable names
-		char *rowname[1];				// Constraint names
-		char sense[1];					// Sign of constraint
-		int matbeg[1];					// Begin position of the constraint
-		std::unique_ptr<int[]> matind;		// Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval;	// Value of each element in constraint matrix
-		char type[1];					// Type of variable (integer, binary, fractional)
-		int f{ 0 };						// To calculate number of nonzero coefficients in each constraint
-
-										// create arrays
-		matind = std::make_unique<int[]>(10000000);
-		matval = std::make_unique<double[]>(10000000);
+		// Free the problem of this part
+		part.problem.reset();
+	}
 
 
-		// for which timeslots does this decomposed problem need to be constructed
-		int first_timeslot = timeslot, last_timeslot = timeslot;
+	void MIP_two_stage::solve_subproblem_parts(std::vector<subproblem_part>& parts)
+	{
+		if (parts.empty())
+			return;
 
+		// Divide the thread budget over the workers
+		int nb_threads = _nb_threads_second_stage;
+		if (nb_threads <= 0)
+			nb_threads = _resources.threads;
+		if (nb_threads <= 0)
+			nb_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		const int nb_workers = std::min(nb_threads, static_cast<int>(parts.size()));
+		const solver_resources worker_resources = share_solver_resources(_resources, nb_threads, nb_workers);
 
-		// First delete previous problem and then create the new problem
-		status = CPXfreeprob(env, &subproblem);
-		if (status != 0)
+		// Each worker takes the next unsolved part until all parts are solved
+		std::atomic<int> next_part{ 0 };
+		auto worker = [this, &parts, &next_part, &worker_resources]()
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_subproblem(). \nCouldn't free the previous subproblem. \nReason: " + std::string(error_text));
-		}
+			// The problem of a part is freed by clear_subproblem_part(), or with the parts if an exception is thrown
+			for (int i = next_part++; i < static_cast<int>(parts.size()); i = next_part++)
+			{
+				subproblem_part& part = parts.at(i);
+				part.problem = create_problem("subproblem", worker_resources);
+				build_subproblem_part(part);
+				solve_subproblem_part(part);
+				clear_subproblem_part(part);
+			}
+		};
 
-		subproblem = CPXcreateprob(env, &status, "subproblem");
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_subproblem(). \nCouldn't create the CPLEX problem. \nReason: " + std::string(error_text));
-		}
+		std::vector<std::future<void>> workers;
+		workers.reserve(nb_workers);
+		for (int w = 0; w < nb_workers; ++w)
+			workers.push_back(std::async(std::launch::async, worker));
 
-		// Problem is minimization
-		CPXchgobjsen(env, subproblem, CPX_MIN);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_subproblem(). \nCouldn't set the problem type to minimization. \nReason: " + std::string(error_text));
-		}
+		// Wait for all workers, rethrowing the first error
+		for (auto&& w : workers)
+			w.get();
 
 
-		// VARIABLES
-		// Add the W_lc variables
-		for (int l = 0; l < nb_sessions; ++l)
+		// Merge the solutions of the parts, in the order of the parts
+		solution_secondstage_exists = true;
+		solution_info_secondstage.clear();
+		solution_lecture_room.assign(nb_sessions, -1);
+		for (auto&& part : parts)
 		{
-			for (int c = 0; c < nb_locations; ++c)
-			{
-				std::string name = "w_" + std::to_string(l + 1) + "_" + std::to_string(c + 1);
-				colname[0] = const_cast<char*>(name.c_str());
-
-				obj[0] = 0;
+			nb_variables_secondstage += part.nb_variables;
+			nb_constraints_secondstage += part.nb_constraints;
+			progress_traces.push_back(part.progress_trace);
 
-				lb[0] = 0;
-				ub[0] = 1;
-				type[0] = 'B';
+			if (part.solution_exists)
+			{
+				if (solution_secondstage_exists)
+					solution_info_secondstage = part.solution_info;
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, ub, type, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
+				for (int l = 0; l < nb_sessions; ++l)
+					if (part.lecture_room[l] >= 0)
+						solution_lecture_room[l] = part.lecture_room[l];
+				solution_travel_times.insert(solution_travel_times.end(), part.travel_times.begin(), part.travel_times.end());
+				solution_evacuation_times.insert(solution_evacuation_times.end(), part.evacuation_times.begin(), part.evacuation_times.end());
+			}
+			else
+			{
+				if (solution_secondstage_exists)
+					solution_info_secondstage = part.description + ": " + part.solution_info;
+				solution_secondstage_exists = false;
 			}
 		}
+	}
 
-		// Add the U(travel)_tsp variables
-		for (int t = 0; t < nb_timeslots; ++t)
+
+
+	void MIP_two_stage::run_only_first_stage_and_evaluate_solution()
+	{
+		auto start_time = std::chrono::system_clock::now();
+
+		initialize_solver();
+
+		build_masterproblem();
+		solve_masterproblem();
+		clear_masterproblem();
+
+		computation_time_firststage = std::chrono::system_clock::now() - start_time;
+		start_time = std::chrono::system_clock::now();
+
+		build_subproblem();
+		fix_solution(solution_lecture_room);
+		solve_subproblem();
+
+		clear_solver();
+
+		computation_time_secondstage = std::chrono::system_clock::now() - start_time;
+
+		write_output();
+	}
+
+
+	void MIP_two_stage::set_mip_start(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room)
+	{
+		if (lecture_timeslot.size() != static_cast<size_t>(nb_sessions) || lecture_room.size() != static_cast<size_t>(nb_sessions))
+			throw std::runtime_error("Error in function MIP_two_stage::set_mip_start(). \nReason: The MIP start should assign a timeslot and room to every lecture.");
+
+		mip_start_lecture_timeslot = lecture_timeslot;
+		mip_start_lecture_room = lecture_room;
+	}
+
+
+	void MIP_two_stage::add_mip_start_masterproblem()
+	{
+		if (mip_start_lecture_timeslot.empty())
+			return;
+
+		add_timetable_start_masterproblem(mip_start_lecture_timeslot, mip_start_lecture_room);
+	}
+
+
+	void MIP_two_stage::add_timetable_start_masterproblem(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room)
+	{
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_timeslots * nb_locations);
+		values.reserve(nb_sessions * nb_timeslots * nb_locations);
+
+		// x_ltc variables
+		for (int l = 0; l < nb_sessions; ++l)
 		{
-			for (int s = 0; s < nb_series; ++s)
+			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				for (int p = 0; p < nb_paths; ++p)
+				for (int c = 0; c < nb_locations; ++c)
 				{
-					std::string name = "U_travel_" + std::to_string(t + 1) + "_" + std::to_string(s + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
-
-					obj[0] = 0;
-					lb[0] = 0;
-
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
+					if (layout_masterproblem.exists(variable_family::x_ltc, l, t, c))
 					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
+						columns.push_back(layout_masterproblem.index(variable_family::x_ltc, l, t, c));
+						if (lecture_timeslot.at(l) == t && lecture_room.at(l) == c)
+							values.push_back(1);
+						else
+							values.push_back(0);
 					}
 				}
 			}
 		}
 
-		// Add the T(travel_arc)_tij variables
-		for (int t = 0; t < nb_timeslots; ++t)
-		{
-			for (int ij = 0; ij < nb_arcs; ++ij)
-			{
-				std::string name = "T_travel_arc_" + std::to_string(t + 1) + "_" + std::to_string(ij + 1);
-				colname[0] = const_cast<char*>(name.c_str());
+		masterproblem->add_mip_start(columns, values, "start_solution");
+	}
 
-				obj[0] = 0;
-				lb[0] = 0;
 
-				status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
+	void MIP_two_stage::add_mip_start_subproblem(mip_backend& problem, const variable_layout& layout, int first_timeslot, int last_timeslot) const
+	{
+		// the room assignments only fit the second stage for the same timetable
+		if (mip_start_lecture_timeslot.empty() || mip_start_lecture_timeslot != solution_lecture_timeslot)
+			return;
 
-		// Add the T(travel)_tsp variables
-		for (int t = 0; t < nb_timeslots; ++t)
+		add_room_assignment_start(problem, layout, mip_start_lecture_room, first_timeslot, last_timeslot);
+	}
+
+
+	void MIP_two_stage::add_room_assignment_start(mip_backend& problem, const variable_layout& layout, const std::vector<int>& lecture_room, int first_timeslot, int last_timeslot) const
+	{
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_locations);
+		values.reserve(nb_sessions * nb_locations);
+
+		// w_lc variables, lectures outside the covered timeslots are not assigned
+		for (int l = 0; l < nb_sessions; ++l)
 		{
-			for (int s = 0; s < nb_series; ++s)
+			const bool covered = (solution_lecture_timeslot.at(l) >= first_timeslot && solution_lecture_timeslot.at(l) <= last_timeslot);
+			for (int c = 0; c < nb_locations; ++c)
 			{
-				for (int p = 0; p < nb_paths; ++p)
+				if (layout.exists(variable_family::w_lc, l, c))
 				{
-					std::string name = "T_travel_total_" + std::to_string(t + 1) + "_" + std::to_string(s + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
-
-					obj[0] = 0;
-					lb[0] = 0;
-
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
+					columns.push_back(layout.index(variable_family::w_lc, l, c));
+					if (covered && lecture_room.at(l) == c)
+						values.push_back(1);
+					else
+						values.push_back(0);
 				}
 			}
 		}
 
-		// Add the T(travel)_t,max variables
-		for (int t = 0; t < nb_timeslots; ++t)
-		{
-			std::string name = "T_travel_max_" + std::to_string(t + 1);
-			colname[0] = const_cast<char*>(name.c_str());
-
-			if (_objective_type == objective_type::maximum_over_timeslots)
-				obj[0] = 0;
-			else
-				obj[0] = (1 - _alpha);
-			lb[0] = 0;
-
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
-		}
-
-		// Add the U(evac)_tlp variables
-		for (int t = 0; t < nb_timeslots; ++t)
-		{
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					std::string name = "U_evac_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
-
-					obj[0] = 0;
-					lb[0] = 0;
-
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
-				}
-			}
-		}
-
-		// Add the T(evac_arc)_tij variables
-		for (int t = 0; t < nb_timeslots; ++t)
-		{
-			for (int ij = 0; ij < nb_arcs; ++ij)
-			{
-				std::string name = "T_evac_arc_" + std::to_string(t + 1) + "_" + std::to_string(ij + 1);
-				colname[0] = const_cast<char*>(name.c_str());
-
-				obj[0] = 0;
-				lb[0] = 0;
-
-				status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
-
-		// Add the T(evac)_tlp variables
-		for (int t = 0; t < nb_timeslots; ++t)
-		{
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					std::string name = "T_evac_total_" + std::to_string(t + 1) + "_" + std::to_string(l + 1) + "_" + std::to_string(p + 1);
-					colname[0] = const_cast<char*>(name.c_str());
-
-					obj[0] = 0;
-					lb[0] = 0;
-
-					status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-					}
-				}
-			}
-		}
-
-		// Add the T(evac)_t,max variables
-		for (int t = 0; t < nb_timeslots; ++t)
-		{
-			std::string name = "T_evac_max_" + std::to_string(t + 1);
-			colname[0] = const_cast<char*>(name.c_str());
-
-			if (_objective_type == objective_type::maximum_over_timeslots)
-				obj[0] = 0;
-			else
-				obj[0] = _alpha;
-			lb[0] = 0;
-
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
-		}
-
-		// Add the T(travel)_max_overall variable
-		if (_objective_type == objective_type::maximum_over_timeslots)
-		{
-			std::string name = "T_travel_max_overall";
-			colname[0] = const_cast<char*>(name.c_str());
-
-			obj[0] = (1 - _alpha);
-			lb[0] = 0;
-
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
-		}
-
-		// Add the T(evac)_max_overall variable
-		if (_objective_type == objective_type::maximum_over_timeslots)
-		{
-			std::string name = "T_evac_max_overall";
-			colname[0] = const_cast<char*>(name.c_str());
-
-			obj[0] = _alpha;
-			lb[0] = 0;
-
-			status = CPXnewcols(env, subproblem, 1, obj, lb, NULL, NULL, colname); // Generate columns (the variables) and subsequently add rows (constraints)
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add variable " + name + ". \nReason: " + std::string(error_text));
-			}
-		}
-
-
-		// CONSTRAINTS
-		// TIMETABLE
-		// Constraint set 1: Each Lecture should be scheduled and at an appropriate location
-		for (int l = 0; l < nb_sessions; ++l)
-		{
-			for (int t = first_timeslot; t <= last_timeslot; ++t) // only for lectures planned in this decomposed part
-			{
-				if (solution_lecture_timeslot[l] == t)
-				{
-					sense[0] = 'E';
-					rhs[0] = 1;
-
-					std::string name = "Lecture_" + std::to_string(l + 1) + "_scheduled";
-					rowname[0] = const_cast<char*>(name.c_str());
-
-					matbeg[0] = 0;
-					f = 0;
-
-					for (int c = 0; c < nb_locations; ++c)
-					{
-						if (get_sessionlocationpossible(l, c))
-						{
-							matind[f] = l * nb_locations + c;
-							matval[f] = 1;
-							++f;
-						}
-					}
-
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
-				}
-			}
-		}
-
-		// Constraint set 1bis: Lectures not included in this decomposed part set to zero
-		for (int l = 0; l < nb_sessions; ++l)
-		{
-			for (int t = 0; t < nb_timeslots; ++t)
-			{
-				if (t < first_timeslot || t > last_timeslot)
-				{
-					if (solution_lecture_timeslot[l] == t)
-					{
-						for (int c = 0; c < nb_locations; ++c)
-						{
-							sense[0] = 'E';
-							rhs[0] = 0;
-
-							std::string name = "Lecture_" + std::to_string(l + 1) + "_not_scheduled_in_room" + std::to_string(c + 1);
-							rowname[0] = const_cast<char*>(name.c_str());
-
-							matbeg[0] = 0;
-							f = 0;
-
-							matind[f] = l * nb_locations + c;
-							matval[f] = 1;
-							++f;
-
-							status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function Two_Stage_Model::build_subproblem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-							}
-						}
-					}
-				}
-			}
-		}
-
-
-		// Constraint set 2: No room overlaps
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int c = 0; c < nb_locations; ++c)
-			{
-				sense[0] = 'L';
-				rhs[0] = 1;
-
-				std::string name = "Room_" + std::to_string(c + 1) + "_max_one_lecture_at_time_" + std::to_string(t + 1);
-				rowname[0] = const_cast<char*>(name.c_str());
-
-				matbeg[0] = 0;
-				f = 0;
-
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (get_sessionlocationpossible(l, c) && solution_lecture_timeslot[l] == t)
-					{
-						matind[f] = l * nb_locations + c;
-						matval[f] = 1;
-						++f;
-					}
-				}
-
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
-
-
-		// FLOWS BETWEEN EVENTS IN CONSECUTIVE TIMESLOTS
-		// Constraint set 8: U_tsp constraints 
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int s = 0; s < nb_series; ++s)
-			{
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t) // only lectures planned in this timeslot
-					{
-						for (int m = 0; m < nb_sessions; ++m)
-						{
-							if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t + 1) // lectures planned in the next timeslot
-							{
-								for (int c = 0; c < nb_locations; ++c)
-								{
-									if (get_sessionlocationpossible(l, c))
-									{
-										for (int d = 0; d < nb_locations; ++d)
-										{
-											if (get_sessionlocationpossible(m, d))
-											{
-												for (int p = 0; p < nb_paths; ++p)
-												{
-													if (get_roomroompath(c, d, p) > 0)
-													{
-														sense[0] = 'L';
-														rhs[0] = get_roomroompath(c, d, p);
-
-														std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
-														rowname[0] = const_cast<char*>(name.c_str());
-
-														matbeg[0] = 0;
-														f = 0;
-
-														// w_lc
-														matind[f] = l * nb_locations + c;
-														matval[f] = get_roomroompath(c, d, p);
-														++f;
-
-														// w_md
-														matind[f] = m * nb_locations + d;
-														matval[f] = get_roomroompath(c, d, p);
-														++f;
-
-														// U_tsp
-														matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-														matval[f] = -1;
-														++f;
-
-
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
-													}
-												}
-											}
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 8bis: U_tsp constraints no lecture time t+1
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int s = 0; s < nb_series; ++s)
-			{
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t)
-					{
-						for (int c = 0; c < nb_locations; ++c)
-						{
-							if (get_sessionlocationpossible(l, c))
-							{
-								for (int p = 0; p < nb_paths; ++p)
-								{
-									if (get_roomroompath(c, nb_locations, p) > 0)
-									{
-										sense[0] = 'L';
-										rhs[0] = 0;
-
-										std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
-										rowname[0] = const_cast<char*>(name.c_str());
-
-										matbeg[0] = 0;
-										f = 0;
-
-										// w_lc
-										matind[f] = l * nb_locations + c;
-										matval[f] = get_roomroompath(c, nb_locations, p);
-										++f;
-
-										// sum of w_md
-										for (int m = 0; m < nb_sessions; ++m)
-										{
-											if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t + 1)
-											{
-												for (int d = 0; d < nb_locations; ++d)
-												{
-													if (get_sessionlocationpossible(m, d))
-													{
-														// x_m,t+1,d
-														matind[f] = m * nb_locations + d;
-														matval[f] = -get_roomroompath(c, nb_locations, p);
-														++f;
-													}
-												}
-											}
-										}
-
-										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-										matval[f] = -1;
-										++f;
-
-										status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 8tres: U_tsp constraints no lecture time t
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int s = 0; s < nb_series; ++s)
-			{
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t + 1)
-					{
-						for (int c = 0; c < nb_locations; ++c)
-						{
-							if (get_sessionlocationpossible(l, c))
-							{
-								for (int p = 0; p < nb_paths; ++p)
-								{
-									if (get_roomroompath(c, nb_locations, p) > 0)
-									{
-										sense[0] = 'L';
-										rhs[0] = 0;
-
-										std::string name = "TRAVELS_path_" + std::to_string(p + 1) + "_used_by_series_" + std::to_string(s + 1) + "_at_time_" + std::to_string(t + 1);
-										rowname[0] = const_cast<char*>(name.c_str());
-
-										matbeg[0] = 0;
-										f = 0;
-
-										// w_lc
-										matind[f] = l * nb_locations + c;
-										matval[f] = get_roomroompath(c, nb_locations, p);
-										++f;
-
-										// sum of w_md
-										for (int m = 0; m < nb_sessions; ++m)
-										{
-											if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t)
-											{
-												for (int d = 0; d < nb_locations; ++d)
-												{
-													if (get_sessionlocationpossible(m, d))
-													{
-														matind[f] = m * nb_locations + d;
-														matval[f] = -get_roomroompath(c, nb_locations, p);
-														++f;
-													}
-												}
-											}
-										}
-
-										// U_tsp
-										matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-										matval[f] = -1;
-										++f;
-
-										status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-										if (status != 0)
-										{
-											CPXgeterrorstring(env, status, error_text);
-											throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 9: maximum crowd flow per arc
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int ij = 0; ij < nb_arcs; ++ij)
-			{
-				sense[0] = 'G';
-				rhs[0] = -F_max;
-
-				std::string name = "TRAVELS_maximum_flow_time_" + std::to_string(t + 1) + "_arc_" + std::to_string(ij + 1);
-				rowname[0] = const_cast<char*>(name.c_str());
-
-				matbeg[0] = 0;
-				f = 0;
-
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					for (int s = 0; s < nb_series; ++s)
-					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-						matval[f] = -series_nb_people[s] * get_patharc(p, ij);;
-						++f;
-					}
-				}
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
-
-		// Constraint set 10: Travel time through arc ij at time t
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int ij = 0; ij < nb_arcs; ++ij)
-			{
-				sense[0] = 'E';
-				rhs[0] = (double)arc_length[ij] / v_max;
-
-				std::string name = "TRAVELS_travel_time_arc_t_" + std::to_string(t + 1) + "_arc_" + std::to_string(ij + 1);
-				rowname[0] = const_cast<char*>(name.c_str());
-
-				matbeg[0] = 0;
-				f = 0;
-
-				// U_tsp variables
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					for (int s = 0; s < nb_series; ++s)
-					{
-						matind[f] = nb_sessions * nb_locations + t * nb_series*nb_paths + s * nb_paths + p;
-						matval[f] = -series_nb_people[s] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
-						if (arc_stairs[ij])
-							matval[f] *= speed_correction_stairs;
-						++f;
-					}
-				}
-
-				// T(arc)_tij variable
-				matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
-				matval[f] = 1;
-				++f;
-
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
-
-		// Constraint set 11: Travel time for series s at time t
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int s = 0; s < nb_series; ++s)
-			{
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t)
-					{
-						for (int m = 0; m < nb_sessions; ++m)
-						{
-							if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t + 1)
-							{
-								for (int c = 0; c < nb_locations; ++c)
-								{
-									if (get_sessionlocationpossible(l, c))
-									{
-										for (int d = 0; d < nb_locations; ++d)
-										{
-											if (get_sessionlocationpossible(m, d))
-											{
-												for (int p = 0; p < nb_paths; ++p)
-												{
-													if (get_roomroompath(c, d, p) > 0)
-													{
-														sense[0] = 'L';
-														rhs[0] = 2 * Big_M;
-
-														std::string name = "TRAVELS_travel_time_series_" + std::to_string(s + 1) + "_time_" + std::to_string(t + 1) + "_path_" + std::to_string(p + 1);
-														rowname[0] = const_cast<char*>(name.c_str());
-
-														matbeg[0] = 0;
-														f = 0;
-
-														// w_lc
-														matind[f] = l * nb_locations + c;
-														matval[f] = Big_M;
-														++f;
-
-														// w_md
-														matind[f] = m * nb_locations + d;
-														matval[f] = Big_M;
-														++f;
-
-														// sum of T_arc_t,ij
-														for (int ij = 0; ij < nb_arcs; ++ij)
-														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
-															matval[f] = -get_patharc(p, ij);
-															++f;
-														}
-
-														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
-														matval[f] = 1;
-														++f;
-
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
-													}
-												}
-											}
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 11bis: Travel time for series s at time t
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int s = 0; s < nb_series; ++s)
-			{
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (get_seriessession(s, l) && solution_lecture_timeslot[l] == t)
-					{
-						for (int m = 0; m < nb_sessions; ++m)
-						{
-							if (get_seriessession(s, m) && solution_lecture_timeslot[m] == t + 1)
-							{
-								for (int c = 0; c < nb_locations; ++c)
-								{
-									if (get_sessionlocationpossible(l, c))
-									{
-										for (int d = 0; d < nb_locations; ++d)
-										{
-											if (get_sessionlocationpossible(m, d))
-											{
-												for (int p = 0; p < nb_paths; ++p)
-												{
-													if (get_roomroompath(c, d, p) > 0)
-													{
-														sense[0] = 'L';
-														rhs[0] = 2 * Big_M;
-
-														std::string name = "TRAVELS_travel_time_series_" + std::to_string(s + 1) + "_time_" + std::to_string(t + 1) + "_path_" + std::to_string(p + 1);
-														rowname[0] = const_cast<char*>(name.c_str());
-
-														matbeg[0] = 0;
-														f = 0;
-
-														// w_lc
-														matind[f] = l * nb_locations + c;
-														matval[f] = Big_M;
-														++f;
-
-														// w_md
-														matind[f] = m * nb_locations + d;
-														matval[f] = Big_M;
-														++f;
-
-														// sum of T_arc_t,ij
-														for (int ij = 0; ij < nb_arcs; ++ij)
-														{
-															matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + t * nb_arcs + ij;
-															matval[f] = get_patharc(p, ij);
-															++f;
-														}
-
-														// T_tot_tsp
-														matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
-														matval[f] = -1;
-														++f;
-
-														status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-														if (status != 0)
-														{
-															CPXgeterrorstring(env, status, error_text);
-															throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-														}
-
-													}
-												}
-											}
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 12: Maximum travel time timeslot t
-		for (int t = first_timeslot; t < last_timeslot; ++t)
-		{
-			for (int s = 0; s < nb_series; ++s)
-			{
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					sense[0] = 'L';
-					rhs[0] = 0;
-
-					std::string name = "TRAVELS_travel_time_t_" + std::to_string(t + 1) + "_s_" + std::to_string(s + 1) + "_p_" + std::to_string(p + 1);
-					rowname[0] = const_cast<char*>(name.c_str());
-
-					matbeg[0] = 0;
-					f = 0;
-
-					// T(travel)_tsp
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
-					matval[f] = 1;
-					++f;
-
-					// T(travel)_t,max
-					matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + t;
-					matval[f] = -1;
-					++f;
-
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
-				}
-			}
-		}
-
-
-		// EVACUATIONS
-		const int nb_variables_first_part = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series*nb_paths + nb_timeslots;
-
-		// Constraint set 13: U_tlp constraints 
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				if (solution_lecture_timeslot[l] == t) // only lectures planned in this timeslot
-				{
-					for (int c = 0; c < nb_locations; ++c)
-					{
-						if (get_sessionlocationpossible(l, c))
-						{
-							for (int p = 0; p < nb_paths; ++p)
-							{
-								if (get_roomroompath(c, nb_locations, p) > 0)
-								{
-									sense[0] = 'L';
-									rhs[0] = 0;
-
-									std::string name = "EVACS_path_" + std::to_string(p + 1) + "_used_by_lecture_" + std::to_string(l + 1) + "_at_time_" + std::to_string(t + 1);
-									rowname[0] = const_cast<char*>(name.c_str());
-
-									matbeg[0] = 0;
-									f = 0;
-
-									// w_lc
-									matind[f] = l * nb_locations + c;
-									matval[f] = get_roomroompath(c, nb_locations, p);
-									++f;
-
-									// U_tlp
-									matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-									matval[f] = -1;
-									++f;
-
-
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 14: maximum crowd flow per arc
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int ij = 0; ij < nb_arcs; ++ij)
-			{
-				sense[0] = 'G';
-				rhs[0] = -F_max;
-
-				std::string name = "EVACS_maximum_flow_time_" + std::to_string(t + 1) + "_arc_" + std::to_string(ij + 1);
-				rowname[0] = const_cast<char*>(name.c_str());
-
-				matbeg[0] = 0;
-				f = 0;
-
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					for (int l = 0; l < nb_sessions; ++l)
-					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij);
-						++f;
-					}
-				}
-
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
-
-		// Constraint set 15: Evacuation time through arc ij at time t
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int ij = 0; ij < nb_arcs; ++ij)
-			{
-				sense[0] = 'E';
-				rhs[0] = (double)arc_length[ij] / v_max;
-
-				std::string name = "EVACS_travel_time_arc_t_" + std::to_string(t + 1) + "_arc_" + std::to_string(ij + 1);
-				rowname[0] = const_cast<char*>(name.c_str());
-
-				matbeg[0] = 0;
-				f = 0;
-
-				// U_tlp variables
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					for (int l = 0; l < nb_sessions; ++l)
-					{
-						matind[f] = nb_variables_first_part + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -session_nb_people[l] * get_patharc(p, ij) * (double)arc_length[ij] / (walking_alpha*arc_area[ij]);
-						if (arc_stairs[ij])
-							matval[f] *= speed_correction_stairs;
-						++f;
-					}
-				}
-
-				// T(arc)_tij variable
-				matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
-				matval[f] = 1;
-				++f;
-
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-				}
-			}
-		}
-
-		// Constraint set 16: Evacuation time for lecture l at time t
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				if (solution_lecture_timeslot[l] == t)
-				{
-					for (int c = 0; c < nb_locations; ++c)
-					{
-						if (get_sessionlocationpossible(l, c))
-						{
-							for (int p = 0; p < nb_paths; ++p)
-							{
-								if (get_roomroompath(c, nb_locations, p) > 0)
-								{
-									sense[0] = 'L';
-									rhs[0] = Big_M;
-
-									std::string name = "EVACS_travel_time_lecture_" + std::to_string(l + 1) + "_time_" + std::to_string(t + 1) + "_path_" + std::to_string(p + 1);
-									rowname[0] = const_cast<char*>(name.c_str());
-
-									matbeg[0] = 0;
-									f = 0;
-
-									// w_lc
-									matind[f] = l * nb_locations + c;
-									matval[f] = Big_M;
-									++f;
-
-									// sum of T_arc_t,ij
-									for (int ij = 0; ij < nb_arcs; ++ij)
-									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
-										matval[f] = -get_patharc(p, ij);
-										++f;
-									}
-
-									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-									matval[f] = 1;
-									++f;
-
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 16bis: Evacuation time for lecture l at time t
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				if (solution_lecture_timeslot[l] == t)
-				{
-					for (int c = 0; c < nb_locations; ++c)
-					{
-						if (get_sessionlocationpossible(l, c))
-						{
-							for (int p = 0; p < nb_paths; ++p)
-							{
-								if (get_roomroompath(c, nb_locations, p) > 0)
-								{
-									sense[0] = 'L';
-									rhs[0] = Big_M;
-
-									std::string name = "EVACS_travel_time_lecture_" + std::to_string(l + 1) + "_time_" + std::to_string(t + 1) + "_path_" + std::to_string(p + 1);
-									rowname[0] = const_cast<char*>(name.c_str());
-
-									matbeg[0] = 0;
-									f = 0;
-
-									// w_lc
-									matind[f] = l * nb_locations + c;
-									matval[f] = Big_M;
-									++f;
-
-									// sum of T_arc_t,ij
-									for (int ij = 0; ij < nb_arcs; ++ij)
-									{
-										matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + t * nb_arcs + ij;
-										matval[f] = get_patharc(p, ij);
-										++f;
-									}
-
-									// T_tot_tsp
-									matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-									matval[f] = -1;
-									++f;
-
-									status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 17: Maximum evacuation time timeslot t
-		for (int t = first_timeslot; t <= last_timeslot; ++t)
-		{
-			for (int l = 0; l < nb_sessions; ++l)
-			{
-				for (int p = 0; p < nb_paths; ++p)
-				{
-					sense[0] = 'L';
-					rhs[0] = 0;
-
-					std::string name = "EVACS_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-					rowname[0] = const_cast<char*>(name.c_str());
-
-					matbeg[0] = 0;
-					f = 0;
-
-					// T(evac)_tlp
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-					matval[f] = 1;
-					++f;
-
-					// T(travel)_t,max
-					matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions*nb_paths + t;
-					matval[f] = -1;
-					++f;
-
-					status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-					}
-				}
-			}
-		}
-
-
-		// MAXIMUM
-		// Constraint set 18: Maximal travel time
-		if (_objective_type == objective_type::maximum_over_timeslots)
-		{
-			for (int t = first_timeslot; t < last_timeslot; ++t)
-			{
-				for (int s = 0; s < nb_series; ++s)
-				{
-					for (int p = 0; p < nb_paths; ++p)
-					{
-						sense[0] = 'G';
-						rhs[0] = 0;
-
-						std::string name = "TRAVELS_maximum_travel_time_t_" + std::to_string(t + 1) + "_s_" + std::to_string(s + 1) + "_p_" + std::to_string(p + 1);
-						rowname[0] = const_cast<char*>(name.c_str());
-
-						matbeg[0] = 0;
-						f = 0;
-
-						// T(total)_tsp variable
-						matind[f] = nb_sessions * nb_locations + nb_timeslots * nb_series*nb_paths + nb_timeslots * nb_arcs + t * nb_series*nb_paths + s * nb_paths + p;
-						matval[f] = -1;
-						++f;
-
-						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, subproblem) - 2;
-						matval[f] = 1;
-						++f;
-
-						status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
-					}
-				}
-			}
-		}
-
-		// Constraint set 19: Maximal evacuation time
-		if (_objective_type == objective_type::maximum_over_timeslots)
-		{
-			for (int t = first_timeslot; t <= last_timeslot; ++t)
-			{
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					for (int p = 0; p < nb_paths; ++p)
-					{
-						sense[0] = 'G';
-						rhs[0] = 0;
-
-						std::string name = "EVACS_maximum_travel_time_t_" + std::to_string(t + 1) + "_l_" + std::to_string(l + 1) + "_p_" + std::to_string(p + 1);
-						rowname[0] = const_cast<char*>(name.c_str());
-
-						matbeg[0] = 0;
-						f = 0;
-
-						// T(total)_tsp variable
-						matind[f] = nb_variables_first_part + nb_timeslots * nb_sessions*nb_paths + nb_timeslots * nb_arcs + t * nb_sessions*nb_paths + l * nb_paths + p;
-						matval[f] = -1;
-						++f;
-
-						// Theta (Tmax) variable
-						matind[f] = CPXgetnumcols(env, subproblem) - 1;
-						matval[f] = 1;
-						++f;
-
-						status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-						}
-					}
-				}
-			}
-		}
-
-
-		// Write to file
-		status = CPXwriteprob(env, subproblem, "MIP_model_second_stage.lp", NULL);
-		/*if (status != 0)
-		{
-		CPXgeterrorstring(env, status, error_text);
-		throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nFailed to write the subproblem to a file. \nReason: " + std::string(error_text));
-		}*/
-
-
-		// Get model info
-		nb_variables_firststage = CPXgetnumcols(env, masterproblem);
-		nb_constraints_firststage = CPXgetnumrows(env, masterproblem);
+		problem.add_mip_start(columns, values, "start_solution");
 	}
 
 
-	void MIP_two_stage::solve_subproblem(int timeslot)
+	void MIP_two_stage::update_objective_coefficients_subproblem()
 	{
-		int status = 0;
-		int solstat;
-		std::unique_ptr<double[]> solution_CPLEX = std::make_unique<double[]>(CPXgetnumcols(env, subproblem));
-
-
-		// Optimize the problem
-		std::cout << "\n\nCPLEX is solving the second stage MIP, for timeslot " << timeslot + 1 << ", for instance " << instance_name_timetable << " + " << instance_name_building << " ... ";
-		status = CPXmipopt(env, subproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
+		std::vector<int> indices;
+		std::vector<double> values;
 
-		// Get the solution
-		status = CPXsolution(env, subproblem, &solstat, &objective_value_secondstage, solution_CPLEX.get(), NULL, NULL, NULL);
-		if (status != 0)
+		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_only_second_stage::solve_problem(). \nCPXsolution failed. \nReason: " + std::string(error_text));
-		}
+			// travels
+			indices.push_back(layout_subproblem.index(variable_family::T_travel_max_overall));
+			values.push_back(1 - _alpha);
 
-
-		// Check the solution status
-		if (solstat == CPXMIP_OPTIMAL) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Optimal solution found";
-		}
-		else if (solstat == CPXMIP_OPTIMAL_TOL) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Solution found within tolerance limit";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_FEAS) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Time limit exceeded";
-		}
-		else if (solstat == CPXMIP_MEM_LIM_FEAS) {
-			solution_secondstage_exists = true;
-			solution_info_secondstage = "Tree memory limit exceeded";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_INFEASIBLE) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible";
-		}
-		else if (solstat == CPXMIP_UNBOUNDED) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is unbounded";
-		}
-		else if (solstat == CPXMIP_INForUNBD) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Problem is infeasible or unbounded";
-		}
-		else if (solstat == CPXMIP_TIME_LIM_INFEAS) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Time limit exceeded";
+			// evac
+			indices.push_back(layout_subproblem.index(variable_family::T_evac_max_overall));
+			values.push_back(_alpha);
 		}
-		else if (solstat == CPXMIP_MEM_LIM_INFEAS) {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Tree memory limit exceeded";
-		}
-		else {
-			solution_secondstage_exists = false;
-			solution_info_secondstage = "Other reason for failure";
-		}
-
-		std::cout << "\nCPLEX has finished: " << solution_info_secondstage << "\n";
-
-
-		if (solution_secondstage_exists)
+		else // if (_objective_type == objective_type::sum_over_timeslots)
 		{
-			// for which timeslots does this decomposed problem need to be constructed
-			int first_timeslot = timeslot, last_timeslot = timeslot;
-
-			// 1. travel times
+			// travels
+			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				const int index_travels = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths;
-				solution_travel_times.reserve(last_timeslot - first_timeslot);
-				for (int t = first_timeslot; t < last_timeslot; ++t)
-				{
-					double time = solution_CPLEX[index_travels + t];
-					solution_travel_times.push_back(time);
-				}
+				indices.push_back(layout_subproblem.index(variable_family::T_travel_max_t, t));
+				values.push_back(1 - _alpha);
 			}
 
-			// 2. evacuation times
+			// evac
+			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				const int index_evacs = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-					+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
-				solution_evacuation_times.reserve(last_timeslot - first_timeslot + 1);
-				for (int t = first_timeslot; t <= last_timeslot; ++t)
-				{
-					double time = solution_CPLEX[index_evacs + t];
-					solution_evacuation_times.push_back(time);
-				}
+				indices.push_back(layout_subproblem.index(variable_family::T_evac_max_t, t));
+				values.push_back(_alpha);
 			}
 		}
-	}
-
-
-
-	void MIP_two_stage::run_only_first_stage_and_evaluate_solution()
-	{
-		auto start_time = std::chrono::system_clock::now();
-
-		initialize_cplex();
-
-		build_masterproblem();
-		solve_masterproblem();
-		clear_masterproblem();
-
-		computation_time_firststage = std::chrono::system_clock::now() - start_time;
-		start_time = std::chrono::system_clock::now();
-
-		build_subproblem();
-		fix_solution(solution_lecture_room);
-		solve_subproblem();
-
-		clear_cplex();
 
-		computation_time_secondstage = std::chrono::system_clock::now() - start_time;
-
-		write_output();
+		subproblem->change_objective((int)indices.size(), indices.data(), values.data());
 	}
 
 
 	void MIP_two_stage::fix_solution(const std::vector<int> lecture_room)
 	{
-		int status = 0;
-		double obj[1];						// Objective function
-		double lb[1];						// Lower bound variables
-		double ub[1];						// Upper bound variables
-		double rhs[1];						// Right-hand side constraints
-		char *colname[1];					// Variable names
-		char *rowname[1];					// Constraint names
-		char sense[1];						// Sign of constraint
-		int matbeg[1];						// Begin position of the constraint
-		std::unique_ptr<int[]> matind;		// Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval;	// Value of each element in constraint matrix
-		char type[1];						// Type of variable (integer, binary, fractional)
-		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
-
-											// Create arrays
-		matind = std::make_unique<int[]>(10000000);
-		matval = std::make_unique<double[]>(10000000);
+		std::vector<int> columns;
+		std::vector<double> values;
+		columns.reserve(nb_sessions * nb_locations);
+		values.reserve(nb_sessions * nb_locations);
 
 		// Fix w_lc variables
 		for (int l = 0; l < nb_sessions; ++l)
 		{
 			for (int c = 0; c < nb_locations; ++c)
 			{
-				sense[0] = 'E';
-
-				if (lecture_room.at(l) == c)
-					rhs[0] = 1;
-				else
-					rhs[0] = 0;
-
-				std::string name = "Fix_w_" + std::to_string(l + 1) + "_" + std::to_string(c + 1);
-				rowname[0] = const_cast<char*>(name.c_str());
-
-				matbeg[0] = 0;
-				f = 0;
-
-				matind[f] = l * nb_locations + c;
-				matval[f] = 1;
-				++f;
-
-				status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-				if (status != 0)
+				if (layout_subproblem.exists(variable_family::w_lc, l, c))
 				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function MIP_two_stage::fix_solution(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
+					columns.push_back(layout_subproblem.index(variable_family::w_lc, l, c));
+					if (lecture_room.at(l) == c)
+						values.push_back(1);
+					else
+						values.push_back(0);
 				}
 			}
 		}
 
+		fixed_solution.fix(*subproblem, columns, values);
+	}
 
-		// Write to file
-		status = CPXwriteprob(env, subproblem, "MIP_model_second_stage.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::build_problem(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
-		}
+
+	void MIP_two_stage::unfix_solution()
+	{
+		fixed_solution.restore(*subproblem);
 	}
 
 
@@ -4870,31 +3681,23 @@ namespace alg
 
 	void MIP_two_stage::clear_subproblem()
 	{
-		int status = 0;
-
 		// Free the subproblem
-		status = CPXfreeprob(env, &subproblem);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::clear_subproblem(). \nCouldn't free the subproblem. \nReason: " + std::string(error_text));
-		}
+		if (lazy_travel_constraints_enabled())
+			disable_lazy_travel_constraints();
+		fixed_solution.clear();
+		subproblem.reset();
 	}
 
 
 
 
-	void MIP_two_stage::clear_cplex()
+	void MIP_two_stage::clear_solver()
 	{
-		int status = 0;
-
-		// Close the cplex environment
-		status = CPXcloseCPLEX(&env);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::clear_cplex(). \nCouldn't close CPLEX environment. \nReason: " + std::string(error_text));
-		}
+		// Free the problems that are still present (a CPLEX environment is returned to the pool)
+		if (masterproblem != nullptr)
+			clear_masterproblem();
+		if (subproblem != nullptr)
+			clear_subproblem();
 	}
 
 
@@ -4916,6 +3719,7 @@ namespace alg
 			text += "sum over timeslots";
 		text += "\n\tTime limit (seconds): " + std::to_string(_time_limit);
 		text += "\n\tOptimality tolerance: " + std::to_string(_optimality_tolerance);
+		text += "\n\tSolver resources: " + describe_solver_resources(_resources);
 
 
 		// 3. results
@@ -4925,6 +3729,11 @@ namespace alg
 		text += "\nElapsed time (seconds):";
 		text += "\n\tFirst stage: " + std::to_string(get_computation_time_firststage());
 		text += "\n\tSecond stage: " + std::to_string(get_computation_time_secondstage());
+		if (!_progress_trace_file.empty() && !progress_traces.empty())
+		{
+			write_progress_traces(progress_traces, _progress_trace_file);
+			text += "\nProgress of the solver written to: " + _progress_trace_file;
+		}
 		text += "\nModel info:";
 		text += "\n\tNumber of constraints first stage: " + std::to_string(nb_constraints_firststage);
 		text += "\n\tNumber of variables first stage: " + std::to_string(nb_variables_firststage);
@@ -4964,9 +3773,79 @@ namespace alg
 
 
 
+#ifdef ALG_USE_CPLEX
+	int CPXPUBLIC MIP_two_stage::lazy_travel_callback(CPXCENVptr callback_env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p)
+	{
+		const MIP_two_stage* model = static_cast<const MIP_two_stage*>(cbhandle);
+		const variable_layout& layout = model->layout_subproblem;
+		*useraction_p = CPX_CALLBACK_DEFAULT;
+
+		std::vector<double> x(layout.get_nb_columns());
+		int status = CPXgetcallbacknodex(callback_env, cbdata, wherefrom, x.data(), 0, layout.get_nb_columns() - 1);
+		if (status != 0)
+			return status;
+
+		// Rooms in the integer solution, the timeslots are given by the first stage
+		std::vector<int> lecture_room(nb_sessions, -1);
+		std::vector<int> lecture_column(nb_sessions, -1);
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			for (int c = 0; c < nb_locations; ++c)
+			{
+				if (layout.exists(variable_family::w_lc, l, c) && x[layout.index(variable_family::w_lc, l, c)] > 0.5)
+				{
+					lecture_room[l] = c;
+					lecture_column[l] = layout.index(variable_family::w_lc, l, c);
+				}
+			}
+		}
+
+		return separate_travel_constraints(callback_env, cbdata, wherefrom, layout, x, model->solution_lecture_timeslot, lecture_room, lecture_column, useraction_p);
+	}
+
+
+#endif // ALG_USE_CPLEX
+
+
+	void MIP_two_stage::enable_lazy_travel_constraints()
+	{
+#ifdef ALG_USE_CPLEX
+		// The callback adds rows in terms of the original columns
+		dynamic_cast<cplex_backend&>(*subproblem).set_lazy_constraint_callback(&MIP_two_stage::lazy_travel_callback, this);
+#endif // ALG_USE_CPLEX
+	}
+
+
+	void MIP_two_stage::disable_lazy_travel_constraints()
+	{
+#ifdef ALG_USE_CPLEX
+		dynamic_cast<cplex_backend&>(*subproblem).set_lazy_constraint_callback(NULL, NULL);
+#endif // ALG_USE_CPLEX
+	}
+
+
+	void MIP_two_stage::write_output_benders()
+	{
+		std::string text;
+
+		text = "Algorithm: "; text.append(algorithm_name); text += " (logic-based Benders decomposition)";
+		text += "\nProblem: " + instance_name_timetable + " + " + instance_name_building;
+		text += "\nSettings:";
+		text += "\n\tLambda: " + std::to_string(_lambda);
+		text += "\n\tMaximum number of iterations: " + std::to_string(_benders_max_iterations);
+		text += "\nIterations: " + std::to_string(benders_iterations);
+		text += "\nSubproblems solved: " + std::to_string(benders_nb_subproblems);
+		text += "\nLower bound: " + std::to_string(benders_lower_bound);
+		text += "\nUpper bound: " + std::to_string(benders_upper_bound);
+
+		// Write single item to logger
+		_logger << logger::log_type::INFORMATION << text;
+	}
+
+
+
 	void MIP_two_stage::add_constraint_maximum_evacuation_time(double value)
 	{
-		int status = 0;
 		double obj[1];						// Objective function
 		double lb[1];						// Lower bound variables
 		double ub[1];						// Upper bound variables
@@ -4981,8 +3860,8 @@ namespace alg
 		int f{ 0 };							// To calculate number of nonzero coefficients in each constraint
 
 											// Create arrays
-		matind = std::make_unique<int[]>(100000);
-		matval = std::make_unique<double[]>(100000);
+		matind = std::make_unique<int[]>(nb_timeslots);
+		matval = std::make_unique<double[]>(nb_timeslots);
 
 
 		sense[0] = 'L';
@@ -4996,38 +3875,26 @@ namespace alg
 
 		if (_objective_type == objective_type::maximum_over_timeslots)
 		{
-			matind[f] = CPXgetnumcols(env, subproblem) - 1;
+			matind[f] = layout_subproblem.index(variable_family::T_evac_max_overall);
 			matval[f] = 1;
 			++f;
 		}
 		else // if (_objective_type == objective_type::sum_over_timeslots)
 		{
-			const int index_evacs = nb_sessions * nb_locations + nb_timeslots * nb_series * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_series * nb_paths
-				+ nb_timeslots + nb_timeslots * nb_sessions * nb_paths + nb_timeslots * nb_arcs + nb_timeslots * nb_sessions * nb_paths;
 
 			for (int t = 0; t < nb_timeslots; ++t)
 			{
-				matind[f] = index_evacs + t;
+				matind[f] = layout_subproblem.index(variable_family::T_evac_max_t, t);
 				matval[f] = 1;
 				++f;
 			}
 		}
 
-		status = CPXaddrows(env, subproblem, 0, 1, f, rhs, sense, matbeg, matind.get(), matval.get(), NULL, rowname);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::add_constraint_maximum_evacuation_time(). \nCouldn't add constraint " + name + ". \nReason: " + std::string(error_text));
-		}
+		subproblem->add_rows(1, f, rhs, sense, matbeg, matind.get(), matval.get(), rowname);
 
 
 		// Write to file
-		status = CPXwriteprob(env, subproblem, "MIP_model_second_stage.lp", NULL);
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function MIP_two_stage::add_constraint_maximum_evacuation_time(). \nFailed to write the problem to a file. \nReason: " + std::string(error_text));
-		}
+		subproblem->write("MIP_model_second_stage.lp");
 	}
 
 
@@ -7,8 +7,11 @@
 #ifndef MIP_TWO_STAGE_H
 #define MIP_TWO_STAGE_H
 
-#include "ilcplex\cplex.h"
+#include "MIP_backend.h"
+#include "MIP_utilities.h"
+#include <memory>
 #include <vector>
+#include <string>
 #include <chrono>
 
 /*!
@@ -28,24 +31,52 @@ namespace alg
 		static constexpr const char * algorithm_name = "Two-stage MIP";
 
 		/*!
-		*	@brief	Pointer to the CPLEX environment.
+		*	@brief	The problem for the first stage in the chosen solver.
 		*/
-		CPXENVptr env{ nullptr };
+		std::unique_ptr<mip_backend> masterproblem;
 
 		/*!
-		*	@brief	Pointer to the CPLEX problem for the first stage.
+		*	@brief	The problem for the second stage in the chosen solver.
 		*/
-		CPXLPptr masterproblem{ nullptr };
+		std::unique_ptr<mip_backend> subproblem;
 
 		/*!
-		*	@brief	Pointer to the CPLEX problem for the second stage.
+		*	@brief	Column indices of the variable families in the first stage problem.
 		*/
-		CPXLPptr subproblem{ nullptr };
+		variable_layout layout_masterproblem;
 
 		/*!
-		*	@brief	Store for CPLEX error messages.
+		*	@brief	Column indices of the variable families in the second stage problem.
 		*/
-		char error_text[CPXMESSAGEBUFSIZE];
+		variable_layout layout_subproblem;
+
+		/*!
+		*	@brief	The variables fixed by fix_solution(), with their original bounds.
+		*/
+		column_fixing fixed_solution;
+
+		/*!
+		*	@brief	A decomposed part of the second stage problem, covering a range of consecutive timeslots.
+		*	Each part is built and solved in its own problem, created with the resources of the worker thread that handles it.
+		*/
+		struct subproblem_part
+		{
+			int first_timeslot = 0;					///< First timeslot covered by the part
+			int last_timeslot = 0;					///< Last timeslot covered by the part (inclusive)
+			std::string description;				///< Description of the part, for the output
+			std::unique_ptr<mip_backend> problem;	///< Problem of the part, in the chosen solver
+			variable_layout layout;					///< Column indices of the variable families in the problem
+			int nb_variables = 0;					///< Number of variables in the problem
+			int nb_constraints = 0;					///< Number of constraints in the problem
+			bool solution_exists = false;			///< Indicates whether a solution exists for the part
+			bool proven_infeasible = false;			///< Indicates whether the solver proved that no solution exists for the part
+			double objective_bound = 0;				///< Best bound on the objective value of the part (only if a solution exists)
+			std::string solution_info;				///< Information on the solution status for the part
+			std::vector<int> lecture_room;			///< Room assigned to each lecture of the part, -1 for the other lectures
+			std::vector<double> travel_times;		///< Travel times after timeslots first_timeslot, ..., last_timeslot - 1
+			std::vector<double> evacuation_times;	///< Evacuation times in timeslots first_timeslot, ..., last_timeslot
+			mip_solve_trace progress_trace;			///< Progress of the solve of the part
+		};
 
 		/*!
 		*	@brief	Indicates whether a solution exists for the first stage.
@@ -53,12 +84,12 @@ namespace alg
 		bool solution_firststage_exists = false;
 
 		/*!
-		*	@brief	Information on the CPLEX solution status for the first stage.
+		*	@brief	Information on the solution status for the first stage.
 		*/
 		std::string solution_info_firststage;
 
 		/*!
-		*	@brief	Objective value of the CPLEX solution for the first stage.
+		*	@brief	Objective value of the solution for the first stage.
 		*/
 		double objective_value_firststage;
 
@@ -73,15 +104,20 @@ namespace alg
 		bool solution_secondstage_exists = false;
 
 		/*!
-		*	@brief	Information on the CPLEX solution status for the second stage.
+		*	@brief	Information on the solution status for the second stage.
 		*/
 		std::string solution_info_secondstage;
 
 		/*!
-		*	@brief	Objective value of the CPLEX solution for the second stage.
+		*	@brief	Objective value of the solution for the second stage.
 		*/
 		double objective_value_secondstage;
 
+		/*!
+		*	@brief	The progress of every solve of the current run, for both stages.
+		*/
+		std::vector<mip_solve_trace> progress_traces;
+
 		/*!
 		*	@brief	Solution of the problem w.r.t. room assignments.
 		*/
@@ -102,6 +138,16 @@ namespace alg
 		*/
 		std::vector<double> solution_evacuation_times;
 
+		/*!
+		*	@brief	MIP start w.r.t. timeslot assignments (empty if no start is given).
+		*/
+		std::vector<int> mip_start_lecture_timeslot;
+
+		/*!
+		*	@brief	MIP start w.r.t. room assignments (empty if no start is given).
+		*/
+		std::vector<int> mip_start_lecture_room;
+
 		/*!
 		*	@brief	The computation time for the first stage.
 		*/
@@ -132,6 +178,31 @@ namespace alg
 		*/
 		int nb_constraints_secondstage;
 
+		/*!
+		*	@brief	The solutions found by run_pareto_sweep().
+		*/
+		std::vector<pareto_point> pareto_points;
+
+		/*!
+		*	@brief	The number of iterations of the last run of the Benders decomposition.
+		*/
+		int benders_iterations = 0;
+
+		/*!
+		*	@brief	The lower bound of the last run of the Benders decomposition.
+		*/
+		double benders_lower_bound = 0;
+
+		/*!
+		*	@brief	The upper bound (best found solution) of the last run of the Benders decomposition.
+		*/
+		double benders_upper_bound = 0;
+
+		/*!
+		*	@brief	The number of timeslot subproblems solved in the last run of the Benders decomposition.
+		*/
+		int benders_nb_subproblems = 0;
+
 	public:
 		/*!
 		*	@brief	Run the algorithm.
@@ -140,6 +211,15 @@ namespace alg
 		*/
 		void run_algorithm(bool constraint_on_evacuation_time, double value);
 
+		/*!
+		*	@brief	Solve the second stage for a sequence of values of alpha to trace the trade-off between travel and evacuation times.
+		*	The first stage is solved once and the second stage model is built once. For each value of alpha only the objective function
+		*	is updated, and the room assignments of the previous value are given as MIP start.
+		*	Each solution is written to the logger and can be retrieved with get_pareto_points().
+		*	@param	alpha_values	The values of alpha in the order in which they are solved.
+		*/
+		void run_pareto_sweep(const std::vector<double>& alpha_values);
+
 		/*!
 		*	@brief	Run the algorithm decomposed on the days.
 		*/
@@ -150,6 +230,17 @@ namespace alg
 		*/
 		void run_algorithm_timeslot_decomposition();
 
+		/*!
+		*	@brief	Run a logic-based Benders decomposition between the timetable (first stage) and the evacuation times (second stage).
+		*	The masterproblem is the first stage with an estimate of the evacuation time of every timeslot, and minimizes
+		*	lambda * preferences + (1 - lambda) * evacuation times. For every new set of lectures in a timeslot, the minimal evacuation time
+		*	is found by a second stage subproblem for that timeslot (solved in parallel). Since the evacuation time does not decrease when lectures
+		*	are added, it is a lower bound for every timeslot containing this set, which is added as optimality cut to the masterproblem.
+		*	Sets without a feasible room assignment are excluded by a feasibility cut. Travel times are not part of the masterproblem:
+		*	the second stage with the original objective is solved for the best timetable at the end.
+		*/
+		void run_algorithm_benders();
+
 		/*!
 		*	@brief	Run only the first stage of the model.
 		*/
@@ -160,6 +251,20 @@ namespace alg
 		*/
 		void run_only_first_stage_and_evaluate_solution();
 
+		/*!
+		*	@brief	Give a solution (e.g. found by the heuristic) as MIP start for the next runs of the algorithm.
+		*	The timeslots and rooms are a start for the first stage. The rooms are also a start for the second stage,
+		*	if the first stage returns the same timetable.
+		*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
+		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
+		*/
+		void set_mip_start(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room);
+
+		/*!
+		*	@brief	Remove the MIP start.
+		*/
+		void clear_mip_start() { mip_start_lecture_timeslot.clear(); mip_start_lecture_room.clear(); }
+
 		/*!
 		*	@brief	Get the computation time for the first stage of the algorithm.
 		*	@returns The computation time for the first stage of the algorithm.
@@ -172,6 +277,12 @@ namespace alg
 		*/
 		double get_computation_time_secondstage() const { return computation_time_secondstage.count(); }
 
+		/*!
+		*	@brief	Get the solutions found by the last call to run_pareto_sweep().
+		*	@returns	The solution for each value of alpha, in the order of the sweep.
+		*/
+		const std::vector<pareto_point>& get_pareto_points() const { return pareto_points; }
+
 		/*!
 		*	@brief	Check whether a solution exists.
 		*	@returns	True if a solution exists, false otherwise.
@@ -196,6 +307,12 @@ namespace alg
 		*/
 		const std::string& get_solution_info_secondstage() const { return solution_info_secondstage; }
 
+		/*!
+		*	@brief	Get the progress (incumbent, bound and gap over time) of every solve of the last run.
+		*	@returns	The progress of every solve.
+		*/
+		const std::vector<mip_solve_trace>& get_progress_traces() const { return progress_traces; }
+
 		/*!
 		*	@brief	Get the timeslot assigned to the given lecture in the solution.
 		*	@param	lecture	The lecture for which we want to know the room.
@@ -240,6 +357,51 @@ namespace alg
 		*/
 		double _time_limit = 3600;
 
+		/*!
+		*	@brief	The solver for the MIP models. CPLEX is only available if ALG_USE_CPLEX is defined and HiGHS if ALG_USE_HIGHS is defined.
+		*/
+		mip_solver _solver = default_mip_solver;
+
+		/*!
+		*	@brief	Leave the travel constraints (constraint set 8) out of the second stage model (not of the decomposed runs) and add the violated ones in a lazy constraint callback.
+		*	Only the rows that bind for the integer solutions found by CPLEX are generated. CPLEX only, ignored for the other solvers.
+		*/
+		bool _lazy_travel_constraints = false;
+
+		/*!
+		*	@brief	Directory in which the built second stage model (not the decomposed parts) is cached, keyed by a hash of the instance data and the model parameters.
+		*	A cached model is read instead of built. Empty: no cache. The directory must exist. CPLEX only, ignored for the other solvers.
+		*/
+		std::string _model_cache_directory;
+
+		/*!
+		*	@brief	The number of threads used to solve the decomposed second stage problems.
+		*	The parts are divided over min(threads, parts) workers, which share the threads evenly.
+		*	0: use the threads of _resources, or the hardware concurrency if those are not limited either.
+		*/
+		int _nb_threads_second_stage = 0;
+
+		/*!
+		*	@brief	The relative value of preferences (lambda) and evacuation times (1 - lambda) in the Benders decomposition.
+		*/
+		double _lambda = 0.5;
+
+		/*!
+		*	@brief	The maximum number of iterations of the Benders decomposition.
+		*/
+		int _benders_max_iterations = 100;
+
+		/*!
+		*	@brief	The file to which the progress of the solves is written with the output, empty for no file.
+		*/
+		std::string _progress_trace_file = "MIP_progress_two_stage.csv";
+
+		/*!
+		*	@brief	The threads, memory, node files and determinism of the solver.
+		*	The workers of the decomposed second stage share the threads and memory evenly.
+		*/
+		solver_resources _resources;
+
 		/*!
 		*	@brief	The type of objective function.
 		*/
@@ -251,88 +413,187 @@ namespace alg
 
 	private:
 		/*!
-		*	@brief	Initialize the CPLEX environment.
+		*	@brief	Prepare a run: clear the progress traces of the previous run. The problems are created by their build functions.
+		*/
+		void initialize_solver();
+
+		/*!
+		*	@brief	Create an empty problem in the chosen solver, with the output off, the optimality tolerance and the time limit.
+		*	@param	name		The name of the problem.
+		*	@param	resources	The threads, memory, node files and determinism of the solves of this problem.
+		*	@returns	The problem.
 		*/
-		void initialize_cplex();
+		std::unique_ptr<mip_backend> create_problem(const std::string& name, const solver_resources& resources) const;
 
 		/*!
-		*	@brief	Build the CPLEX problem for the first stage.
+		*	@brief	Build the problem for the first stage.
 		*/
 		void build_masterproblem();
 
 		/*!
-		*	@brief	Solve the CPLEX problem for the first stage.
+		*	@brief	Solve the problem for the first stage.
 		*/
 		void solve_masterproblem();
 
 		/*!
-		*	@brief	Clear the CPLEX problem for the first stage.
+		*	@brief	Free the problem for the first stage.
 		*/
 		void clear_masterproblem();
 
 		/*!
-		*	@brief	Build the CPLEX problem for the second stage.
+		*	@brief	Build the problem for the second stage.
 		*/
 		void build_subproblem();
 
 		/*!
-		*	@brief	Solve the CPLEX problem for the second stage.
+		*	@brief	Steps of build_subproblem() that are also needed for a model read from the cache.
 		*/
-		void solve_subproblem();
+		void finish_build_subproblem();
 
 		/*!
-		*	@brief	Build the CPLEX problem for the second stage for a specific half day.
-		*	@param	day			The day for which the problem needs to be built.
-		*	@param	afternoon	1 if afternoon, 0 if morning.
+		*	@brief	Solve the problem for the second stage.
 		*/
-		void build_subproblem(int day, int afternoon);
+		void solve_subproblem();
 
 		/*!
-		*	@brief	Solve the CPLEX problem for the second stage for a specific half day.
-		*	@param	day			The day for which the problem needs to be built.
-		*	@param	afternoon	1 if afternoon, 0 if morning.
+		*	@brief	Build the problem for a decomposed part of the second stage.
+		*	@param	part	The part, with the timeslots it covers and the empty problem it is built in.
 		*/
-		void solve_subproblem(int day, int afternoon);
+		void build_subproblem_part(subproblem_part& part);
 
 		/*!
-		*	@brief	Build the CPLEX problem for the second stage for a specific timeslot.
-		*	@param	timeslot	The timeslot for which the problem needs to be built.
+		*	@brief	Solve the problem for a decomposed part of the second stage and store its solution in the part.
+		*	@param	part	The part, which has been built.
 		*/
-		void build_subproblem(int timeslot);
+		void solve_subproblem_part(subproblem_part& part);
 
 		/*!
-		*	@brief	Build the CPLEX problem for the second stage for a specific timeslot.
-		*	@param	timeslot	The timeslot for which the problem needs to be built.
+		*	@brief	Free the problem for a decomposed part of the second stage.
+		*	@param	part	The part.
 		*/
-		void solve_subproblem(int timeslot);
+		void clear_subproblem_part(subproblem_part& part);
 
+		/*!
+		*	@brief	Build and solve the decomposed parts of the second stage on a pool of worker threads,
+		*	and merge their solutions in the order of the parts.
+		*	@param	parts	The parts to be solved.
+		*/
+		void solve_subproblem_parts(std::vector<subproblem_part>& parts);
 
 		/*!
-		*	@brief	Clear the CPLEX problem for the second stage.
+		*	@brief	Free the problem for the second stage.
 		*/
 		void clear_subproblem();
 
 		/*!
-		*	@brief	Clear CPLEX.
+		*	@brief	Free the problems that are still present.
 		*/
-		void clear_cplex();
+		void clear_solver();
 
 		/*!
 		*	@brief	Write output.
 		*/
 		void write_output();
 
+		/*!
+		*	@brief	Check whether the travel constraints are separated in a lazy constraint callback, which requires CPLEX.
+		*	@returns	True if the travel constraints are lazy, false if they are part of the model.
+		*/
+		bool lazy_travel_constraints_enabled() const { return _lazy_travel_constraints && _solver == mip_solver::cplex; }
+
+#ifdef ALG_USE_CPLEX
+		/*!
+		*	@brief	Lazy constraint callback of CPLEX, which separates the travel constraints (constraint set 8) for an integer solution.
+		*	@param	callback_env	The CPLEX environment of the callback.
+		*	@param	cbdata			The callback data.
+		*	@param	wherefrom		Where the callback was called from.
+		*	@param	cbhandle		The MIP_two_stage object.
+		*	@param	useraction_p	Set to CPX_CALLBACK_SET if rows are added.
+		*	@returns	0 if successful, the CPLEX error code otherwise.
+		*/
+		static int CPXPUBLIC lazy_travel_callback(CPXCENVptr callback_env, void* cbdata, int wherefrom, void* cbhandle, int* useraction_p);
+#endif // ALG_USE_CPLEX
+
+		/*!
+		*	@brief	Register the lazy constraint callback for the travel constraints in the CPLEX environment of the problem. Only used if lazy_travel_constraints_enabled().
+		*/
+		void enable_lazy_travel_constraints();
+
+		/*!
+		*	@brief	Remove the lazy constraint callback from the CPLEX environment, which is reused for other problems.
+		*/
+		void disable_lazy_travel_constraints();
+
+		/*!
+		*	@brief	Write the progress of the Benders decomposition to the logger.
+		*/
+		void write_output_benders();
+
+		/*!
+		*	@brief	Add the evacuation time estimates of the timeslots to the masterproblem, and weigh its objective with lambda.
+		*/
+		void add_benders_variables_masterproblem();
+
+		/*!
+		*	@brief	Add Benders cuts to the masterproblem, for every timeslot.
+		*	@param	lecture_sets		The sets of lectures for which the subproblem has been solved.
+		*	@param	evacuation_times	A proven lower bound on the minimal evacuation time of each set, or a negative value if the set is proven infeasible.
+		*/
+		void add_benders_cuts(const std::vector<std::vector<int>>& lecture_sets, const std::vector<double>& evacuation_times);
+
 		/*!
 		*	@brief	Add a constraint for the maximum evacuation time.
 		*	@param	value	The right-hand-side value for the constraint on the maximum evacuation time
 		*/
 		void add_constraint_maximum_evacuation_time(double value);
 
+		/*!
+		*	@brief	Add the MIP start, if one is given, to the problem for the first stage.
+		*/
+		void add_mip_start_masterproblem();
+
+		/*!
+		*	@brief	Add a timetable as MIP start to the problem for the first stage.
+		*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
+		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
+		*/
+		void add_timetable_start_masterproblem(const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room);
+
+		/*!
+		*	@brief	Add the room assignments of the MIP start to a problem for the second stage,
+		*	if one is given and its timetable equals the first stage solution.
+		*	@param	problem			The problem.
+		*	@param	layout			Column indices of the variable families in the problem.
+		*	@param	first_timeslot	First timeslot covered by the problem.
+		*	@param	last_timeslot	Last timeslot covered by the problem (inclusive).
+		*/
+		void add_mip_start_subproblem(mip_backend& problem, const variable_layout& layout, int first_timeslot, int last_timeslot) const;
+
+		/*!
+		*	@brief	Add room assignments as MIP start to a problem for the second stage.
+		*	@param	problem			The problem.
+		*	@param	layout			Column indices of the variable families in the problem.
+		*	@param	lecture_room	A vector that gives the room assigned to each lecture.
+		*	@param	first_timeslot	First timeslot covered by the problem.
+		*	@param	last_timeslot	Last timeslot covered by the problem (inclusive).
+		*/
+		void add_room_assignment_start(mip_backend& problem, const variable_layout& layout, const std::vector<int>& lecture_room, int first_timeslot, int last_timeslot) const;
+
+		/*!
+		*	@brief	Update the objective function coefficients of the second stage to the current value of alpha.
+		*/
+		void update_objective_coefficients_subproblem();
+
 		/*!
 		*	@brief	Fix the assignments for the solution that is to be evaluated.
 		*	@param	lecture_room		A vector that gives the room assigned to each lecture.
 		*/
 		void fix_solution(const std::vector<int> lecture_room);
+
+		/*!
+		*	@brief	Undo fix_solution() by restoring the original bounds of the fixed variables.
+		*/
+		void unfix_solution();
 	};
 
 } // namespace alg
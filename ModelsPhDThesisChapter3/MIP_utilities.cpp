@@ -0,0 +1,778 @@
+#include "MIP_utilities.h"
+#include "MIP_backend.h"
+#include "timetable_data.h"
+#include "building_data.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+
+namespace alg
+{
+	int max_row_length_timetable()
+	{
+		// number of possible rooms per session
+		std::vector<int> session_nb_rooms(nb_sessions, 0);
+		for (int l = 0; l < nb_sessions; ++l)
+			for (int c = 0; c < nb_locations; ++c)
+				if (get_sessionlocationpossible(l, c))
+					++session_nb_rooms[l];
+
+		int max_rooms_session = 0;
+		for (int l = 0; l < nb_sessions; ++l)
+			max_rooms_session = std::max(max_rooms_session, session_nb_rooms[l]);
+
+		int max_sessions_room = 0;
+		for (int c = 0; c < nb_locations; ++c)
+		{
+			int count = 0;
+			for (int l = 0; l < nb_sessions; ++l)
+				if (get_sessionlocationpossible(l, c))
+					++count;
+			max_sessions_room = std::max(max_sessions_room, count);
+		}
+
+		int max_rooms_teacher = 0;
+		for (int d = 0; d < nb_teachers; ++d)
+		{
+			int count = 0;
+			for (int l = 0; l < nb_sessions; ++l)
+				if (get_teachersession(d, l))
+					count += session_nb_rooms[l];
+			max_rooms_teacher = std::max(max_rooms_teacher, count);
+		}
+
+		int max_rooms_series = 0;
+		for (int s = 0; s < nb_series; ++s)
+		{
+			int count = 0;
+			for (int l = 0; l < nb_sessions; ++l)
+				if (get_seriessession(s, l))
+					count += session_nb_rooms[l];
+			max_rooms_series = std::max(max_rooms_series, count);
+		}
+
+		int length = 0;
+		length = std::max(length, nb_timeslots * max_rooms_session);									// set 1
+		length = std::max(length, max_sessions_room);													// set 2
+		length = std::max(length, 2 * max_rooms_session);												// set 3
+		length = std::max(length, nb_timeslots_per_day * max_rooms_teacher);							// set 4
+		length = std::max(length, 4 * std::max(nb_timeslots_per_day - 3, 0) * max_rooms_teacher);		// set 5
+		length = std::max(length, 2 * max_rooms_teacher);												// sets 6 and 7
+		length = std::max(length, 3 * max_rooms_series);												// compactness
+
+		return std::max(length, 1);
+	}
+
+
+	int max_row_length_flows()
+	{
+		int max_rooms_session = 0;
+		int max_sessions_room = 0;
+		int max_rooms_series = 0;
+
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			int count = 0;
+			for (int c = 0; c < nb_locations; ++c)
+				if (get_sessionlocationpossible(l, c))
+					++count;
+			max_rooms_session = std::max(max_rooms_session, count);
+		}
+
+		for (int c = 0; c < nb_locations; ++c)
+		{
+			int count = 0;
+			for (int l = 0; l < nb_sessions; ++l)
+				if (get_sessionlocationpossible(l, c))
+					++count;
+			max_sessions_room = std::max(max_sessions_room, count);
+		}
+
+		for (int s = 0; s < nb_series; ++s)
+		{
+			int count = 0;
+			for (int l = 0; l < nb_sessions; ++l)
+				if (get_seriessession(s, l))
+					for (int c = 0; c < nb_locations; ++c)
+						if (get_sessionlocationpossible(l, c))
+							++count;
+			max_rooms_series = std::max(max_rooms_series, count);
+		}
+
+		int length = 0;
+		length = std::max(length, max_rooms_session);					// set 1 (second stage)
+		length = std::max(length, max_sessions_room);					// set 2 (second stage)
+		length = std::max(length, 3);									// set 8
+		length = std::max(length, max_rooms_series + 2);				// sets 8bis and 8tres
+		length = std::max(length, nb_paths * nb_series + 1);			// sets 9 and 10
+		length = std::max(length, nb_arcs + 3);							// sets 11, 11bis, 16 and 16bis
+		length = std::max(length, nb_paths * nb_sessions + 1);			// sets 14 and 15
+
+		return length;
+	}
+
+
+	std::vector<bool> compute_session_evacuation_paths()
+	{
+		std::vector<bool> session_evacuation_paths(static_cast<size_t>(nb_sessions) * nb_paths, false);
+		for (int l = 0; l < nb_sessions; ++l)
+			for (int c = 0; c < nb_locations; ++c)
+				if (get_sessionlocationpossible(l, c))
+					for (int p = 0; p < nb_paths; ++p)
+						if (get_roomroompath(c, nb_locations, p) > 0)
+							session_evacuation_paths[l * nb_paths + p] = true;
+
+		return session_evacuation_paths;
+	}
+
+
+	int compute_preferences(const std::vector<int>& lecture_timeslot)
+	{
+		int pref = 0;
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			const int t = lecture_timeslot.at(l);
+			if (t >= 0)
+				pref += get_costsessiontimeslot(l, t) + 1000 * get_costsession_ts_educational(l, t);
+		}
+		return pref;
+	}
+
+
+
+	void variable_layout::clear()
+	{
+		for (auto&& family : _families)
+			family = family_columns();
+		_nb_columns = 0;
+	}
+
+
+	void variable_layout::add_family(variable_family family, int dim1, int dim2, int dim3)
+	{
+		family_columns& columns = _families.at(static_cast<size_t>(family));
+		if (columns.base >= 0)
+			throw std::runtime_error("Error in function variable_layout::add_family(). \nReason: Variable family " + std::to_string(static_cast<int>(family)) + " is already registered.");
+
+		columns.base = _nb_columns;
+		columns.dim1 = dim1;
+		columns.dim2 = dim2;
+		columns.dim3 = dim3;
+		columns.columns.assign(static_cast<size_t>(dim1) * dim2 * dim3, -1);
+	}
+
+
+	int variable_layout::add_column(variable_family family, int i, int j, int k)
+	{
+		family_columns& columns = _families.at(static_cast<size_t>(family));
+		if (columns.base < 0)
+			throw std::runtime_error("Error in function variable_layout::add_column(). \nReason: Variable family " + std::to_string(static_cast<int>(family)) + " is not registered.");
+
+		columns.columns.at((static_cast<size_t>(i) * columns.dim2 + j) * columns.dim3 + k) = _nb_columns;
+		return _nb_columns++;
+	}
+
+
+	int variable_layout::index(variable_family family, int i, int j, int k) const
+	{
+		const family_columns& columns = _families.at(static_cast<size_t>(family));
+		if (columns.base < 0)
+			return -1;
+
+		return columns.columns.at((static_cast<size_t>(i) * columns.dim2 + j) * columns.dim3 + k);
+	}
+
+
+
+	void variable_layout::write(std::ostream& out) const
+	{
+		out << _nb_columns << ' ' << _families.size() << '\n';
+		for (auto&& family : _families)
+		{
+			out << family.base << ' ' << family.dim1 << ' ' << family.dim2 << ' ' << family.dim3 << ' ' << family.columns.size();
+			for (auto&& column : family.columns)
+				out << ' ' << column;
+			out << '\n';
+		}
+	}
+
+
+	bool variable_layout::read(std::istream& in)
+	{
+		clear();
+
+		size_t nb_families = 0;
+		in >> _nb_columns >> nb_families;
+		if (!in || nb_families != _families.size())
+		{
+			clear();
+			return false;
+		}
+
+		for (auto&& family : _families)
+		{
+			size_t nb_elements = 0;
+			in >> family.base >> family.dim1 >> family.dim2 >> family.dim3 >> nb_elements;
+			if (!in)
+			{
+				clear();
+				return false;
+			}
+
+			family.columns.resize(nb_elements);
+			for (auto&& column : family.columns)
+				in >> column;
+		}
+
+		if (!in)
+		{
+			clear();
+			return false;
+		}
+		return true;
+	}
+
+
+
+	/*!
+	*	@brief	Add bytes to an FNV-1a hash.
+	*/
+	static void hash_bytes(std::uint64_t& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	/*!
+	*	@brief	Add the size and elements of a vector to an FNV-1a hash.
+	*/
+	template<typename T>
+	static void hash_vector(std::uint64_t& hash, const std::vector<T>& values)
+	{
+		const size_t size = values.size();
+		hash_bytes(hash, &size, sizeof(size));
+		hash_bytes(hash, values.data(), size * sizeof(T));
+	}
+
+	/*!
+	*	@brief	Add the size and elements of a vector of bools to an FNV-1a hash.
+	*/
+	static void hash_vector(std::uint64_t& hash, const std::vector<bool>& values)
+	{
+		const size_t size = values.size();
+		hash_bytes(hash, &size, sizeof(size));
+		for (bool value : values)
+		{
+			const unsigned char byte = value ? 1 : 0;
+			hash_bytes(hash, &byte, 1);
+		}
+	}
+
+	std::string model_cache_key(const std::string& model_name, const std::vector<double>& parameters, const std::vector<int>& data)
+	{
+		std::uint64_t hash = 14695981039346656037ull;
+
+		// timetable data
+		const int sizes[] = { nb_sessions, nb_timeslots, nb_timeslots_per_day, nb_days, nb_locations, nb_series, nb_teachers, nb_arcs, nb_paths };
+		hash_bytes(hash, sizes, sizeof(sizes));
+		hash_vector(hash, session_location_possible);
+		hash_vector(hash, series_session);
+		hash_vector(hash, session_nb_people);
+		hash_vector(hash, series_nb_people);
+		hash_vector(hash, cost_session_timeslot);
+		hash_vector(hash, cost_session_ts_educational);
+		hash_vector(hash, teacher_session);
+		hash_vector(hash, session_session_conflict);
+		hash_vector(hash, series_typeofeducation);
+
+		// building data
+		hash_vector(hash, room_room_path);
+		hash_vector(hash, path_arc);
+		hash_vector(hash, arc_length);
+		hash_vector(hash, arc_area);
+		hash_vector(hash, arc_stairs);
+
+		// model
+		hash_vector(hash, parameters);
+		hash_vector(hash, data);
+
+		std::ostringstream key;
+		key << model_name << "_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+		return key.str();
+	}
+
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	Move a file to its final name. If another writer was first, the file is removed instead.
+	*/
+	static void move_file(const std::string& from, const std::string& to)
+	{
+		if (std::rename(from.c_str(), to.c_str()) != 0)
+			std::remove(from.c_str());
+	}
+
+
+	bool read_cached_model(CPXENVptr env, CPXLPptr problem, variable_layout& layout, const std::string& directory, const std::string& key)
+	{
+		const std::string file_name = directory + "/" + key;
+
+		std::ifstream layout_file(file_name + ".layout");
+		std::ifstream model_file(file_name + ".sav");
+		if (!layout_file || !model_file)
+			return false;
+		model_file.close();
+
+		if (!layout.read(layout_file))
+			return false;
+
+		// A damaged cache file is not an error, the model is built instead
+		int status = CPXreadcopyprob(env, problem, (file_name + ".sav").c_str(), "SAV");
+		if (status != 0 || CPXgetnumcols(env, problem) != layout.get_nb_columns())
+		{
+			layout.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+
+	void write_cached_model(CPXENVptr env, CPXLPptr problem, const variable_layout& layout, const std::string& directory, const std::string& key)
+	{
+		const std::string file_name = directory + "/" + key;
+		const std::string suffix = ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+		char error_text[CPXMESSAGEBUFSIZE];
+
+		{
+			std::ofstream layout_file(file_name + ".layout" + suffix);
+			if (!layout_file)
+				throw std::runtime_error("Error in function write_cached_model(). \nCouldn't open the file " + file_name + ".layout" + suffix + ".");
+			layout.write(layout_file);
+		}
+
+		int status = CPXwriteprob(env, problem, (file_name + ".sav" + suffix).c_str(), "SAV");
+		if (status != 0)
+		{
+			std::remove((file_name + ".layout" + suffix).c_str());
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function write_cached_model(). \nFailed to write the model to the cache. \nReason: " + std::string(error_text));
+		}
+
+		// The model file is moved last, a model is only read if both files exist
+		move_file(file_name + ".layout" + suffix, file_name + ".layout");
+		move_file(file_name + ".sav" + suffix, file_name + ".sav");
+	}
+
+
+
+	void add_mip_start(CPXENVptr env, CPXLPptr problem, const std::vector<int>& columns, const std::vector<double>& values, const std::string& name)
+	{
+		if (columns.size() != values.size())
+			throw std::runtime_error("Error in function add_mip_start(). \nReason: The number of columns and values differ.");
+
+		int status = 0;
+		char error_text[CPXMESSAGEBUFSIZE];
+		int beg[1] = { 0 };
+		int effort[1] = { CPX_MIPSTART_REPAIR };
+		char* mipstartname[1] = { const_cast<char*>(name.c_str()) };
+
+		status = CPXaddmipstarts(env, problem, 1, static_cast<int>(columns.size()), beg, columns.data(), values.data(), effort, mipstartname);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function add_mip_start(). \nCouldn't add MIP start " + name + ". \nReason: " + std::string(error_text));
+		}
+	}
+
+
+	void clear_mip_starts(CPXENVptr env, CPXLPptr problem)
+	{
+		const int nb_starts = CPXgetnummipstarts(env, problem);
+		if (nb_starts == 0)
+			return;
+
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = CPXdelmipstarts(env, problem, 0, nb_starts - 1);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function clear_mip_starts(). \nCouldn't delete the MIP starts. \nReason: " + std::string(error_text));
+		}
+	}
+
+
+
+	void apply_solver_resources(CPXENVptr env, const solver_resources& resources)
+	{
+		int status = 0;
+		char error_text[CPXMESSAGEBUFSIZE];
+
+		status = CPXsetintparam(env, CPX_PARAM_THREADS, std::max(0, resources.threads));
+		if (status == 0 && resources.working_memory > 0)
+			status = CPXsetdblparam(env, CPX_PARAM_WORKMEM, resources.working_memory);
+		if (status == 0 && resources.tree_memory_limit > 0)
+			status = CPXsetdblparam(env, CPX_PARAM_TRELIM, resources.tree_memory_limit);
+		if (status == 0)
+			status = CPXsetintparam(env, CPX_PARAM_NODEFILEIND, resources.node_file);
+		if (status == 0 && !resources.node_file_directory.empty())
+			status = CPXsetstrparam(env, CPX_PARAM_WORKDIR, resources.node_file_directory.c_str());
+		if (status == 0)
+			status = CPXsetintparam(env, CPX_PARAM_PARALLELMODE, resources.deterministic ? CPX_PARALLEL_DETERMINISTIC : CPX_PARALLEL_OPPORTUNISTIC);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function apply_solver_resources(). \nCouldn't set the resource parameters. \nReason: " + std::string(error_text));
+		}
+	}
+#endif // ALG_USE_CPLEX
+
+
+	solver_resources share_solver_resources(const solver_resources& resources, int nb_threads, int nb_workers)
+	{
+		solver_resources worker_resources = resources;
+		nb_workers = std::max(1, nb_workers);
+		worker_resources.threads = std::max(1, nb_threads / nb_workers);
+		if (resources.working_memory > 0)
+			worker_resources.working_memory = resources.working_memory / nb_workers;
+		if (resources.tree_memory_limit > 0)
+			worker_resources.tree_memory_limit = resources.tree_memory_limit / nb_workers;
+		return worker_resources;
+	}
+
+
+	std::string describe_solver_resources(const solver_resources& resources)
+	{
+		std::string text = "threads " + (resources.threads > 0 ? std::to_string(resources.threads) : std::string("all"));
+		text += ", working memory " + (resources.working_memory > 0 ? std::to_string(resources.working_memory) + " MB" : std::string("default"));
+		text += ", tree memory limit " + (resources.tree_memory_limit > 0 ? std::to_string(resources.tree_memory_limit) + " MB" : std::string("none"));
+		text += ", node files " + std::to_string(resources.node_file);
+		if (!resources.node_file_directory.empty())
+			text += " in " + resources.node_file_directory;
+		text += resources.deterministic ? ", deterministic" : ", opportunistic";
+		return text;
+	}
+
+
+#ifdef ALG_USE_CPLEX
+	mip_progress_recorder::mip_progress_recorder(CPXENVptr env, mip_solve_trace& trace) : _env(env), _trace(trace)
+	{
+		_trace.points.clear();
+		_start = std::chrono::steady_clock::now();
+
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = CPXsetinfocallbackfunc(_env, info_callback, this);
+		if (status != 0)
+		{
+			CPXgeterrorstring(_env, status, error_text);
+			throw std::runtime_error("Error in function mip_progress_recorder::mip_progress_recorder(). \nCouldn't set the info callback. \nReason: " + std::string(error_text));
+		}
+	}
+
+
+	mip_progress_recorder::~mip_progress_recorder()
+	{
+		CPXsetinfocallbackfunc(_env, NULL, NULL);
+	}
+
+
+	void mip_progress_recorder::record(bool incumbent_exists, double incumbent, double bound, bool final)
+	{
+		mip_progress_point point;
+		point.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+		point.incumbent_exists = incumbent_exists;
+		point.incumbent = incumbent_exists ? incumbent : 0.0;
+		point.bound = bound;
+		if (incumbent_exists)
+			point.gap = std::fabs(incumbent - bound) / (1e-10 + std::fabs(incumbent)); // as CPLEX computes the relative gap
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!final && !_trace.points.empty())
+		{
+			const mip_progress_point& last = _trace.points.back();
+			if (last.incumbent_exists == point.incumbent_exists && last.incumbent == point.incumbent && last.bound == point.bound)
+				return;
+		}
+		_trace.points.push_back(point);
+	}
+
+
+	int CPXPUBLIC mip_progress_recorder::info_callback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle)
+	{
+		mip_progress_recorder* recorder = static_cast<mip_progress_recorder*>(cbhandle);
+		int feasible = 0;
+		double incumbent = 0.0;
+		double bound = 0.0;
+
+		int status = CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MIP_FEAS, &feasible);
+		if (status == 0 && feasible)
+			status = CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_INTEGER, &incumbent);
+		if (status == 0)
+			status = CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_REMAINING, &bound);
+		if (status == 0)
+			recorder->record(feasible != 0, incumbent, bound, false);
+
+		return status;
+	}
+
+
+	void mip_progress_recorder::finish(CPXCLPptr problem)
+	{
+		double incumbent = 0.0;
+		double bound = 0.0;
+		const bool incumbent_exists = (CPXgetobjval(_env, problem, &incumbent) == 0);
+		if (CPXgetbestobjval(_env, problem, &bound) != 0)
+			bound = incumbent;
+
+		record(incumbent_exists, incumbent, bound, true);
+	}
+#endif // ALG_USE_CPLEX
+
+
+	void write_progress_traces(const std::vector<mip_solve_trace>& traces, const std::string& file_name)
+	{
+		std::ofstream file(file_name);
+		if (!file.is_open())
+			throw std::runtime_error("Error in function write_progress_traces(). \nReason: Couldn't open file " + file_name + ".");
+
+		file << "solve,name,time,incumbent,bound,gap\n";
+		file << std::setprecision(10);
+		for (size_t i = 0; i < traces.size(); ++i)
+		{
+			for (auto&& point : traces[i].points)
+			{
+				file << i + 1 << ",\"" << traces[i].name << "\"," << point.time << ",";
+				if (point.incumbent_exists)
+					file << point.incumbent;
+				file << "," << point.bound << "," << point.gap << "\n";
+			}
+		}
+	}
+
+
+
+#ifdef ALG_USE_CPLEX
+	int separate_travel_constraints(CPXCENVptr env, void* cbdata, int wherefrom, const variable_layout& layout, const std::vector<double>& x,
+		const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room, const std::vector<int>& lecture_column, int* useraction_p)
+	{
+		constexpr double tolerance = 1e-6;
+		int status = 0;
+		int matind[3];
+		double matval[3];
+
+		// lectures per timeslot
+		std::vector<std::vector<int>> timeslot_lectures(nb_timeslots);
+		for (int l = 0; l < nb_sessions; ++l)
+			if (lecture_timeslot.at(l) >= 0 && lecture_room.at(l) >= 0)
+				timeslot_lectures.at(lecture_timeslot.at(l)).push_back(l);
+
+		for (int t = 0; t + 1 < nb_timeslots && status == 0; ++t)
+		{
+			for (int s = 0; s < nb_series && status == 0; ++s)
+			{
+				for (auto&& l : timeslot_lectures[t])
+				{
+					if (get_seriessession(s, l))
+					{
+						for (auto&& m : timeslot_lectures[t + 1])
+						{
+							if (get_seriessession(s, m))
+							{
+								const int c = lecture_room[l];
+								const int d = lecture_room[m];
+								for (int p = 0; p < nb_paths && status == 0; ++p)
+								{
+									const double fraction = get_roomroompath(c, d, p);
+									const int column_U = layout.index(variable_family::U_travel_tsp, t, s, p);
+
+									// both lectures are in these rooms, so the row reduces to U_tsp >= fraction
+									if (fraction > 0 && x.at(column_U) < fraction - tolerance)
+									{
+										matind[0] = lecture_column[l];
+										matval[0] = fraction;
+										matind[1] = lecture_column[m];
+										matval[1] = fraction;
+										matind[2] = column_U;
+										matval[2] = -1;
+
+										status = CPXcutcallbackadd(env, cbdata, wherefrom, 3, fraction, 'L', matind, matval, CPX_USECUT_FORCE);
+										*useraction_p = CPX_CALLBACK_SET;
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return status;
+	}
+#endif // ALG_USE_CPLEX
+
+
+
+	void column_fixing::fix(mip_backend& backend, const std::vector<int>& columns, const std::vector<double>& values)
+	{
+		if (columns.size() != values.size())
+			throw std::runtime_error("Error in function column_fixing::fix(). \nReason: The number of columns and values differ.");
+
+		if (is_fixed())
+			restore(backend);
+
+		if (columns.empty())
+			return;
+
+		// Remember the original bounds
+		std::vector<double> lb, ub;
+		backend.get_bounds(lb, ub);
+
+		_columns = columns;
+		_lb.clear();
+		_ub.clear();
+		_lb.reserve(columns.size());
+		_ub.reserve(columns.size());
+		for (auto&& column : columns)
+		{
+			_lb.push_back(lb.at(column));
+			_ub.push_back(ub.at(column));
+		}
+
+		// Set both bounds to the fixed value
+		std::vector<char> lu(columns.size(), 'B');
+		try
+		{
+			backend.change_bounds(static_cast<int>(columns.size()), columns.data(), lu.data(), values.data());
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+	}
+
+
+	void column_fixing::restore(mip_backend& backend)
+	{
+		if (!is_fixed())
+			return;
+
+		// Lower and upper bound of every fixed column
+		const size_t nb_fixed = _columns.size();
+		std::vector<int> indices(2 * nb_fixed);
+		std::vector<char> lu(2 * nb_fixed);
+		std::vector<double> bd(2 * nb_fixed);
+		for (size_t i = 0; i < nb_fixed; ++i)
+		{
+			indices[2 * i] = _columns[i];
+			lu[2 * i] = 'L';
+			bd[2 * i] = _lb[i];
+
+			indices[2 * i + 1] = _columns[i];
+			lu[2 * i + 1] = 'U';
+			bd[2 * i + 1] = _ub[i];
+		}
+
+		clear();
+		backend.change_bounds(static_cast<int>(indices.size()), indices.data(), lu.data(), bd.data());
+	}
+
+
+
+#ifdef ALG_USE_CPLEX
+	cplex_environment_pool::~cplex_environment_pool()
+	{
+		for (auto&& env : _environments)
+			CPXcloseCPLEX(&env);
+	}
+
+
+	cplex_environment_pool& cplex_environment_pool::get_instance()
+	{
+		static cplex_environment_pool pool;
+		return pool;
+	}
+
+
+	CPXENVptr cplex_environment_pool::acquire()
+	{
+		CPXENVptr env{ nullptr };
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_available.empty())
+			{
+				env = _available.back();
+				_available.pop_back();
+			}
+		}
+
+		int status = 0;
+		char error_text[CPXMESSAGEBUFSIZE];
+
+		if (env == nullptr)
+		{
+			// Open a new cplex environment (outside the lock, this may take a while)
+			env = CPXopenCPLEX(&status);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function cplex_environment_pool::acquire(). \nCouldn't open CPLEX. \nReason: " + std::string(error_text));
+			}
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_environments.push_back(env);
+		}
+
+		// Remove the settings and callbacks of the previous user
+		status = CPXsetdefaults(env);
+		if (status == 0)
+			status = CPXsetlazyconstraintcallbackfunc(env, NULL, NULL);
+		if (status == 0)
+			status = CPXsetinfocallbackfunc(env, NULL, NULL);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			release(env);
+			throw std::runtime_error("Error in function cplex_environment_pool::acquire(). \nCouldn't reset the CPLEX parameters. \nReason: " + std::string(error_text));
+		}
+
+		return env;
+	}
+
+
+	void cplex_environment_pool::release(CPXENVptr env)
+	{
+		if (env == nullptr)
+			return;
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (std::find(_environments.begin(), _environments.end(), env) == _environments.end())
+			throw std::runtime_error("Error in function cplex_environment_pool::release(). \nReason: The CPLEX environment was not acquired from this pool.");
+		_available.push_back(env);
+	}
+
+
+	size_t cplex_environment_pool::get_nb_environments()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _environments.size();
+	}
+#endif // ALG_USE_CPLEX
+
+} // namespace alg
@@ -0,0 +1,531 @@
+/*!
+*	@file	MIP_utilities.h
+*	@author		Hendrik Vermuyten
+*	@brief	Utilities shared by the MIP models.
+*/
+
+#ifndef MIP_UTILITIES_H
+#define MIP_UTILITIES_H
+
+#ifdef ALG_USE_CPLEX
+#include "ilcplex/cplex.h"
+#endif // ALG_USE_CPLEX
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+/*!
+*	@namespace	alg
+*	@brief	The main namespace containing all algorithm elements.
+*/
+namespace alg
+{
+	class mip_backend;
+
+	/*!
+	*	@brief	Compute the number of nonzero coefficients in the longest constraint on the timeslot assignment variables (x_ltc).
+	*	Covers the timetabling constraints (sets 1-7 and compactness) of the first stage and monolithic models.
+	*	@returns	The maximum row length over these constraint families.
+	*/
+	extern int max_row_length_timetable();
+
+	/*!
+	*	@brief	Compute the number of nonzero coefficients in the longest constraint on the room assignment, travel and evacuation variables.
+	*	Covers constraint sets 1-2 of the second stage model and constraint sets 8-19 of all models.
+	*	@returns	The maximum row length over these constraint families.
+	*/
+	extern int max_row_length_flows();
+
+	/*!
+	*	@brief	Determine for each session which evacuation paths can be used.
+	*	A path can be used by a session if it leads from one of the possible rooms of the session to the outside.
+	*	Only for these combinations the evacuation variables (U_evac_tlp and T_evac_total_tlp) are generated in the second stage models.
+	*	@returns	A vector of size nb_sessions * nb_paths, with element l * nb_paths + p true if session l can use path p.
+	*/
+	extern std::vector<bool> compute_session_evacuation_paths();
+
+	/*!
+	*	@brief	Compute the objective value for the preferences of a timetable.
+	*	@param	lecture_timeslot	A vector that gives the timeslot assigned to each lecture.
+	*	@returns	The sum of the (weighted) timeslot preferences of all lectures.
+	*/
+	extern int compute_preferences(const std::vector<int>& lecture_timeslot);
+
+	/*!
+	*	@brief	The families of decision variables in the MIP models.
+	*/
+	enum class variable_family
+	{
+		x_ltc,					///< Lecture l assigned to timeslot t and room c
+		w_lc,					///< Lecture l assigned to room c
+		U_travel_tsp,			///< Series s uses path p after timeslot t
+		T_travel_arc_tij,		///< Travel time through arc ij after timeslot t
+		T_travel_total_tsp,		///< Travel time of series s on path p after timeslot t
+		T_travel_max_t,			///< Maximum travel time after timeslot t
+		U_evac_tlp,				///< Lecture l uses path p to evacuate in timeslot t
+		T_evac_arc_tij,			///< Evacuation time through arc ij in timeslot t
+		T_evac_total_tlp,		///< Evacuation time of lecture l on path p in timeslot t
+		T_evac_max_t,			///< Maximum evacuation time in timeslot t
+		T_travel_max_overall,	///< Maximum travel time over all timeslots
+		T_evac_max_overall,		///< Maximum evacuation time over all timeslots
+		nb_families,			///< Number of variable families
+	};
+
+	/*!
+	*	@brief	Registry of the column indices of the variable families in a CPLEX problem.
+	*	The base index and shape of each family are recorded as its columns are created,
+	*	so that constraints, objective updates and solution extraction never rely on hand-computed offsets.
+	*	Columns that are never created are reported as missing.
+	*/
+	class variable_layout
+	{
+		/*!
+		*	@brief	The column indices of a single variable family.
+		*/
+		struct family_columns
+		{
+			int base = -1;				///< Index of the first column of the family
+			int dim1 = 0;				///< Size of the first dimension
+			int dim2 = 0;				///< Size of the second dimension
+			int dim3 = 0;				///< Size of the third dimension
+			std::vector<int> columns;	///< Column index of each element, -1 if the element was not created
+		};
+
+		/*!
+		*	@brief	The registered families.
+		*/
+		std::vector<family_columns> _families;
+
+		/*!
+		*	@brief	The number of columns created so far.
+		*/
+		int _nb_columns = 0;
+
+	public:
+		/*!
+		*	@brief	Default constructor.
+		*/
+		variable_layout() : _families(static_cast<size_t>(variable_family::nb_families)) { }
+
+		/*!
+		*	@brief	Remove all registered families.
+		*/
+		void clear();
+
+		/*!
+		*	@brief	Register a variable family. Its columns are to be added next.
+		*	@param	family	The variable family.
+		*	@param	dim1	Size of the first dimension.
+		*	@param	dim2	Size of the second dimension.
+		*	@param	dim3	Size of the third dimension.
+		*/
+		void add_family(variable_family family, int dim1 = 1, int dim2 = 1, int dim3 = 1);
+
+		/*!
+		*	@brief	Record that the column for the given element is the next column of the problem.
+		*	Must be called once for every column added to the problem, in the same order.
+		*	@param	family	The variable family.
+		*	@param	i	First index.
+		*	@param	j	Second index.
+		*	@param	k	Third index.
+		*	@returns	The column index of the element.
+		*/
+		int add_column(variable_family family, int i = 0, int j = 0, int k = 0);
+
+		/*!
+		*	@brief	Get the column index of an element of a variable family.
+		*	@param	family	The variable family.
+		*	@param	i	First index.
+		*	@param	j	Second index.
+		*	@param	k	Third index.
+		*	@returns	The column index, or -1 if the element has not been created.
+		*/
+		int index(variable_family family, int i = 0, int j = 0, int k = 0) const;
+
+		/*!
+		*	@brief	Check whether the column for an element of a variable family has been created.
+		*	@param	family	The variable family.
+		*	@param	i	First index.
+		*	@param	j	Second index.
+		*	@param	k	Third index.
+		*	@returns	True if the column exists, false otherwise.
+		*/
+		bool exists(variable_family family, int i = 0, int j = 0, int k = 0) const { return index(family, i, j, k) >= 0; }
+
+		/*!
+		*	@brief	Get the index of the first column of a variable family.
+		*	@param	family	The variable family.
+		*	@returns	The index of the first column, or -1 if the family has not been registered.
+		*/
+		int get_base(variable_family family) const { return _families.at(static_cast<size_t>(family)).base; }
+
+		/*!
+		*	@brief	Get the number of columns created so far.
+		*	@returns	The number of columns.
+		*/
+		int get_nb_columns() const { return _nb_columns; }
+
+		/*!
+		*	@brief	Write the registered families to a stream, to store them next to a cached model.
+		*	@param	out	The output stream.
+		*/
+		void write(std::ostream& out) const;
+
+		/*!
+		*	@brief	Read the registered families from a stream written by write().
+		*	@param	in	The input stream.
+		*	@returns	True if successful. Otherwise the layout is cleared and false is returned.
+		*/
+		bool read(std::istream& in);
+	};
+
+
+	/*!
+	*	@brief	Compute the key of a cached model: a hash of the instance data (timetable and building) and the parameters of the model.
+	*	Cached models must be removed when the formulation of a model changes.
+	*	@param	model_name	The name of the model.
+	*	@param	parameters	The parameters that change the model (e.g. objective weights and options).
+	*	@param	data		Other data the model depends on (e.g. the timetable of a second stage model).
+	*	@returns	The key, which is used as file name.
+	*/
+	extern std::string model_cache_key(const std::string& model_name, const std::vector<double>& parameters, const std::vector<int>& data = std::vector<int>());
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	Read a cached model (a SAV file and the column layout) into a CPLEX problem.
+	*	@param	env			The CPLEX environment.
+	*	@param	problem		The CPLEX problem, which is replaced by the cached model.
+	*	@param	layout		Column indices of the variable families, read from the cache.
+	*	@param	directory	The directory of the cache.
+	*	@param	key			The key of the model.
+	*	@returns	True if the model was found and read, false if it has to be built.
+	*/
+	extern bool read_cached_model(CPXENVptr env, CPXLPptr problem, variable_layout& layout, const std::string& directory, const std::string& key);
+
+	/*!
+	*	@brief	Write a built model (a SAV file and the column layout) to the cache.
+	*	The files are written under a temporary name and then renamed, so that concurrent builds never leave a partial model in the cache.
+	*	@param	env			The CPLEX environment.
+	*	@param	problem		The CPLEX problem.
+	*	@param	layout		Column indices of the variable families in the problem.
+	*	@param	directory	The directory of the cache, which must exist.
+	*	@param	key			The key of the model.
+	*/
+	extern void write_cached_model(CPXENVptr env, CPXLPptr problem, const variable_layout& layout, const std::string& directory, const std::string& key);
+
+
+	/*!
+	*	@brief	Add a MIP start to a CPLEX problem. Values of the columns that are not given are completed by CPLEX,
+	*	and an infeasible start is repaired if possible.
+	*	@param	env		The CPLEX environment.
+	*	@param	problem	The CPLEX problem.
+	*	@param	columns	The column indices.
+	*	@param	values	The value of each column.
+	*	@param	name	The name of the MIP start.
+	*/
+	extern void add_mip_start(CPXENVptr env, CPXLPptr problem, const std::vector<int>& columns, const std::vector<double>& values, const std::string& name);
+
+	/*!
+	*	@brief	Remove all MIP starts from a CPLEX problem.
+	*	@param	env		The CPLEX environment.
+	*	@param	problem	The CPLEX problem.
+	*/
+	extern void clear_mip_starts(CPXENVptr env, CPXLPptr problem);
+#endif // ALG_USE_CPLEX
+
+	/*!
+	*	@brief	The computing resources of a MIP solve, so that several solves, or a solve next to the heuristic, share a machine predictably.
+	*/
+	struct solver_resources
+	{
+		int threads = 0;						///< Number of threads, 0: decided by the solver (all cores)
+		double working_memory = 0;				///< Working memory (in MB) before nodes are moved to node files, 0: solver default
+		double tree_memory_limit = 0;			///< Limit on the size of the branch-and-bound tree (in MB), 0: no limit
+		int node_file = 1;						///< Node files: 0 none, 1 in memory and compressed, 2 on disk, 3 on disk and compressed
+		std::string node_file_directory;		///< Directory for the node files, empty: solver default
+		bool deterministic = true;				///< Deterministic (reproducible) parallel search, false: opportunistic
+	};
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	Apply the resource settings to a CPLEX environment.
+	*	@param	env			The CPLEX environment.
+	*	@param	resources	The resource settings.
+	*/
+	extern void apply_solver_resources(CPXENVptr env, const solver_resources& resources);
+#endif // ALG_USE_CPLEX
+
+	/*!
+	*	@brief	Divide a resource budget evenly over workers that solve in parallel.
+	*	@param	resources	The resource budget of all workers together.
+	*	@param	nb_threads	The number of threads of all workers together.
+	*	@param	nb_workers	The number of workers.
+	*	@returns	The resource settings of one worker.
+	*/
+	extern solver_resources share_solver_resources(const solver_resources& resources, int nb_threads, int nb_workers);
+
+	/*!
+	*	@brief	Describe the resource settings, for the output.
+	*	@param	resources	The resource settings.
+	*	@returns	The description.
+	*/
+	extern std::string describe_solver_resources(const solver_resources& resources);
+
+	/*!
+	*	@brief	A solution on the trade-off between the objectives, found for one set of objective weights.
+	*/
+	struct pareto_point
+	{
+		double lambda = 1;						///< Relative value of the preferences (lambda) and the travel or evacuation times (1 - lambda)
+		double alpha = 1;						///< Relative value of the evacuation times (alpha) and the travel times (1 - alpha)
+		double epsilon = 0;						///< Right-hand side of the constraint on the preferences (epsilon-constraint method only)
+		bool solution_exists = false;			///< Indicates whether a solution exists
+		std::string solution_info;				///< Information on the CPLEX solution status
+		double objective_value = 0;				///< Objective value of the CPLEX solution
+		int preferences = 0;					///< Objective value for the preferences
+		std::vector<double> travel_times;		///< Travel time between each pair of consecutive timeslots
+		std::vector<double> evacuation_times;	///< Evacuation time for each timeslot
+		std::vector<int> lecture_timeslot;		///< Timeslot assigned to each lecture
+		std::vector<int> lecture_room;			///< Room assigned to each lecture
+		double computation_time = 0;			///< Computation time for this point (in seconds)
+	};
+
+	/*!
+	*	@brief	The progress of a MIP solve at one moment.
+	*/
+	struct mip_progress_point
+	{
+		double time = 0;						///< Time since the start of the solve (in seconds)
+		bool incumbent_exists = false;			///< Indicates whether an incumbent has been found
+		double incumbent = 0;					///< Objective value of the incumbent
+		double bound = 0;						///< Best bound on the objective value
+		double gap = 1;							///< Relative gap between incumbent and bound (1 without incumbent)
+	};
+
+	/*!
+	*	@brief	The progress of one MIP solve: a point every time the incumbent or the bound improves, and a final point.
+	*/
+	struct mip_solve_trace
+	{
+		std::string name;						///< The solved problem
+		std::vector<mip_progress_point> points;	///< The progress, in order of time
+	};
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	Records the progress of a CPLEX MIP solve into a trace with an info callback.
+	*	The callback is installed on the environment by the constructor and removed by the destructor,
+	*	so a recorder lives on the stack around the call to CPXmipopt.
+	*/
+	class mip_progress_recorder
+	{
+		/*!
+		*	@brief	The CPLEX environment.
+		*/
+		CPXENVptr _env;
+
+		/*!
+		*	@brief	The trace that is recorded.
+		*/
+		mip_solve_trace& _trace;
+
+		/*!
+		*	@brief	The start of the solve.
+		*/
+		std::chrono::steady_clock::time_point _start;
+
+		/*!
+		*	@brief	Protects the trace, the callback can be called by several threads of CPLEX.
+		*/
+		std::mutex _mutex;
+
+		/*!
+		*	@brief	Add a point to the trace if the incumbent or the bound has changed.
+		*	@param	incumbent_exists	Indicates whether an incumbent has been found.
+		*	@param	incumbent	Objective value of the incumbent.
+		*	@param	bound		Best bound on the objective value.
+		*	@param	final		True to add the point even if nothing has changed.
+		*/
+		void record(bool incumbent_exists, double incumbent, double bound, bool final);
+
+		/*!
+		*	@brief	The CPLEX info callback.
+		*	@param	env			The CPLEX environment.
+		*	@param	cbdata		The callback data of CPLEX.
+		*	@param	wherefrom	Where in the optimization the callback is called.
+		*	@param	cbhandle	The recorder.
+		*	@returns	0 if successful, the CPLEX error code otherwise.
+		*/
+		static int CPXPUBLIC info_callback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle);
+
+	public:
+		/*!
+		*	@brief	Constructor. Starts recording the solves in the given environment.
+		*	@param	env		The CPLEX environment.
+		*	@param	trace	The trace to record into.
+		*/
+		mip_progress_recorder(CPXENVptr env, mip_solve_trace& trace);
+
+		/*!
+		*	@brief	Destructor. Stops recording.
+		*/
+		~mip_progress_recorder();
+
+		mip_progress_recorder(const mip_progress_recorder&) = delete;
+		mip_progress_recorder& operator=(const mip_progress_recorder&) = delete;
+
+		/*!
+		*	@brief	Add the final point, after the solve has finished.
+		*	@param	problem	The CPLEX problem that was solved.
+		*/
+		void finish(CPXCLPptr problem);
+	};
+#endif // ALG_USE_CPLEX
+
+	/*!
+	*	@brief	Write progress traces to a file, one line per point (comma-separated values).
+	*	@param	traces		The traces.
+	*	@param	file_name	The name of the file.
+	*/
+	extern void write_progress_traces(const std::vector<mip_solve_trace>& traces, const std::string& file_name);
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	Separate the violated travel constraints (constraint set 8) for an integer solution in a CPLEX lazy constraint callback.
+	*	For every series, every pair of its lectures in consecutive timeslots and every path between their rooms,
+	*	the path must be used by the series (U_tsp) if both lectures are in these rooms. Violated rows are added to the problem.
+	*	@param	env					The CPLEX environment of the callback.
+	*	@param	cbdata				The callback data.
+	*	@param	wherefrom			Where the callback was called from.
+	*	@param	layout				Column indices of the variable families in the problem.
+	*	@param	x					The values of the columns in the integer solution.
+	*	@param	lecture_timeslot	The timeslot of each lecture in the solution.
+	*	@param	lecture_room		The room of each lecture in the solution.
+	*	@param	lecture_column		The column of the assignment variable (x_ltc or w_lc) that is 1 for each lecture in the solution.
+	*	@param	useraction_p		Set to CPX_CALLBACK_SET if rows are added.
+	*	@returns	0 if successful, the CPLEX error code otherwise.
+	*/
+	extern int separate_travel_constraints(CPXCENVptr env, void* cbdata, int wherefrom, const variable_layout& layout, const std::vector<double>& x,
+		const std::vector<int>& lecture_timeslot, const std::vector<int>& lecture_room, const std::vector<int>& lecture_column, int* useraction_p);
+#endif // ALG_USE_CPLEX
+
+	/*!
+	*	@brief	Fixes a set of columns of a MIP problem to given values by changing their bounds,
+	*	and restores the original bounds afterwards. The rows of the problem are never changed.
+	*/
+	class column_fixing
+	{
+		/*!
+		*	@brief	The fixed columns.
+		*/
+		std::vector<int> _columns;
+
+		/*!
+		*	@brief	The original lower bounds of the fixed columns.
+		*/
+		std::vector<double> _lb;
+
+		/*!
+		*	@brief	The original upper bounds of the fixed columns.
+		*/
+		std::vector<double> _ub;
+
+	public:
+		/*!
+		*	@brief	Fix columns to the given values, in a single call to the solver.
+		*	Columns that are still fixed from a previous call are restored first.
+		*	@param	backend	The problem.
+		*	@param	columns	The column indices.
+		*	@param	values	The value of each column.
+		*/
+		void fix(mip_backend& backend, const std::vector<int>& columns, const std::vector<double>& values);
+
+		/*!
+		*	@brief	Restore the original bounds of the fixed columns, in a single call to the solver.
+		*	@param	backend	The problem.
+		*/
+		void restore(mip_backend& backend);
+
+		/*!
+		*	@brief	Forget the fixed columns without restoring them, e.g. when the problem has been freed.
+		*/
+		void clear() { _columns.clear(); _lb.clear(); _ub.clear(); }
+
+		/*!
+		*	@brief	Check whether columns are currently fixed.
+		*	@returns	True if columns are fixed, false otherwise.
+		*/
+		bool is_fixed() const { return !_columns.empty(); }
+	};
+
+#ifdef ALG_USE_CPLEX
+	/*!
+	*	@brief	Process-wide pool of CPLEX environments.
+	*	Environments are opened on first demand and kept open until the end of the process,
+	*	so that repeated runs of the MIP models do not pay for opening CPLEX (and checking the licence) every time.
+	*	Acquiring and releasing environments is thread-safe. An environment is used by one thread at a time.
+	*/
+	class cplex_environment_pool
+	{
+		/*!
+		*	@brief	Protects the lists of environments.
+		*/
+		std::mutex _mutex;
+
+		/*!
+		*	@brief	All environments opened by the pool.
+		*/
+		std::vector<CPXENVptr> _environments;
+
+		/*!
+		*	@brief	The environments that are currently not in use.
+		*/
+		std::vector<CPXENVptr> _available;
+
+		/*!
+		*	@brief	Default constructor. Use get_instance() to access the pool.
+		*/
+		cplex_environment_pool() = default;
+
+	public:
+		/*!
+		*	@brief	Destructor. Closes all environments.
+		*/
+		~cplex_environment_pool();
+
+		cplex_environment_pool(const cplex_environment_pool&) = delete;
+		cplex_environment_pool& operator=(const cplex_environment_pool&) = delete;
+
+		/*!
+		*	@brief	Get the pool of the process.
+		*	@returns	The pool.
+		*/
+		static cplex_environment_pool& get_instance();
+
+		/*!
+		*	@brief	Acquire an environment. An unused environment is reused if available, otherwise a new one is opened.
+		*	All parameters of the environment are reset to their default values and its callbacks are removed.
+		*	@returns	The environment.
+		*/
+		CPXENVptr acquire();
+
+		/*!
+		*	@brief	Return an environment to the pool. All problems created in it must have been freed.
+		*	@param	env	The environment, which has been acquired from this pool.
+		*/
+		void release(CPXENVptr env);
+
+		/*!
+		*	@brief	Get the number of environments opened by the pool.
+		*	@returns	The number of environments.
+		*/
+		size_t get_nb_environments();
+	};
+#endif // ALG_USE_CPLEX
+
+} // namespace alg
+
+#endif // !MIP_UTILITIES_H
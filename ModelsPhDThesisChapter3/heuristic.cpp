@@ -4,14 +4,18 @@
 #include "initial_solution.h"
 #include "logger.h"
 #include "MIP_two_stage.h"
+#include "MIP_monolithic.h"
 
 #include <iostream>
 #include <random>
+#include <cmath>
 #include <utility>
 #include <thread>
-#include <future>
 #include <mutex>
 #include <string>
+#include <chrono>
+#include <algorithm>
+#include <memory>
 
 
 
@@ -361,7 +365,15 @@ namespace alg
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	double heuristic_master::_probability_move[3] = { 0.6, 0.38, 0.02 };
+	size_t heuristic_master::_batch_size = 1;
+	heuristic_master::batch_selection heuristic_master::_batch_selection = heuristic_master::batch_selection::best;
+	size_t heuristic_master::_kempe_nb_threads = 1;
+	size_t heuristic_master::_kempe_parallel_min_chains = 16;
+	neighbourhood_registry heuristic_master::_neighbourhoods = neighbourhood_registry::create_default();
+	heuristic_master::neighbourhood_selection heuristic_master::_neighbourhood_selection = heuristic_master::neighbourhood_selection::fixed;
+	size_t heuristic_master::_adaptive_segment = 1000;
+	double heuristic_master::_adaptive_reaction = 0.2;
+	double heuristic_master::_adaptive_min_probability = 0.02;
 	bool heuristic_master::_constraint_preferences = false;
 	bool heuristic_master::_constraint_preferences_value = 1e20;
 	double heuristic_master::_lambda = 0;
@@ -370,10 +382,22 @@ namespace alg
 	double heuristic_master::_penalty_value_constraint_violation = 10000;
 	size_t heuristic_master::_nb_threads = 8;
 	size_t heuristic_master::_nb_synchronizations = 40;
-	double heuristic_master::_SA_temperature = 1;
+	heuristic_master::synchronization_type heuristic_master::_synchronization_type = heuristic_master::synchronization_type::best_solution;
+	heuristic_master::migration_topology heuristic_master::_migration_topology = heuristic_master::migration_topology::ring;
+	size_t heuristic_master::_migration_tournament_size = 3;
+	size_t heuristic_master::_migration_interval = 5000;
+	double heuristic_master::_SA_temperature = 0.01;
 	double heuristic_master::_SA_alpha = 0.5;
-	double heuristic_master::_SA_start_temperature = 1;
-	double heuristic_master::_SA_Tmin = 0.1;
+	double heuristic_master::_SA_start_temperature = 0.01;
+	double heuristic_master::_SA_Tmin = 0.0001;
+	heuristic_master::cooling_schedule heuristic_master::_cooling_schedule = heuristic_master::cooling_schedule::per_synchronization;
+	size_t heuristic_master::_cooling_interval = 1000;
+	size_t heuristic_master::_SA_cooling_iterations = 1000000;
+	double heuristic_master::_SA_target_acceptance_rate = 0.1;
+	double heuristic_master::_SA_adaptive_factor = 0.95;
+	bool heuristic_master::_MIP_polish = false;
+	double heuristic_master::_MIP_polish_time_limit = 600;
+	solver_resources heuristic_master::_MIP_resources;
 
 
 
@@ -397,17 +421,79 @@ namespace alg
 		else
 			text += "sum over timeslots";
 		text += "\n\tTime limit (seconds): " + std::to_string(_time_limit);
+		text += "\nCandidate moves per iteration: " + std::to_string(_batch_size);
+		if (_batch_size > 1)
+			text += (_batch_selection == batch_selection::best) ? " (best candidate)" : " (first acceptable candidate)";
+		text += "\nNeighbourhood selection: ";
+		if (_neighbourhood_selection == neighbourhood_selection::fixed)
+			text += "fixed probabilities";
+		else
+			text += "adaptive, segment " + std::to_string(_adaptive_segment) + " iterations, reaction " + std::to_string(_adaptive_reaction) + ", minimum probability " + std::to_string(_adaptive_min_probability);
+		if (_kempe_nb_threads > 1)
+			text += "\nKempe chains evaluated with " + std::to_string(_kempe_nb_threads) + " threads from " + std::to_string(_kempe_parallel_min_chains) + " chains";
 		text += "\nS.A. parameters:";
 		text += "\n\tInitial temperature: " + std::to_string(_SA_start_temperature);
 		text += "\n\tTemperature alpha: " + std::to_string(_SA_alpha);
 		text += "\n\tTmin: " + std::to_string(_SA_Tmin);
+		text += "\n\tCooling schedule: ";
+		if (_cooling_schedule == cooling_schedule::per_synchronization)
+			text += "per synchronization";
+		else
+		{
+			if (_cooling_schedule == cooling_schedule::geometric)
+				text += "geometric over " + std::to_string(_SA_cooling_iterations) + " iterations";
+			else if (_cooling_schedule == cooling_schedule::linear)
+				text += "linear over " + std::to_string(_SA_cooling_iterations) + " iterations";
+			else
+				text += "adaptive, target acceptance rate " + std::to_string(_SA_target_acceptance_rate) + ", factor " + std::to_string(_SA_adaptive_factor);
+			text += "\n\tCooling interval (iterations): " + std::to_string(_cooling_interval);
+		}
 		text += "\nMultithreading parameters: ";
 		text += "\n\tNumber of threads: " + std::to_string(_nb_threads);
 		text += "\n\tNumber of synchronizations: " + std::to_string(_nb_synchronizations);
+		if (_synchronization_type == synchronization_type::best_solution)
+			text += "\n\tSynchronization: all threads continue from the best solution";
+		else if (_synchronization_type == synchronization_type::parallel_tempering)
+			text += "\n\tSynchronization: parallel tempering on a geometric temperature ladder";
+		else
+		{
+			text += "\n\tSynchronization: asynchronous island model";
+			text += "\n\tMigration topology: ";
+			if (_migration_topology == migration_topology::ring)
+				text += "ring";
+			else if (_migration_topology == migration_topology::random)
+				text += "random";
+			else
+				text += "best of " + std::to_string(_migration_tournament_size);
+			text += "\n\tMigration interval (iterations): " + std::to_string(_migration_interval);
+		}
+		if (_MIP_polish)
+			text += "\nMIP polishing time limit (seconds): " + std::to_string(_MIP_polish_time_limit);
+		text += "\nMIP solver resources: " + describe_solver_resources(_MIP_resources);
 
 		// 4. results
 		text += "\nIterations: " + std::to_string(total_iterations);
 		text += "\nReheats: " + std::to_string(reheats);
+		for (size_t m = 0; m < total_move_statistics.size(); ++m)
+		{
+			const move_statistics& stats = total_move_statistics.at(m);
+			text += "\n" + std::string(_neighbourhoods.get_neighbourhood(m).get_name()) + ": attempted " + std::to_string(stats.attempted)
+				+ ", accepted improving " + std::to_string(stats.accepted_improving)
+				+ ", accepted worsening " + std::to_string(stats.accepted_worsening);
+			if (stats.attempted > 0)
+				text += " (acceptance rate " + std::to_string(static_cast<double>(stats.accepted_improving + stats.accepted_worsening) / stats.attempted) + ")";
+			if (_neighbourhood_selection == neighbourhood_selection::adaptive && !threads.empty())
+			{
+				double probability = 0;
+				for (auto&& thread : threads)
+					probability += thread.get_neighbourhood_probability(m);
+				text += ", final probability " + std::to_string(probability / threads.size());
+			}
+		}
+		if (_synchronization_type == synchronization_type::island_model)
+			text += "\nAccepted migrants: " + std::to_string(total_migrations);
+		if (_synchronization_type == synchronization_type::parallel_tempering)
+			text += "\nReplica swaps (accepted/attempted): " + std::to_string(replica_swaps_accepted) + "/" + std::to_string(replica_swaps_attempted);
 		text += "\nObjective value best found solution: " + std::to_string(best_objective);
 
 		// 5. solution
@@ -434,12 +520,23 @@ namespace alg
 
 	void heuristic_master::run()
 	{
+		// 0. check the neighbourhoods
+		{
+			double total_probability = 0;
+			for (size_t n = 0; n < _neighbourhoods.size(); ++n)
+				total_probability += _neighbourhoods.get_probability(n);
+			if (_neighbourhoods.size() == 0 || (_neighbourhood_selection == neighbourhood_selection::fixed && total_probability <= 0))
+				throw std::runtime_error("Error in function heuristic_master::run(). \nReason: no neighbourhood with a positive probability.");
+			total_move_statistics.assign(_neighbourhoods.size(), move_statistics());
+		}
+
 		// 1. start timer
 		std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
 
 		// 2. constructive method: MIP
 		{
 			MIP_two_stage MIP;
+			MIP._resources = _MIP_resources;
 			MIP.run_only_first_stage();
 			if (!MIP.get_solution_firststage_exists())
 				throw std::runtime_error("Error in function heuristic::run(). \nCouldn't construct a feasible solution.");
@@ -486,24 +583,45 @@ namespace alg
 
 
 		// 3. create subprocesses
-		std::vector<std::future<double>> results_threads;
 		std::vector<double> objective_values_threads;
 		for (int i = 0; i < _nb_threads; ++i)
 		{
 			threads.push_back(heuristic_subprocess());
 			threads.back()._process_id = i;
-			threads.back().initialize();
+			threads.back().initialize(generator());
 			threads.back().set_solution(best_solution, info_objval);
-			results_threads.push_back(std::future<double>());
 			objective_values_threads.push_back(1e20);
 		}
+		if (_synchronization_type == synchronization_type::island_model)
+		{
+			elites.initialize(_nb_threads);
+			for (auto&& thread : threads)
+				thread._elite_pool = &elites;
+		}
 
 
 		// 4. repeat until timeout
 		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
 		double time_per_process = (_time_limit - elapsed_time.count()) / _nb_synchronizations;
 
+		// the workers stay alive for the whole search: every epoch the master lets each of them run its subprocess and waits until all have finished, 
+		// after which it synchronizes the solutions (an exception of a worker is rethrown here, and the workers are joined on any exit path)
+		worker_group workers(_nb_threads);
+		auto epoch = [this, time_per_process, &objective_values_threads](size_t i)
+		{
+			objective_values_threads.at(i) = threads.at(i).run(time_per_process);
+		};
+
 		_SA_temperature = _SA_start_temperature;
+		if (_synchronization_type == synchronization_type::parallel_tempering)
+			initialize_temperature_ladder();
+		else
+		{
+			for (auto&& thread : threads)
+				thread.set_temperature(_SA_temperature);
+		}
+
+		size_t nb_epochs = 0;
 		while (true)
 		{
 			// time check
@@ -513,21 +631,18 @@ namespace alg
 			{
 				output_text = "\n\nLAHC heuristic has reached time limit of " + std::to_string(_time_limit) + " seconds.";
 				std::cout << output_text;
+
 				break;
 			}
 
 			// run threads with specified time limit
-			for (int i = 0; i < _nb_threads; ++i)
-			{
-				results_threads.at(i) = std::async(std::launch::async, &heuristic_subprocess::run, &threads.at(i), time_per_process);
-			}
+			workers.run_round(epoch);
 
 			// find best solution over all threads
 			int best_index = -1;
 			double best_objval = 1e20;
 			for (int i = 0; i < _nb_threads; ++i)
 			{
-				objective_values_threads.at(i) = results_threads.at(i).get();
 				if (objective_values_threads.at(i) < best_objval)
 				{
 					best_objval = objective_values_threads.at(i);
@@ -538,24 +653,44 @@ namespace alg
 			output_text = "\n\n\n\n\nBest solution found by thread " + std::to_string(best_index) + ", with objective value = " + std::to_string(objective_values_threads.at(best_index));
 			std::cout << output_text;
 
-			// set current solution of all threads equal to this best found solution
-			for (int i = 0; i < _nb_threads; ++i)
+			// parallel tempering: the replicas keep their solutions, only adjacent temperatures are swapped
+			if (_synchronization_type == synchronization_type::parallel_tempering)
 			{
-				threads.at(i).set_solution(threads.at(best_index).get_best_solution(), threads.at(best_index).get_best_objective_value());
-			}
+				exchange_replicas(nb_epochs % 2 == 1);
+				++nb_epochs;
 
-			// update the temperature
-			_SA_temperature *= _SA_alpha;
-			if (_SA_temperature < _SA_Tmin)
-			{
-				_SA_temperature = _SA_start_temperature;
-				++reheats;
+				output_text = "\n\nReplica swaps (accepted/attempted): " + std::to_string(replica_swaps_accepted) + "/" + std::to_string(replica_swaps_attempted) + "\n\n\n";
+				std::cout << output_text;
 			}
+			else
+			{
+				// set current solution of all threads equal to this best found solution
+				// (in the island model the threads keep their own solution and exchange solutions through the elite pool instead)
+				if (_synchronization_type == synchronization_type::best_solution)
+				{
+					for (int i = 0; i < _nb_threads; ++i)
+					{
+						threads.at(i).set_solution(threads.at(best_index).get_best_solution(), threads.at(best_index).get_best_objective_value());
+					}
+				}
 
-			output_text = "\n\nUpdating temperature: T' = " + std::to_string(_SA_temperature) + "\n\n\n";
-			std::cout << output_text;
-		}
+				// update the temperature (iteration-based cooling schedules are handled by the subprocesses themselves)
+				if (_cooling_schedule == cooling_schedule::per_synchronization)
+				{
+					_SA_temperature *= _SA_alpha;
+					if (_SA_temperature < _SA_Tmin)
+					{
+						_SA_temperature = _SA_start_temperature;
+						++reheats;
+					}
+					for (auto&& thread : threads)
+						thread.set_temperature(_SA_temperature);
 
+					output_text = "\n\nUpdating temperature: T' = " + std::to_string(_SA_temperature) + "\n\n\n";
+					std::cout << output_text;
+				}
+			}
+		}
 
 		// 5. return best found solution
 		// find best solution over all threads
@@ -571,6 +706,10 @@ namespace alg
 			}
 
 			total_iterations += threads.at(i).get_iterations();
+			total_migrations += threads.at(i).get_migrations();
+			reheats += threads.at(i).get_reheats();
+			for (size_t m = 0; m < total_move_statistics.size(); ++m)
+				total_move_statistics.at(m) += threads.at(i).get_move_statistics(m);
 		}
 
 		best_solution = threads.at(best_index).get_best_solution();
@@ -590,16 +729,169 @@ namespace alg
 		evaluate(best_solution, info);
 		info.print();
 
-		// 6. write output
+		// 6. hybrid mode: polish the best found solution with the MIP
+		if (_MIP_polish)
+			polish_with_MIP();
+
+		// 7. write output
 		write_output();
 	}
 
 
 
+	void heuristic_master::initialize_temperature_ladder()
+	{
+		// geometric ladder: T_k = T_start * (T_min / T_start)^(k / (n - 1))
+		temperature_ladder.clear();
+		for (size_t k = 0; k < threads.size(); ++k)
+		{
+			double fraction = threads.size() > 1 ? static_cast<double>(k) / (threads.size() - 1) : 0.0;
+			threads.at(k).set_temperature(_SA_start_temperature * std::pow(_SA_Tmin / _SA_start_temperature, fraction));
+			temperature_ladder.push_back(k);
+		}
+	}
+
+
+
+	void heuristic_master::exchange_replicas(bool odd_pairs)
+	{
+		std::uniform_real_distribution<double> prob_dist(0, 1);
+
+		for (size_t k = odd_pairs ? 1 : 0; k + 1 < temperature_ladder.size(); k += 2)
+		{
+			heuristic_subprocess& hot = threads.at(temperature_ladder.at(k));
+			heuristic_subprocess& cold = threads.at(temperature_ladder.at(k + 1));
+
+			// Metropolis criterion on the relative objective values, the same scale as the acceptance of the moves:
+			// accept with probability min(1, exp((E_cold - E_hot) / E_cold * (1/T_cold - 1/T_hot)))
+			double relative_difference = (cold.get_current_objective_value() - hot.get_current_objective_value()) / cold.get_current_objective_value();
+			double exponent = relative_difference * (1.0 / cold.get_temperature() - 1.0 / hot.get_temperature());
+
+			++replica_swaps_attempted;
+			if (exponent >= 0 || prob_dist(generator) < std::exp(exponent))
+			{
+				// the replicas swap temperatures, so their solutions move along the ladder
+				double temperature_hot = hot.get_temperature();
+				hot.set_temperature(cold.get_temperature());
+				cold.set_temperature(temperature_hot);
+				std::swap(temperature_ladder.at(k), temperature_ladder.at(k + 1));
+				++replica_swaps_accepted;
+			}
+		}
+	}
+
+
+
+	void heuristic_master::polish_with_MIP()
+	{
+		// 1. best found solution as timeslot and room per lecture
+		std::vector<int> lecture_timeslot(nb_sessions, -1);
+		std::vector<int> lecture_room(nb_sessions, -1);
+		for (int t = 0; t < nb_timeslots; ++t)
+		{
+			for (int r = 0; r < nb_locations; ++r)
+			{
+				int l = best_solution.at(t, r);
+				if (l >= 0)
+				{
+					lecture_timeslot.at(l) = t;
+					lecture_room.at(l) = r;
+				}
+			}
+		}
+
+		// 2. solve the monolithic MIP starting from this solution
+		MIP_monolithic MIP;
+		MIP._lambda = _lambda;
+		MIP._time_limit = _MIP_polish_time_limit;
+		MIP._resources = _MIP_resources;
+		if (_objective_type == objective_type::maximum_over_timeslots)
+			MIP._objective_type = MIP_monolithic::objective_type::maximum_over_timeslots;
+		else
+			MIP._objective_type = MIP_monolithic::objective_type::sum_over_timeslots;
+		MIP.set_mip_start(lecture_timeslot, lecture_room);
+		MIP.run_algorithm(false, false);
+
+		if (!MIP.get_solution_exists())
+			return;
+
+		// 3. keep the MIP solution if it is better w.r.t. the heuristic's objective
+		matrix2D<int> polished_solution;
+		polished_solution.set(nb_timeslots, nb_locations, -1);
+		for (int l = 0; l < nb_sessions; ++l)
+		{
+			int timeslot = MIP.get_solution_lecture_timeslot(l);
+			int room = MIP.get_solution_lecture_room(l);
+			if (timeslot >= 0 && room >= 0)
+				polished_solution.at(timeslot, room) = l;
+		}
+
+		information_objective_value info;
+		{
+			info.evacuations_timeslot_lecture_uses_path.set(nb_timeslots, nb_sessions, nb_paths, 0.0);
+			info.evacuations_timeslot_flow_per_arc.set(nb_timeslots, nb_arcs, 0.0);
+			info.evacuations_timeslot_time_per_arc.set(nb_timeslots, nb_arcs, 0.0);
+			info.evacuations_timeslot_lecture_travel_time.set(nb_timeslots, nb_sessions, 0.0);
+			info.evacuations_timeslot_max_travel_time.reserve(nb_timeslots);
+			for (int i = 0; i < nb_timeslots; ++i)
+				info.evacuations_timeslot_max_travel_time.push_back(0.0);
+		}
+		evaluate(polished_solution, info);
+
+		std::string output_text = "\n\nObjective value after MIP polishing: " + std::to_string(info.objective_value) + "\n";
+		std::cout << output_text;
+
+		if (info.objective_value < best_objective)
+		{
+			best_solution = polished_solution;
+			best_objective = info.objective_value;
+		}
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void elite_pool::initialize(size_t nb_islands)
+	{
+		_slots.clear();
+		for (size_t i = 0; i < nb_islands; ++i)
+			_slots.push_back(std::unique_ptr<elite_slot>(new elite_slot()));
+	}
+
+
+
+	void elite_pool::publish(size_t island, const matrix2D<int>& solution, const information_objective_value& objective)
+	{
+		elite_slot& slot = *_slots.at(island);
+		std::lock_guard<std::mutex> lock(slot.mutex);
+		slot.solution = solution;
+		slot.objective = objective;
+		slot.objective_value.store(objective.objective_value, std::memory_order_release);
+	}
+
+
+
+	bool elite_pool::get_solution(size_t island, matrix2D<int>& solution, information_objective_value& objective) const
+	{
+		elite_slot& slot = *_slots.at(island);
+		std::lock_guard<std::mutex> lock(slot.mutex);
+		if (slot.objective_value.load(std::memory_order_relaxed) >= 1e20)
+			return false;
+
+		solution = slot.solution;
+		objective = slot.objective;
+		return true;
+	}
+
+
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void heuristic_subprocess::initialize()
+	void heuristic_subprocess::initialize(unsigned long long seed)
 	{
+		_generator.seed(seed);
+
 		current_objective.evacuations_timeslot_lecture_uses_path.set(nb_timeslots, nb_sessions, nb_paths, 0.0);
 		current_objective.evacuations_timeslot_flow_per_arc.set(nb_timeslots, nb_arcs, 0.0);
 		current_objective.evacuations_timeslot_time_per_arc.set(nb_timeslots, nb_arcs, 0.0);
@@ -615,6 +907,63 @@ namespace alg
 		best_objective.evacuations_timeslot_max_travel_time.reserve(nb_timeslots);
 		for (int i = 0; i < nb_timeslots; ++i)
 			best_objective.evacuations_timeslot_max_travel_time.push_back(0.0);
+
+		// conflicts per lecture, so that building a Kempe chain only visits the lectures that are linked
+		_lecture_conflicts.assign(nb_sessions, std::vector<int>());
+		for (int l1 = 0; l1 < nb_sessions; ++l1)
+		{
+			for (int l2 = 0; l2 < nb_sessions; ++l2)
+			{
+				if (l1 != l2 && get_sessionsessionconflict(l1, l2))
+					_lecture_conflicts.at(l1).push_back(l2);
+			}
+		}
+		_kempe_lecture_node.assign(nb_sessions, -1);
+
+		// evacuation data per room and per path, so that the evaluation of a move only visits the arcs and paths that are used
+		_room_arc_share.set(nb_locations, nb_arcs, 0.0);
+		_room_paths.assign(nb_locations, std::vector<int>());
+		for (int r = 0; r < nb_locations; ++r)
+		{
+			for (int p = 0; p < nb_paths; ++p)
+			{
+				double share = get_roomroompath(r, nb_locations, p);
+				for (int ij = 0; ij < nb_arcs; ++ij)
+				{
+					if (get_patharc(p, ij))
+						_room_arc_share.at(r, ij) += share;
+				}
+				if (share > 0.01)
+					_room_paths.at(r).push_back(p);
+			}
+		}
+		_path_arcs.assign(nb_paths, std::vector<int>());
+		for (int p = 0; p < nb_paths; ++p)
+		{
+			for (int ij = 0; ij < nb_arcs; ++ij)
+			{
+				if (get_patharc(p, ij))
+					_path_arcs.at(p).push_back(ij);
+			}
+		}
+		_candidate_flow.assign(nb_arcs, 0.0);
+		_candidate_time.assign(nb_arcs, 0.0);
+		_candidate_path_time.assign(nb_paths, 0.0);
+
+		// neighbourhoods: the initial weights are the normalized probabilities of the registry (equal weights if they are all zero)
+		size_t nb_neighbourhoods = heuristic_master::_neighbourhoods.size();
+		double total_probability = 0;
+		for (size_t n = 0; n < nb_neighbourhoods; ++n)
+			total_probability += heuristic_master::_neighbourhoods.get_probability(n);
+
+		_move_statistics.assign(nb_neighbourhoods, move_statistics());
+		_neighbourhood_cumulative_probability.assign(nb_neighbourhoods, 0.0);
+		_neighbourhood_weight.assign(nb_neighbourhoods, 0.0);
+		_neighbourhood_improvement.assign(nb_neighbourhoods, 0.0);
+		_neighbourhood_time.assign(nb_neighbourhoods, 0.0);
+		for (size_t n = 0; n < nb_neighbourhoods; ++n)
+			_neighbourhood_weight.at(n) = (total_probability > 0) ? heuristic_master::_neighbourhoods.get_probability(n) / total_probability : 1.0 / nb_neighbourhoods;
+		calculate_neighbourhood_probabilities();
 	}
 
 
@@ -635,340 +984,1100 @@ namespace alg
 			// new iteration
 			++_iterations;
 
-			// choose a move
-			std::uniform_real_distribution<double> prob_dist(0, 1);
-			double prob_move = prob_dist(generator);
-			double prob_accept = prob_dist(generator);
+			// island model: exchange solutions with the other islands
+			if (_elite_pool != nullptr && _iterations % heuristic_master::_migration_interval == 0)
+				migrate();
 
+			// iteration-based cooling schedule (the temperature ladder of parallel tempering stays fixed)
+			if (heuristic_master::_cooling_schedule != heuristic_master::cooling_schedule::per_synchronization
+				&& heuristic_master::_synchronization_type != heuristic_master::synchronization_type::parallel_tempering
+				&& _iterations % heuristic_master::_cooling_interval == 0)
+				update_temperature();
 
+			// adaptive selection: update the weights of the neighbourhoods at the end of every segment
+			if (heuristic_master::_neighbourhood_selection == heuristic_master::neighbourhood_selection::adaptive
+				&& _iterations % heuristic_master::_adaptive_segment == 0)
+				update_neighbourhood_weights();
 
+			// Metropolis: a deterioration d is accepted with probability exp(-d/T), i.e. if log(u) < -d/T or d < -T*log(u),
+			// so the threshold is drawn once per iteration and no exponential has to be computed per candidate
+			std::uniform_real_distribution<double> prob_dist(0, 1);
+			double acceptance_threshold = -_temperature * std::log(1.0 - prob_dist(_generator)); // 1 - u in (0,1]
 
-			// A. Lecture swap
-			if (prob_move < heuristic_master::_probability_move[0])
+			// choose a neighbourhood and explore it
+			size_t n = select_neighbourhood();
+			const heuristic_neighbourhood& neighbourhood = heuristic_master::_neighbourhoods.get_neighbourhood(n);
+			if (heuristic_master::_neighbourhood_selection == heuristic_master::neighbourhood_selection::adaptive)
 			{
-				int timeslot1 = 0, timeslot2 = 0, room1 = 0, room2 = 0;
-				std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
-				std::uniform_int_distribution<int> dist_rooms(0, nb_locations - 1);
+				double objective_before = current_objective.objective_value;
+				std::chrono::system_clock::time_point move_start_time = std::chrono::system_clock::now();
 
-				timeslot1 = dist_timeslot(generator);
-				do
-				{
-					timeslot2 = dist_timeslot(generator);
-				} while (timeslot1 == timeslot2 && nb_timeslots > 1); // if nb_timeslots == 1, lecture_swap is same as room_swap
-				room1 = dist_rooms(generator);
-				room2 = dist_rooms(generator);
+				neighbourhood.explore(*this, acceptance_threshold, _move_statistics.at(n));
 
-				if (timeslot2 < timeslot1)
-					std::swap(timeslot1, timeslot2);
+				std::chrono::duration<double, std::ratio<1, 1>> move_time = std::chrono::system_clock::now() - move_start_time;
+				_neighbourhood_time.at(n) += move_time.count();
+				if (current_objective.objective_value < objective_before)
+					_neighbourhood_improvement.at(n) += (objective_before - current_objective.objective_value) / objective_before;
+			}
+			else
+			{
+				neighbourhood.explore(*this, acceptance_threshold, _move_statistics.at(n));
+			}
+		}
+	}
 
-				double candidate_objective = evaluate_incremental(current_solution, timeslot1, timeslot2, room1, room2);
-				double percentage_deterioration = (candidate_objective - current_objective.objective_value) / current_objective.objective_value;
 
-				// accept if better than current solution or better than value in list
-				if (candidate_objective < current_objective.objective_value
-					|| std::exp(-percentage_deterioration / heuristic_master::_SA_temperature) < prob_accept)
-				{
-					// implement the change
-					std::swap(current_solution.at(timeslot1, room1), current_solution.at(timeslot2, room2));
 
-					//current_solution.print();
+	bool heuristic_subprocess::is_acceptable(double candidate_objective, double acceptance_threshold) const
+	{
+		return candidate_objective < current_objective.objective_value
+			|| (candidate_objective - current_objective.objective_value) / current_objective.objective_value < acceptance_threshold;
+	}
 
-					// save the objective value
-					current_objective.objective_value = candidate_objective;
 
-					// update the values for individual objectives and constraints
-					current_objective.constraint_violations_scheduling_conflicts = new_constraint_violations_scheduling_conflicts;
-					current_objective.constraint_violations_correct_room = new_constraint_violations_correct_room;
-					current_objective.constraint_violations_teacher_working_time = new_constraint_violations_teacher_working_time;
-					current_objective.constraint_violations_compactness_constraints = new_constraint_violations_compactness_constraints;
-					current_objective.preference_score = new_preference_score;
 
-					// update the evacuation and travel times
-					{
-						current_objective.evacuations_timeslot_max_travel_time.at(timeslot1) = new_max_evac_time_changed_ts.at(0);
-						current_objective.evacuations_timeslot_max_travel_time.at(timeslot2) = new_max_evac_time_changed_ts.at(1);
-					}
+	size_t heuristic_subprocess::select_neighbourhood()
+	{
+		// roulette wheel: a neighbourhood with probability zero has the same cumulative value as its predecessor and is never chosen
+		std::uniform_real_distribution<double> dist(0, _neighbourhood_cumulative_probability.back());
+		double u = dist(_generator);
+		for (size_t n = 0; n < _neighbourhood_cumulative_probability.size(); ++n)
+		{
+			if (u < _neighbourhood_cumulative_probability.at(n))
+				return n;
+		}
+		return _neighbourhood_cumulative_probability.size() - 1;
+	}
 
-					// check if better than best solution
-					if (current_objective.objective_value < best_objective.objective_value)
-					{
-						best_objective = current_objective; // save entire POD 
-						best_solution = current_solution;
-						std::string text = "\n\nNew best solution found (Lecture Swap) in thread " + std::to_string(_process_id) + "!\nObjective value " + std::to_string(current_objective.objective_value);
-						std::cout << text;
-					}
-				}
-			}
 
 
+	void heuristic_subprocess::calculate_neighbourhood_probabilities()
+	{
+		size_t nb_neighbourhoods = _neighbourhood_weight.size();
+		double min_probability = 0;
+		if (heuristic_master::_neighbourhood_selection == heuristic_master::neighbourhood_selection::adaptive)
+		{
+			min_probability = heuristic_master::_adaptive_min_probability;
+			if (min_probability * nb_neighbourhoods > 1)
+				min_probability = 1.0 / nb_neighbourhoods;
+		}
 
+		double cumulative = 0;
+		for (size_t n = 0; n < nb_neighbourhoods; ++n)
+		{
+			cumulative += min_probability + (1 - nb_neighbourhoods * min_probability) * _neighbourhood_weight.at(n);
+			_neighbourhood_cumulative_probability.at(n) = cumulative;
+		}
+	}
 
 
-			// B. Room Swap
-			else if (prob_move < heuristic_master::_probability_move[0] + heuristic_master::_probability_move[1])
-			{
-				int timeslot = 0, room1 = 0, room2 = 0;
-				std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
-				std::uniform_int_distribution<int> dist_rooms(0, nb_locations - 1);
 
-				timeslot = dist_timeslot(generator);
-				room1 = dist_rooms(generator);
-				do {
-					room2 = dist_rooms(generator);
-				} while (room1 == room2);
+	void heuristic_subprocess::update_neighbourhood_weights()
+	{
+		// 1. relative improvement per second of every neighbourhood in the last segment
+		double total_rate = 0;
+		for (size_t n = 0; n < _neighbourhood_weight.size(); ++n)
+		{
+			if (_neighbourhood_time.at(n) > 0)
+				total_rate += _neighbourhood_improvement.at(n) / _neighbourhood_time.at(n);
+		}
 
-				double candidate_objective = evaluate_incremental(current_solution, timeslot, room1, room2);
-				double percentage_deterioration = (candidate_objective - current_objective.objective_value) / current_objective.objective_value;
+		// 2. move the weights towards the share of every neighbourhood in the total rate (unchanged if nothing improved)
+		if (total_rate > 0)
+		{
+			for (size_t n = 0; n < _neighbourhood_weight.size(); ++n)
+			{
+				double share = 0;
+				if (_neighbourhood_time.at(n) > 0)
+					share = _neighbourhood_improvement.at(n) / _neighbourhood_time.at(n) / total_rate;
+				_neighbourhood_weight.at(n) = (1 - heuristic_master::_adaptive_reaction) * _neighbourhood_weight.at(n) + heuristic_master::_adaptive_reaction * share;
+			}
+			calculate_neighbourhood_probabilities();
+		}
 
-				// accept if better than current solution or better than value in list
-				if (candidate_objective < current_objective.objective_value
-					|| std::exp(-percentage_deterioration / heuristic_master::_SA_temperature) < prob_accept)
-				{
-					// implement the change
-					std::swap(current_solution.at(timeslot, room1), current_solution.at(timeslot, room2));
+		// 3. start a new segment
+		std::fill(_neighbourhood_improvement.begin(), _neighbourhood_improvement.end(), 0.0);
+		std::fill(_neighbourhood_time.begin(), _neighbourhood_time.end(), 0.0);
+	}
 
-					// update the objective value
-					current_objective.objective_value = candidate_objective;
 
-					// update the values for individual objectives and constraints
-					current_objective.constraint_violations_scheduling_conflicts = new_constraint_violations_scheduling_conflicts;
-					current_objective.constraint_violations_correct_room = new_constraint_violations_correct_room;
-					current_objective.constraint_violations_teacher_working_time = new_constraint_violations_teacher_working_time;
-					current_objective.constraint_violations_compactness_constraints = new_constraint_violations_compactness_constraints;
-					current_objective.preference_score = new_preference_score;
 
-					// save the new evacuation/travel times
-					{
-						current_objective.evacuations_timeslot_max_travel_time.at(timeslot) = new_max_evac_time_changed_ts_roomswap;
-					}
 
-					if (current_objective.objective_value < best_objective.objective_value)
-					{
-						best_objective = current_objective;
-						best_solution = current_solution;
-						std::string text = "\n\nNew best solution found (Room Swap) in thread " + std::to_string(_process_id) + "!\nObjective value " + std::to_string(current_objective.objective_value);
-						std::cout << text;
 
-						//best_solution.print();
-					}
-				}
-			}
 
 
+	void heuristic_subprocess::build_kempe_chains(int timeslot1, int timeslot2)
+	{
+		// node (side, room) has index side * nb_locations + room, with side 0 = timeslot1 and side 1 = timeslot2
+		const int timeslots[2] = { timeslot1, timeslot2 };
+		_kempe_visited.assign(2 * nb_locations, 0); // same size every call, so no allocation after the first one
+		_nb_kempe_chains = 0;
 
+		// node of every lecture in the two timeslots
+		for (int side = 0; side < 2; ++side)
+		{
+			for (int r = 0; r < nb_locations; ++r)
+			{
+				int lecture = current_solution.at(timeslots[side], r);
+				if (lecture >= 0)
+					_kempe_lecture_node.at(lecture) = side * nb_locations + r;
+			}
+		}
 
-			// C. Kempe Chain
-			else
+		for (int side = 0; side < 2; ++side)
+		{
+			for (int r = 0; r < nb_locations; ++r)
 			{
-				// Only makes sense if nb_timeslots > 1
-				if (nb_timeslots > 1)
+				// every occupied cell that is not yet part of a chain starts a new chain
+				if (!_kempe_visited.at(side * nb_locations + r) && current_solution.at(timeslots[side], r) >= 0)
 				{
-					// (1) first we select two timeslots
-					std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
-					int timeslot1 = 0, timeslot2 = 0;
-					bool ts1_has_lectures = false, ts2_has_lectures = false;
+					if (_nb_kempe_chains == _kempe_chains.size())
+					{
+						_kempe_chains.push_back(std::vector<std::pair<int, int>>());
+						_kempe_chains.back().reserve(2 * nb_locations);
+					}
+					std::vector<std::pair<int, int>>& chain = _kempe_chains.at(_nb_kempe_chains);
+					++_nb_kempe_chains;
+
+					chain.clear();
+					chain.push_back(std::pair<int, int>(timeslots[side], r));
+					_kempe_visited.at(side * nb_locations + r) = 1;
 
-					do
+					// breadth-first search, with the chain itself as queue:
+					// a lecture is linked to the lecture in the other timeslot in the same room and to the lectures in the other timeslot with which it has a conflict,
+					// so only these neighbours are visited
+					for (size_t i = 0; i < chain.size(); ++i)
 					{
-						timeslot1 = dist_timeslot(generator);
-						for (int r = 0; r < nb_locations; ++r)
+						int other_side = (chain.at(i).first == timeslot1) ? 1 : 0;
+						int room = chain.at(i).second;
+						int lecture = current_solution.at(chain.at(i).first, room);
+
+						int same_room = other_side * nb_locations + room;
+						if (!_kempe_visited.at(same_room) && current_solution.at(timeslots[other_side], room) >= 0)
 						{
-							if (current_solution.at(timeslot1, r) >= 0)
-							{
-								ts1_has_lectures = true;
-								break;
-							}
+							chain.push_back(std::pair<int, int>(timeslots[other_side], room));
+							_kempe_visited.at(same_room) = 1;
 						}
-					} while (!ts1_has_lectures);
 
-					do
-					{
-						timeslot2 = dist_timeslot(generator);
-						for (int r = 0; r < nb_locations; ++r)
+						for (auto&& lecture2 : _lecture_conflicts.at(lecture))
 						{
-							if (current_solution.at(timeslot2, r) >= 0)
+							int node = _kempe_lecture_node.at(lecture2);
+							if (node >= 0 && node / nb_locations == other_side && !_kempe_visited.at(node))
 							{
-								ts2_has_lectures = true;
-								break;
+								chain.push_back(std::pair<int, int>(timeslots[other_side], node % nb_locations));
+								_kempe_visited.at(node) = 1;
 							}
 						}
-					} while (timeslot1 == timeslot2 || !ts2_has_lectures);
-
-					if (timeslot2 < timeslot1)
-						std::swap(timeslot1, timeslot2);
-
-
-					// (2) Now we construct our chains
-					std::vector<std::pair<int, int>> unassigned_nodes;	// first == timeslot, second == room number
-
-					for (int r = 0; r < nb_locations; ++r) // initialize unassigned rooms
-					{
-						if (current_solution.at(timeslot1, r) >= 0)
-							unassigned_nodes.push_back(std::pair<int, int>(timeslot1, r));
-						if (current_solution.at(timeslot2, r) >= 0)
-							unassigned_nodes.push_back(std::pair<int, int>(timeslot2, r));
 					}
 
-					std::vector<std::vector<std::pair<int, int>>> kempe_chains;
-					while (true)
-					{
-						if (unassigned_nodes.size() <= 0)
-							break;
+					// sort chain based on room (in place)
+					std::sort(chain.begin(), chain.end(), sort_on_room);
+				}
+			}
+		}
 
-						std::vector<std::pair<int, int>> kempe_chain_current;
-						kempe_chain_current.push_back(unassigned_nodes.back());
-						unassigned_nodes.pop_back();
+		// reset the nodes of the lectures for the next move
+		for (int side = 0; side < 2; ++side)
+		{
+			for (int r = 0; r < nb_locations; ++r)
+			{
+				int lecture = current_solution.at(timeslots[side], r);
+				if (lecture >= 0)
+					_kempe_lecture_node.at(lecture) = -1;
+			}
+		}
+	}
 
-						for (int i = 0; i < kempe_chain_current.size(); ++i)
-						{
-							for (int j = unassigned_nodes.size() - 1; j >= 0; --j)
-							{
-								if (kempe_chain_current.at(i).first != unassigned_nodes.at(j).first) // different timeslots
-								{
-									if (kempe_chain_current.at(i).second == unassigned_nodes.at(j).second	// same room
-										|| get_sessionsessionconflict(current_solution.at(kempe_chain_current.at(i).first, kempe_chain_current.at(i).second),
-											current_solution.at(unassigned_nodes.at(j).first, unassigned_nodes.at(j).second))) // lecture hase conflict
-									{
-										kempe_chain_current.push_back(unassigned_nodes.at(j));
-										unassigned_nodes.erase(unassigned_nodes.begin() + j);
-									}
-								}
-							}
-						}
 
-						// sort chain based on room
-						std::sort(kempe_chain_current.begin(), kempe_chain_current.end(), sort_on_room);
 
-						// save chain
-						kempe_chains.push_back(kempe_chain_current);
-					}
+	void heuristic_subprocess::evaluate_kempe_chains(int timeslot1, int timeslot2, incremental_evaluation& best_chain, int& best_index)
+	{
+		best_index = -1;
+		size_t nb_workers = heuristic_master::_kempe_nb_threads;
 
+		// 1. small timeslots: evaluate the chains one after the other
+		if (nb_workers <= 1 || _nb_kempe_chains < heuristic_master::_kempe_parallel_min_chains)
+		{
+			for (int i = 0; i < static_cast<int>(_nb_kempe_chains); ++i)
+			{
+				double candidate_objective = evaluate_incremental(current_solution, current_objective.objective_value, _kempe_chains.at(i), timeslot1, timeslot2);
+				if (candidate_objective < best_chain.objective_value)
+				{
+					save_evaluation(best_chain, candidate_objective);
+					best_index = i;
+				}
+			}
+			return;
+		}
 
+		// 2. large timeslots: the persistent workers of this subprocess each evaluate a share of the chains against the (read-only) current solution
+		// (a worker needs its own copy of the constraint values and the evacuation time per timeslot; its other matrices are scratch space)
+		while (_kempe_evaluators.size() < nb_workers)
+		{
+			_kempe_evaluators.push_back(heuristic_subprocess());
+			_kempe_evaluators.back().initialize(0);
+		}
+		for (size_t w = 0; w < nb_workers; ++w)
+		{
+			heuristic_subprocess& evaluator = _kempe_evaluators.at(w);
+			evaluator.current_objective.objective_value = current_objective.objective_value;
+			evaluator.current_objective.constraint_violations_scheduling_conflicts = current_objective.constraint_violations_scheduling_conflicts;
+			evaluator.current_objective.constraint_violations_correct_room = current_objective.constraint_violations_correct_room;
+			evaluator.current_objective.constraint_violations_teacher_working_time = current_objective.constraint_violations_teacher_working_time;
+			evaluator.current_objective.constraint_violations_compactness_constraints = current_objective.constraint_violations_compactness_constraints;
+			evaluator.current_objective.preference_score = current_objective.preference_score;
+			evaluator.current_objective.evacuations_timeslot_max_travel_time = current_objective.evacuations_timeslot_max_travel_time;
+		}
 
-					// (3) for every chain, calculate objective value if the lectures in the chain are swapped between rooms
-					double best_obj_val_KC = 1e20;
-					int best_index_KC = -1;
+		_kempe_worker_best_chain.assign(nb_workers, incremental_evaluation());
+		_kempe_worker_best_index.assign(nb_workers, -1);
+		_kempe_workers.get(nb_workers).run_round([this, nb_workers, timeslot1, timeslot2](size_t w)
+		{
+			heuristic_subprocess& evaluator = _kempe_evaluators.at(w);
+			for (size_t i = w; i < _nb_kempe_chains; i += nb_workers)
+			{
+				double candidate_objective = evaluator.evaluate_incremental(current_solution, evaluator.current_objective.objective_value, _kempe_chains.at(i), timeslot1, timeslot2);
+				if (candidate_objective < _kempe_worker_best_chain.at(w).objective_value)
+				{
+					evaluator.save_evaluation(_kempe_worker_best_chain.at(w), candidate_objective);
+					_kempe_worker_best_index.at(w) = static_cast<int>(i);
+				}
+			}
+		}); // an exception of a worker is rethrown here
 
-					for (int i = 0; i < kempe_chains.size(); ++i)
-					{
-						// calculate candidate objective value
-						double candidate_objective = evaluate_incremental(current_solution, current_objective.objective_value, kempe_chains.at(i), timeslot1, timeslot2);
+		// 3. best chain over all workers (ties go to the lowest index, as in the sequential evaluation)
+		for (size_t w = 0; w < nb_workers; ++w)
+		{
+			if (_kempe_worker_best_index.at(w) >= 0
+				&& (_kempe_worker_best_chain.at(w).objective_value < best_chain.objective_value
+				|| (_kempe_worker_best_chain.at(w).objective_value == best_chain.objective_value && _kempe_worker_best_index.at(w) < best_index)))
+			{
+				best_chain = _kempe_worker_best_chain.at(w);
+				best_index = _kempe_worker_best_index.at(w);
+			}
+		}
+	}
 
-						// save if improvement
-						if (candidate_objective < best_obj_val_KC) // best chain of all chains
-						{
-							best_obj_val_KC = candidate_objective;
 
-							double percentage_deterioration = (candidate_objective - current_objective.objective_value) / current_objective.objective_value;
-							if (candidate_objective < current_objective.objective_value
-								|| std::exp(-percentage_deterioration / heuristic_master::_SA_temperature) < prob_accept)
-							{
-								best_index_KC = i;
-							}
-						}
-					}
 
+	void heuristic_subprocess::save_evaluation(incremental_evaluation& evaluation, double objective_value) const
+	{
+		evaluation.objective_value = objective_value;
+		evaluation.constraint_violations_scheduling_conflicts = new_constraint_violations_scheduling_conflicts;
+		evaluation.constraint_violations_correct_room = new_constraint_violations_correct_room;
+		evaluation.constraint_violations_teacher_working_time = new_constraint_violations_teacher_working_time;
+		evaluation.constraint_violations_compactness_constraints = new_constraint_violations_compactness_constraints;
+		evaluation.preference_score = new_preference_score;
+		evaluation.max_evac_time_changed_ts_roomswap = new_max_evac_time_changed_ts_roomswap;
+		evaluation.max_evac_time_changed_ts[0] = new_max_evac_time_changed_ts.at(0);
+		evaluation.max_evac_time_changed_ts[1] = new_max_evac_time_changed_ts.at(1);
+	}
 
-					// (4) implement best chain if improvement
-					if (best_index_KC != -1)
-					{
-						// recalculate so that correct values are in the new vectors
-						double candidate_objective = evaluate_incremental(current_solution, current_objective.objective_value, kempe_chains.at(best_index_KC), timeslot1, timeslot2);
 
-						// implement the changes
-						for (int ii = 0; ii < kempe_chains.at(best_index_KC).size(); ++ii)
-						{
-							if (ii < kempe_chains.at(best_index_KC).size() - 1)
-							{
-								if (kempe_chains.at(best_index_KC).at(ii).second == kempe_chains.at(best_index_KC).at(ii + 1).second) // two lectures same room different timeslot (by definition timeslot should be different)
-								{
-									// swap two lectures
-									int lec_temp = current_solution.at(kempe_chains.at(best_index_KC).at(ii).first, kempe_chains.at(best_index_KC).at(ii).second);
-									current_solution.at(kempe_chains.at(best_index_KC).at(ii).first, kempe_chains.at(best_index_KC).at(ii).second) = current_solution.at(kempe_chains.at(best_index_KC).at(ii + 1).first, kempe_chains.at(best_index_KC).at(ii + 1).second);
-									current_solution.at(kempe_chains.at(best_index_KC).at(ii + 1).first, kempe_chains.at(best_index_KC).at(ii + 1).second) = lec_temp;
 
-									// two lectures swapped, so skip ii+1
-									++ii;
-								}
-								else
-								{
-									// move lecture in current room to lecture in other room
-									if (kempe_chains.at(best_index_KC).at(ii).first == timeslot1)
-									{
-										int lec_temp = current_solution.at(timeslot1, kempe_chains.at(best_index_KC).at(ii).second);
-										current_solution.at(timeslot1, kempe_chains.at(best_index_KC).at(ii).second) = -1;
-										current_solution.at(timeslot2, kempe_chains.at(best_index_KC).at(ii).second) = lec_temp;
-									}
-									else
-									{
-										int lec_temp = current_solution.at(timeslot2, kempe_chains.at(best_index_KC).at(ii).second);
-										current_solution.at(timeslot2, kempe_chains.at(best_index_KC).at(ii).second) = -1;
-										current_solution.at(timeslot1, kempe_chains.at(best_index_KC).at(ii).second) = lec_temp;
-									}
-								}
-							}
-							else
-							{
-								// move lecture in current room to lecture in other room
-								if (kempe_chains.at(best_index_KC).at(ii).first == timeslot1)
-								{
-									int lec_temp = current_solution.at(timeslot1, kempe_chains.at(best_index_KC).at(ii).second);
-									current_solution.at(timeslot1, kempe_chains.at(best_index_KC).at(ii).second) = -1;
-									current_solution.at(timeslot2, kempe_chains.at(best_index_KC).at(ii).second) = lec_temp;
-								}
-								else
-								{
-									int lec_temp = current_solution.at(timeslot2, kempe_chains.at(best_index_KC).at(ii).second);
-									current_solution.at(timeslot2, kempe_chains.at(best_index_KC).at(ii).second) = -1;
-									current_solution.at(timeslot1, kempe_chains.at(best_index_KC).at(ii).second) = lec_temp;
-								}
-							}
-						}
+	void heuristic_subprocess::commit_evaluation(const incremental_evaluation& evaluation, int timeslot1, int timeslot2, incremental_evaluation& previous)
+	{
+		++_solution_version;
+
+		// 1. remember the values before the move
+		previous.objective_value = current_objective.objective_value;
+		previous.constraint_violations_scheduling_conflicts = current_objective.constraint_violations_scheduling_conflicts;
+		previous.constraint_violations_correct_room = current_objective.constraint_violations_correct_room;
+		previous.constraint_violations_teacher_working_time = current_objective.constraint_violations_teacher_working_time;
+		previous.constraint_violations_compactness_constraints = current_objective.constraint_violations_compactness_constraints;
+		previous.preference_score = current_objective.preference_score;
+		previous.max_evac_time_changed_ts[0] = current_objective.evacuations_timeslot_max_travel_time.at(timeslot1);
+		previous.max_evac_time_changed_ts[1] = current_objective.evacuations_timeslot_max_travel_time.at(timeslot2);
+
+		// 2. update the objective value and the values for individual objectives and constraints
+		current_objective.objective_value = evaluation.objective_value;
+		current_objective.constraint_violations_scheduling_conflicts = evaluation.constraint_violations_scheduling_conflicts;
+		current_objective.constraint_violations_correct_room = evaluation.constraint_violations_correct_room;
+		current_objective.constraint_violations_teacher_working_time = evaluation.constraint_violations_teacher_working_time;
+		current_objective.constraint_violations_compactness_constraints = evaluation.constraint_violations_compactness_constraints;
+		current_objective.preference_score = evaluation.preference_score;
+
+		// 3. update the evacuation/travel times
+		if (timeslot1 == timeslot2)
+		{
+			current_objective.evacuations_timeslot_max_travel_time.at(timeslot1) = evaluation.max_evac_time_changed_ts_roomswap;
+		}
+		else
+		{
+			current_objective.evacuations_timeslot_max_travel_time.at(timeslot1) = evaluation.max_evac_time_changed_ts[0];
+			current_objective.evacuations_timeslot_max_travel_time.at(timeslot2) = evaluation.max_evac_time_changed_ts[1];
+		}
+	}
 
-						// save the objective value
-						current_objective.objective_value = best_obj_val_KC;
 
-						// update the values for individual objectives and constraints
-						current_objective.constraint_violations_scheduling_conflicts = new_constraint_violations_scheduling_conflicts;
-						current_objective.constraint_violations_correct_room = new_constraint_violations_correct_room;
-						current_objective.constraint_violations_teacher_working_time = new_constraint_violations_teacher_working_time;
-						current_objective.constraint_violations_compactness_constraints = new_constraint_violations_compactness_constraints;
-						current_objective.preference_score = new_preference_score;
 
-						// update the evacuation/travel times
-						{
+	void heuristic_subprocess::revert_evaluation(const incremental_evaluation& previous, int timeslot1, int timeslot2)
+	{
+		++_solution_version;
+		current_objective.objective_value = previous.objective_value;
+		current_objective.constraint_violations_scheduling_conflicts = previous.constraint_violations_scheduling_conflicts;
+		current_objective.constraint_violations_correct_room = previous.constraint_violations_correct_room;
+		current_objective.constraint_violations_teacher_working_time = previous.constraint_violations_teacher_working_time;
+		current_objective.constraint_violations_compactness_constraints = previous.constraint_violations_compactness_constraints;
+		current_objective.preference_score = previous.preference_score;
+		current_objective.evacuations_timeslot_max_travel_time.at(timeslot2) = previous.max_evac_time_changed_ts[1];
+		current_objective.evacuations_timeslot_max_travel_time.at(timeslot1) = previous.max_evac_time_changed_ts[0];
+	}
 
-							{
-								current_objective.evacuations_timeslot_max_travel_time.at(timeslot1) = new_max_evac_time_changed_ts.at(0);
-								current_objective.evacuations_timeslot_max_travel_time.at(timeslot2) = new_max_evac_time_changed_ts.at(1);
-							}
-						}
 
 
-						// check if better than best solution
-						if (current_objective.objective_value < best_objective.objective_value)
-						{
-							best_objective = current_objective;
-							best_solution = current_solution;
-							std::string text = "\n\nNew best solution found (Kempe Chain) in thread " + std::to_string(_process_id) + "!\nObjective value " + std::to_string(current_objective.objective_value);
-							std::cout << text;
+	void heuristic_subprocess::accept_move(heuristic_move& move, move_statistics& statistics)
+	{
+		++_accepted_moves_interval;
+		if (move.get_objective_value() < current_objective.objective_value)
+			++statistics.accepted_improving;
+		else
+			++statistics.accepted_worsening;
+
+		// implement the change
+		move.apply(*this);
+
+		// check if better than best solution
+		if (current_objective.objective_value < best_objective.objective_value)
+		{
+			best_objective = current_objective; // save entire POD 
+			best_solution = current_solution;
+			std::string text = "\n\nNew best solution found (" + std::string(move.get_name()) + ") in thread " + std::to_string(_process_id) + "!\nObjective value " + std::to_string(current_objective.objective_value);
+			std::cout << text;
+		}
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	double room_swap_move::delta(heuristic_subprocess& process)
+	{
+		double objective = process.evaluate_incremental(process.current_solution, _timeslot, _room1, _room2);
+		process.save_evaluation(_evaluation, objective);
+		return objective - process.current_objective.objective_value;
+	}
+
+
+
+	void room_swap_move::apply(heuristic_subprocess& process)
+	{
+		std::swap(process.current_solution.at(_timeslot, _room1), process.current_solution.at(_timeslot, _room2));
+		process.commit_evaluation(_evaluation, _timeslot, _timeslot, _previous);
+	}
+
+
+
+	void room_swap_move::undo(heuristic_subprocess& process)
+	{
+		std::swap(process.current_solution.at(_timeslot, _room1), process.current_solution.at(_timeslot, _room2));
+		process.revert_evaluation(_previous, _timeslot, _timeslot);
+	}
+
+
+
+	double lecture_swap_move::delta(heuristic_subprocess& process)
+	{
+		double objective = process.evaluate_incremental(process.current_solution, _timeslot1, _timeslot2, _room1, _room2);
+		process.save_evaluation(_evaluation, objective);
+		if (_timeslot1 == _timeslot2) // only one timeslot, i.e. a room swap
+			_evaluation.max_evac_time_changed_ts_roomswap = _evaluation.max_evac_time_changed_ts[0];
+		return objective - process.current_objective.objective_value;
+	}
+
+
+
+	void lecture_swap_move::apply(heuristic_subprocess& process)
+	{
+		std::swap(process.current_solution.at(_timeslot1, _room1), process.current_solution.at(_timeslot2, _room2));
+		process.commit_evaluation(_evaluation, _timeslot1, _timeslot2, _previous);
+	}
+
+
+
+	void lecture_swap_move::undo(heuristic_subprocess& process)
+	{
+		std::swap(process.current_solution.at(_timeslot1, _room1), process.current_solution.at(_timeslot2, _room2));
+		process.revert_evaluation(_previous, _timeslot1, _timeslot2);
+	}
+
+
+
+	double kempe_chain_move::delta(heuristic_subprocess& process)
+	{
+		double objective = process.evaluate_incremental(process.current_solution, process.current_objective.objective_value, *_chain, _timeslot1, _timeslot2);
+		process.save_evaluation(_evaluation, objective);
+		return objective - process.current_objective.objective_value;
+	}
+
+
+
+	void kempe_chain_move::apply(heuristic_subprocess& process)
+	{
+		// swap the contents of both timeslots for every room in the chain 
+		// (the chain is sorted on room, so a room with a lecture in both timeslots appears twice in a row)
+		for (size_t i = 0; i < _chain->size(); ++i)
+		{
+			int room = _chain->at(i).second;
+			std::swap(process.current_solution.at(_timeslot1, room), process.current_solution.at(_timeslot2, room));
+			if (i + 1 < _chain->size() && _chain->at(i + 1).second == room)
+				++i;
+		}
+		process.commit_evaluation(_evaluation, _timeslot1, _timeslot2, _previous);
+	}
+
+
+
+	void kempe_chain_move::undo(heuristic_subprocess& process)
+	{
+		// swapping the same rooms again restores the solution
+		for (size_t i = 0; i < _chain->size(); ++i)
+		{
+			int room = _chain->at(i).second;
+			std::swap(process.current_solution.at(_timeslot1, room), process.current_solution.at(_timeslot2, room));
+			if (i + 1 < _chain->size() && _chain->at(i + 1).second == room)
+				++i;
+		}
+		process.revert_evaluation(_previous, _timeslot1, _timeslot2);
+	}
+
+
+
+	int day_swap_move::swapped_timeslot(int timeslot) const
+	{
+		int day = timeslot / nb_timeslots_per_day;
+		if (day == _day1)
+			return _day2 * nb_timeslots_per_day + timeslot % nb_timeslots_per_day;
+		if (day == _day2)
+			return _day1 * nb_timeslots_per_day + timeslot % nb_timeslots_per_day;
+		return timeslot;
+	}
+
+
+
+	double day_swap_move::delta(heuristic_subprocess& process)
+	{
+		const matrix2D<int>& solution = process.current_solution;
+		const information_objective_value& current = process.current_objective;
+
+		// 1. start from current solution
+		// (conflicts, rooms, lectures per day, consecutive lectures and first and last lecture within a day, compactness and evacuations move along with the days)
+		_evaluation.constraint_violations_scheduling_conflicts = current.constraint_violations_scheduling_conflicts;
+		_evaluation.constraint_violations_correct_room = current.constraint_violations_correct_room;
+		_evaluation.constraint_violations_teacher_working_time = current.constraint_violations_teacher_working_time;
+		_evaluation.constraint_violations_compactness_constraints = current.constraint_violations_compactness_constraints;
+		_evaluation.preference_score = current.preference_score;
+
+		// 2. the solution after the change is read through this mapping, so the solution itself is never changed
+		auto after = [this, &solution](int t, int r) -> int
+		{
+			return solution.at(swapped_timeslot(t), r);
+		};
+
+		// 3. preferences of the lectures in both days
+		for (int p = 0; p < nb_timeslots_per_day; ++p)
+		{
+			const int timeslots[2] = { _day1 * nb_timeslots_per_day + p, _day2 * nb_timeslots_per_day + p };
+			for (int t : timeslots)
+			{
+				for (int r = 0; r < nb_locations; ++r)
+				{
+					int lec = solution.at(t, r);
+					if (lec >= 0)
+						_evaluation.preference_score -= (get_costsessiontimeslot(lec, t) + 1000 * get_costsession_ts_educational(lec, t));
+					lec = after(t, r);
+					if (lec >= 0)
+						_evaluation.preference_score += (get_costsessiontimeslot(lec, t) + 1000 * get_costsession_ts_educational(lec, t));
+				}
+			}
+		}
+		if (heuristic_master::_constraint_preferences && _evaluation.preference_score > heuristic_master::_constraint_preferences_value)
+			_evaluation.preference_score += heuristic_master::_penalty_value_constraint_violation;
+
+		// 4. teacher working time regulations: not last timeslot of previous day and first timeslot of next day (only the boundaries of the swapped days)
+		for (int day = 1; day < nb_days; ++day)
+		{
+			if (day == _day1 || day == _day1 + 1 || day == _day2 || day == _day2 + 1)
+			{
+				int first_timeslot_of_next_day = day * nb_timeslots_per_day;
+				int last_timeslot_of_previous_day = day * nb_timeslots_per_day - 1;
+
+				for (int d = 0; d < nb_teachers; ++d)
+				{
+					bool teaches_t1 = false, teaches_t2 = false, teaches_t1_after = false, teaches_t2_after = false;
+					for (int r = 0; r < nb_locations; ++r)
+					{
+						int lec1 = solution.at(last_timeslot_of_previous_day, r);
+						if (lec1 >= 0 && get_teachersession(d, lec1))
+							teaches_t1 = true;
+						int lec2 = solution.at(first_timeslot_of_next_day, r);
+						if (lec2 >= 0 && get_teachersession(d, lec2))
+							teaches_t2 = true;
+
+						lec1 = after(last_timeslot_of_previous_day, r);
+						if (lec1 >= 0 && get_teachersession(d, lec1))
+							teaches_t1_after = true;
+						lec2 = after(first_timeslot_of_next_day, r);
+						if (lec2 >= 0 && get_teachersession(d, lec2))
+							teaches_t2_after = true;
+					}
+					if (teaches_t1 && teaches_t2)
+						--_evaluation.constraint_violations_teacher_working_time;
+					if (teaches_t1_after && teaches_t2_after)
+						++_evaluation.constraint_violations_teacher_working_time;
+				}
+			}
+		}
+
+		// 5. objective evacuations: the evacuation times are only permuted over the timeslots
+		double objective_evacuations = 0.0;
+		for (int t = 0; t < nb_timeslots; ++t)
+		{
+			if (heuristic_master::_objective_type == heuristic_master::objective_type::maximum_over_timeslots)
+			{
+				if (current.evacuations_timeslot_max_travel_time.at(t) > objective_evacuations)
+					objective_evacuations = current.evacuations_timeslot_max_travel_time.at(t);
+			}
+			else // _objective_type == objective_type::sum_over_timeslots
+			{
+				objective_evacuations += current.evacuations_timeslot_max_travel_time.at(t);
+			}
+		}
+
+		// 6. recalculate objective value
+		_evaluation.objective_value = (heuristic_master::_penalty_value_constraint_violation * (_evaluation.constraint_violations_scheduling_conflicts
+			+ _evaluation.constraint_violations_correct_room
+			+ _evaluation.constraint_violations_teacher_working_time
+			+ _evaluation.constraint_violations_compactness_constraints)
+			+ heuristic_master::_lambda * _evaluation.preference_score + (1 - heuristic_master::_lambda) * objective_evacuations);
+		return _evaluation.objective_value - current.objective_value;
+	}
+
+
+
+	void day_swap_move::swap_days(heuristic_subprocess& process) const
+	{
+		for (int p = 0; p < nb_timeslots_per_day; ++p)
+		{
+			int timeslot1 = _day1 * nb_timeslots_per_day + p;
+			int timeslot2 = _day2 * nb_timeslots_per_day + p;
+			for (int r = 0; r < nb_locations; ++r)
+				std::swap(process.current_solution.at(timeslot1, r), process.current_solution.at(timeslot2, r));
+			std::swap(process.current_objective.evacuations_timeslot_max_travel_time.at(timeslot1), process.current_objective.evacuations_timeslot_max_travel_time.at(timeslot2));
+		}
+		++process._solution_version;
+	}
+
+
+
+	void day_swap_move::apply(heuristic_subprocess& process)
+	{
+		information_objective_value& current = process.current_objective;
+
+		// 1. remember the values before the move
+		_previous.objective_value = current.objective_value;
+		_previous.constraint_violations_scheduling_conflicts = current.constraint_violations_scheduling_conflicts;
+		_previous.constraint_violations_correct_room = current.constraint_violations_correct_room;
+		_previous.constraint_violations_teacher_working_time = current.constraint_violations_teacher_working_time;
+		_previous.constraint_violations_compactness_constraints = current.constraint_violations_compactness_constraints;
+		_previous.preference_score = current.preference_score;
+
+		// 2. implement the change and update the values
+		swap_days(process);
+		current.objective_value = _evaluation.objective_value;
+		current.constraint_violations_scheduling_conflicts = _evaluation.constraint_violations_scheduling_conflicts;
+		current.constraint_violations_correct_room = _evaluation.constraint_violations_correct_room;
+		current.constraint_violations_teacher_working_time = _evaluation.constraint_violations_teacher_working_time;
+		current.constraint_violations_compactness_constraints = _evaluation.constraint_violations_compactness_constraints;
+		current.preference_score = _evaluation.preference_score;
+	}
+
+
+
+	void day_swap_move::undo(heuristic_subprocess& process)
+	{
+		information_objective_value& current = process.current_objective;
+
+		// swapping the days again restores the solution and the evacuation times
+		swap_days(process);
+		current.objective_value = _previous.objective_value;
+		current.constraint_violations_scheduling_conflicts = _previous.constraint_violations_scheduling_conflicts;
+		current.constraint_violations_correct_room = _previous.constraint_violations_correct_room;
+		current.constraint_violations_teacher_working_time = _previous.constraint_violations_teacher_working_time;
+		current.constraint_violations_compactness_constraints = _previous.constraint_violations_compactness_constraints;
+		current.preference_score = _previous.preference_score;
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	std::mt19937_64& heuristic_neighbourhood::get_generator(heuristic_subprocess& process)
+	{
+		return process._generator;
+	}
+
+
+
+	const matrix2D<int>& heuristic_neighbourhood::get_solution(const heuristic_subprocess& process)
+	{
+		return process.current_solution;
+	}
+
+
+
+	bool heuristic_neighbourhood::is_acceptable(const heuristic_subprocess& process, double candidate_objective, double acceptance_threshold)
+	{
+		return process.is_acceptable(candidate_objective, acceptance_threshold);
+	}
+
+
+
+	void heuristic_neighbourhood::accept(heuristic_subprocess& process, heuristic_move& move, move_statistics& statistics)
+	{
+		process.accept_move(move, statistics);
+	}
+
+
+
+	void lecture_swap_neighbourhood::explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const
+	{
+		std::mt19937_64& rng = get_generator(process);
+		int timeslot1 = 0, timeslot2 = 0, room1 = 0, room2 = 0;
+		std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
+		std::uniform_int_distribution<int> dist_rooms(0, nb_locations - 1);
+
+		timeslot1 = dist_timeslot(rng);
+		do
+		{
+			timeslot2 = dist_timeslot(rng);
+		} while (timeslot1 == timeslot2 && nb_timeslots > 1); // if nb_timeslots == 1, lecture_swap is same as room_swap
+
+		if (timeslot2 < timeslot1)
+			std::swap(timeslot1, timeslot2);
+
+		// evaluate a batch of swaps between the same two timeslots and keep the best one
+		// (the acceptance threshold is fixed, so the first acceptable candidate is also the best one so far)
+		lecture_swap_move chosen;
+		for (size_t k = 0; k < heuristic_master::_batch_size || k == 0; ++k)
+		{
+			room1 = dist_rooms(rng);
+			room2 = dist_rooms(rng);
+			lecture_swap_move candidate(timeslot1, timeslot2, room1, room2);
+			candidate.delta(process);
+			if (k == 0 || candidate.get_objective_value() < chosen.get_objective_value())
+				chosen = candidate;
+
+			if (heuristic_master::_batch_selection == heuristic_master::batch_selection::first_acceptable && is_acceptable(process, candidate.get_objective_value(), acceptance_threshold))
+				break;
+		}
+		++statistics.attempted;
+
+		// accept if better than current solution or if the deterioration is below the Metropolis threshold
+		if (is_acceptable(process, chosen.get_objective_value(), acceptance_threshold))
+			accept(process, chosen, statistics);
+	}
+
+
+
+	void room_swap_neighbourhood::explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const
+	{
+		std::mt19937_64& rng = get_generator(process);
+		int timeslot = 0, room1 = 0, room2 = 0;
+		std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
+		std::uniform_int_distribution<int> dist_rooms(0, nb_locations - 1);
+
+		timeslot = dist_timeslot(rng);
+
+		// evaluate a batch of swaps in the same timeslot and keep the best one
+		room_swap_move chosen;
+		for (size_t k = 0; k < heuristic_master::_batch_size || k == 0; ++k)
+		{
+			room1 = dist_rooms(rng);
+			do {
+				room2 = dist_rooms(rng);
+			} while (room1 == room2);
+
+			room_swap_move candidate(timeslot, room1, room2);
+			candidate.delta(process);
+			if (k == 0 || candidate.get_objective_value() < chosen.get_objective_value())
+				chosen = candidate;
+
+			if (heuristic_master::_batch_selection == heuristic_master::batch_selection::first_acceptable && is_acceptable(process, candidate.get_objective_value(), acceptance_threshold))
+				break;
+		}
+		++statistics.attempted;
+
+		// accept if better than current solution or if the deterioration is below the Metropolis threshold
+		if (is_acceptable(process, chosen.get_objective_value(), acceptance_threshold))
+			accept(process, chosen, statistics);
+	}
+
+
+
+	void kempe_chain_neighbourhood::explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const
+	{
+		// Only makes sense if nb_timeslots > 1
+		if (nb_timeslots <= 1)
+			return;
+
+		// (1) first we select two timeslots
+		std::mt19937_64& rng = get_generator(process);
+		std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
+		int timeslot1 = 0, timeslot2 = 0;
+		bool ts1_has_lectures = false, ts2_has_lectures = false;
+
+		do
+		{
+			timeslot1 = dist_timeslot(rng);
+			for (int r = 0; r < nb_locations; ++r)
+			{
+				if (process.current_solution.at(timeslot1, r) >= 0)
+				{
+					ts1_has_lectures = true;
+					break;
+				}
+			}
+		} while (!ts1_has_lectures);
+
+		do
+		{
+			timeslot2 = dist_timeslot(rng);
+			for (int r = 0; r < nb_locations; ++r)
+			{
+				if (process.current_solution.at(timeslot2, r) >= 0)
+				{
+					ts2_has_lectures = true;
+					break;
+				}
+			}
+		} while (timeslot1 == timeslot2 || !ts2_has_lectures);
+
+		if (timeslot2 < timeslot1)
+			std::swap(timeslot1, timeslot2);
+
+
+		// (2) Now we construct our chains
+		process.build_kempe_chains(timeslot1, timeslot2);
+
+
+
+		// (3) for every chain, calculate objective value if the lectures in the chain are swapped between rooms
+		incremental_evaluation best_chain;
+		int best_index_KC = -1;
+		process.evaluate_kempe_chains(timeslot1, timeslot2, best_chain, best_index_KC);
+
+		// (4) implement best chain if accepted
+		++statistics.attempted;
+		if (best_index_KC != -1 && is_acceptable(process, best_chain.objective_value, acceptance_threshold))
+		{
+			// the saved evaluation of the best chain holds the correct values, so the chain isn't evaluated again
+			kempe_chain_move move(timeslot1, timeslot2, process._kempe_chains.at(best_index_KC), best_chain);
+			accept(process, move, statistics);
+		}
+	}
+
+
+
+	void relocate_neighbourhood::explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const
+	{
+		std::mt19937_64& rng = get_generator(process);
+		const matrix2D<int>& solution = get_solution(process);
+		std::uniform_int_distribution<int> dist_timeslot(0, nb_timeslots - 1);
+		std::uniform_int_distribution<int> dist_rooms(0, nb_locations - 1);
+		int max_tries = nb_timeslots * nb_locations; // give up on a timetable without lectures or without empty rooms
+
+		// evaluate a batch of relocations and keep the best one
+		lecture_swap_move chosen;
+		bool has_candidate = false;
+		for (size_t k = 0; k < heuristic_master::_batch_size || k == 0; ++k)
+		{
+			// a random lecture and a random empty room
+			int timeslot1 = 0, timeslot2 = 0, room1 = 0, room2 = 0, tries = 0;
+			do
+			{
+				timeslot1 = dist_timeslot(rng);
+				room1 = dist_rooms(rng);
+			} while (solution.at(timeslot1, room1) < 0 && ++tries < max_tries);
+
+			tries = 0;
+			do
+			{
+				timeslot2 = dist_timeslot(rng);
+				room2 = dist_rooms(rng);
+			} while (solution.at(timeslot2, room2) >= 0 && ++tries < max_tries);
+
+			if (solution.at(timeslot1, room1) < 0 || solution.at(timeslot2, room2) >= 0)
+				break;
+
+			// a relocation is a lecture swap with an empty room (timeslots in increasing order, as for the lecture swap)
+			if (timeslot2 < timeslot1)
+			{
+				std::swap(timeslot1, timeslot2);
+				std::swap(room1, room2);
+			}
+			lecture_swap_move candidate(timeslot1, timeslot2, room1, room2);
+			candidate.delta(process);
+			if (!has_candidate || candidate.get_objective_value() < chosen.get_objective_value())
+				chosen = candidate;
+			has_candidate = true;
+
+			if (heuristic_master::_batch_selection == heuristic_master::batch_selection::first_acceptable && is_acceptable(process, candidate.get_objective_value(), acceptance_threshold))
+				break;
+		}
+
+		if (has_candidate)
+		{
+			++statistics.attempted;
+			if (is_acceptable(process, chosen.get_objective_value(), acceptance_threshold))
+				accept(process, chosen, statistics);
+		}
+	}
+
+
+
+	void day_swap_neighbourhood::explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const
+	{
+		// Only makes sense if nb_days > 1
+		if (nb_days <= 1)
+			return;
+
+		std::mt19937_64& rng = get_generator(process);
+		std::uniform_int_distribution<int> dist_days(0, nb_days - 1);
+		int day1 = dist_days(rng), day2 = 0;
+		do
+		{
+			day2 = dist_days(rng);
+		} while (day1 == day2);
+
+		day_swap_move move(day1, day2);
+		move.delta(process);
+		++statistics.attempted;
+		if (is_acceptable(process, move.get_objective_value(), acceptance_threshold))
+			accept(process, move, statistics);
+	}
+
+
+
+	neighbourhood_registry neighbourhood_registry::create_default()
+	{
+		neighbourhood_registry registry;
+		registry.add(std::make_unique<lecture_swap_neighbourhood>(), 0.6);
+		registry.add(std::make_unique<room_swap_neighbourhood>(), 0.38);
+		registry.add(std::make_unique<kempe_chain_neighbourhood>(), 0.02);
+		registry.add(std::make_unique<relocate_neighbourhood>(), 0);
+		registry.add(std::make_unique<day_swap_neighbourhood>(), 0);
+		return registry;
+	}
+
+
+
+	void neighbourhood_registry::add(std::unique_ptr<heuristic_neighbourhood> neighbourhood, double probability)
+	{
+		if (!neighbourhood)
+			throw std::runtime_error("Error in function neighbourhood_registry::add(). \nReason: no neighbourhood given.");
+		if (probability < 0)
+			throw std::runtime_error("Error in function neighbourhood_registry::add(). \nReason: negative probability.");
+
+		_neighbourhoods.push_back(std::move(neighbourhood));
+		_probabilities.push_back(probability);
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void heuristic_subprocess::update_temperature()
+	{
+		if (heuristic_master::_cooling_schedule == heuristic_master::cooling_schedule::adaptive)
+		{
+			// cool down if too many moves are accepted, heat up if too few
+			double acceptance_rate = static_cast<double>(_accepted_moves_interval) / heuristic_master::_cooling_interval;
+			if (acceptance_rate > heuristic_master::_SA_target_acceptance_rate)
+				_temperature *= heuristic_master::_SA_adaptive_factor;
+			else
+				_temperature /= heuristic_master::_SA_adaptive_factor;
+
+			if (_temperature < heuristic_master::_SA_Tmin)
+				_temperature = heuristic_master::_SA_Tmin;
+			if (_temperature > heuristic_master::_SA_start_temperature)
+				_temperature = heuristic_master::_SA_start_temperature;
+		}
+		else
+		{
+			// the temperature follows from the position in the cooling cycle, so no rounding errors accumulate
+			size_t nb_steps = heuristic_master::_SA_cooling_iterations / heuristic_master::_cooling_interval;
+			if (nb_steps < 1)
+				nb_steps = 1;
+
+			++_cooling_step;
+			if (_cooling_step > nb_steps)
+			{
+				_cooling_step = 0;
+				++_reheats;
+			}
+
+			double fraction = static_cast<double>(_cooling_step) / nb_steps;
+			if (heuristic_master::_cooling_schedule == heuristic_master::cooling_schedule::geometric)
+				_temperature = heuristic_master::_SA_start_temperature * std::pow(heuristic_master::_SA_Tmin / heuristic_master::_SA_start_temperature, fraction);
+			else // _cooling_schedule == cooling_schedule::linear
+				_temperature = heuristic_master::_SA_start_temperature - (heuristic_master::_SA_start_temperature - heuristic_master::_SA_Tmin) * fraction;
+		}
+
+		_accepted_moves_interval = 0;
+	}
+
+
+
+	void heuristic_subprocess::migrate()
+	{
+		// 1. publish the best found solution if it improved since the last publication
+		if (best_objective.objective_value < published_objective)
+		{
+			_elite_pool->publish(_process_id, best_solution, best_objective);
+			published_objective = best_objective.objective_value;
+		}
+
+		size_t nb_islands = _elite_pool->get_nb_islands();
+		if (nb_islands <= 1)
+			return;
+
+		// 2. choose the island to pull a migrant from
+		size_t source = 0;
+		std::uniform_int_distribution<size_t> dist_island(0, nb_islands - 2); // all other islands
+		if (heuristic_master::_migration_topology == heuristic_master::migration_topology::ring)
+		{
+			source = (_process_id + nb_islands - 1) % nb_islands;
+		}
+		else if (heuristic_master::_migration_topology == heuristic_master::migration_topology::random)
+		{
+			source = dist_island(_generator);
+			if (source >= _process_id)
+				++source;
+		}
+		else // _migration_topology == migration_topology::best_of_k
+		{
+			double best_objval = 1e20;
+			for (size_t k = 0; k < heuristic_master::_migration_tournament_size || k == 0; ++k)
+			{
+				size_t island = dist_island(_generator);
+				if (island >= _process_id)
+					++island;
+
+				if (k == 0 || _elite_pool->get_objective_value(island) < best_objval)
+				{
+					best_objval = _elite_pool->get_objective_value(island);
+					source = island;
+				}
+			}
+		}
+
+		// 3. the migrant replaces the current solution if it is better
+		if (_elite_pool->get_objective_value(source) < current_objective.objective_value)
+		{
+			if (_elite_pool->get_solution(source, current_solution, current_objective))
+			{
+				++_solution_version;
+				++_migrations;
+				if (current_objective.objective_value < best_objective.objective_value)
+				{
+					best_objective = current_objective;
+					best_solution = current_solution;
+				}
+			}
+		}
+	}
+
+
+
+	const std::vector<double>& heuristic_subprocess::get_timeslot_flow(const matrix2D<int>& solution, int timeslot)
+	{
+		for (auto&& stored : _timeslot_flows)
+		{
+			if (stored.timeslot == timeslot && stored.solution_version == _solution_version)
+				return stored.flow_per_arc;
+		}
+
+		// not stored: replace the oldest entry
+		timeslot_flow& stored = _timeslot_flows[_next_timeslot_flow];
+		_next_timeslot_flow = 1 - _next_timeslot_flow;
+
+		stored.timeslot = timeslot;
+		stored.solution_version = _solution_version;
+		stored.flow_per_arc.assign(nb_arcs, 0.0);
+		for (int r = 0; r < nb_locations; ++r)
+		{
+			int lec = solution.at(timeslot, r);
+			if (lec >= 0)
+			{
+				for (int ij = 0; ij < nb_arcs; ++ij)
+					stored.flow_per_arc.at(ij) += _room_arc_share.at(r, ij) * session_nb_people.at(lec);
+			}
+		}
+		return stored.flow_per_arc;
+	}
+
+
+
+	double heuristic_subprocess::evaluate_evacuation_timeslot(const matrix2D<int>& solution, int timeslot, int nb_changed, const int* rooms, const int* lectures)
+	{
+		// 1. flow per arc: the flow of the current solution, corrected for the people that leave or enter the changed rooms
+		_candidate_flow = get_timeslot_flow(solution, timeslot); // same size every call, so no allocation
+		for (int k = 0; k < nb_changed; ++k)
+		{
+			int lec_before = solution.at(timeslot, rooms[k]);
+			int lec_after = lectures[k];
+			double people = (lec_after >= 0 ? session_nb_people.at(lec_after) : 0) - (lec_before >= 0 ? session_nb_people.at(lec_before) : 0);
+			if (people != 0)
+			{
+				for (int ij = 0; ij < nb_arcs; ++ij)
+					_candidate_flow.at(ij) += _room_arc_share.at(rooms[k], ij) * people;
+			}
+		}
+
+		// 2. time per arc
+		for (int ij = 0; ij < nb_arcs; ++ij)
+		{
+			_candidate_time.at(ij) = arc_length.at(ij) / walking_alpha * _candidate_flow.at(ij) / arc_area.at(ij) + arc_length.at(ij) / v_max;
+			if (arc_stairs.at(ij))
+				_candidate_time.at(ij) *= speed_correction_stairs;
+		}
+
+		// 3. time per path
+		for (int p = 0; p < nb_paths; ++p)
+		{
+			double time_path = 0.0;
+			for (auto&& ij : _path_arcs.at(p))
+				time_path += _candidate_time.at(ij);
+			_candidate_path_time.at(p) = time_path;
+		}
+
+		// 4. maximum evacuation time: the longest path used by any lecture in the timeslot
+		double max_time = 0.0;
+		for (int r = 0; r < nb_locations; ++r)
+		{
+			int lec = solution.at(timeslot, r);
+			for (int k = 0; k < nb_changed; ++k)
+			{
+				if (rooms[k] == r)
+					lec = lectures[k];
+			}
 
-							//best_solution.print();
-						}
-					}
+			if (lec >= 0)
+			{
+				for (auto&& p : _room_paths.at(r))
+				{
+					if (_candidate_path_time.at(p) > max_time)
+						max_time = _candidate_path_time.at(p);
 				}
 			}
-
 		}
+		return max_time;
 	}
 
 
 
-
-
-
-
-	double heuristic_subprocess::evaluate_incremental(matrix2D<int>& solution, int timeslot, int room1, int room2)
+	double heuristic_subprocess::evaluate_incremental(const matrix2D<int>& solution, int timeslot, int room1, int room2)
 	{
 		// 1. start from current solution
 		new_constraint_violations_scheduling_conflicts = current_objective.constraint_violations_scheduling_conflicts;
@@ -1004,10 +2113,15 @@ namespace alg
 			// does not change
 		}
 
-		// 3. Implement changes
-		int lec_temp = solution.at(timeslot, room1);
-		solution.at(timeslot, room1) = solution.at(timeslot, room2);
-		solution.at(timeslot, room2) = lec_temp;
+		// 3. The solution after the change is read through this mapping, so the solution itself is never changed
+		auto after = [&solution, timeslot, room1, room2](int t, int r) -> int
+		{
+			if (t == timeslot && r == room1)
+				return solution.at(timeslot, room2);
+			if (t == timeslot && r == room2)
+				return solution.at(timeslot, room1);
+			return solution.at(t, r);
+		};
 
 		// 4. Add new values
 		{
@@ -1019,9 +2133,9 @@ namespace alg
 			{
 				int violations = 0;
 
-				if (solution.at(timeslot, room1) >= 0 && !get_sessionlocationpossible(solution.at(timeslot, room1), room1)) // after change to solution
+				if (after(timeslot, room1) >= 0 && !get_sessionlocationpossible(after(timeslot, room1), room1)) // after change to solution
 					++violations;
-				if (solution.at(timeslot, room2) >= 0 && !get_sessionlocationpossible(solution.at(timeslot, room2), room2))
+				if (after(timeslot, room2) >= 0 && !get_sessionlocationpossible(after(timeslot, room2), room2))
 					++violations;
 
 				new_constraint_violations_correct_room += violations;
@@ -1043,74 +2157,10 @@ namespace alg
 		// I. Evacuations
 		double objective_evacuations = 0.0;
 		{
-			current_objective.evacuations_timeslot_lecture_uses_path.fill(0.0);
-			current_objective.evacuations_timeslot_flow_per_arc.fill(0.0);
-			current_objective.evacuations_timeslot_time_per_arc.fill(0.0);
-			current_objective.evacuations_timeslot_lecture_travel_time.fill(0.0);
-			new_max_evac_time_changed_ts_roomswap = 0.0;
-
-			{
-				// 1. who uses which paths
-				for (int r = 0; r < nb_locations; ++r)
-				{
-					int lec = solution.at(timeslot, r);
-					if (lec >= 0)
-					{
-						for (int p = 0; p < nb_paths; ++p)
-							current_objective.evacuations_timeslot_lecture_uses_path.at(timeslot, lec, p) = get_roomroompath(r, nb_locations, p);
-					}
-				}
-
-				// 2. flow per arc
-				for (int ij = 0; ij < nb_arcs; ++ij)
-				{
-					for (int l = 0; l < nb_sessions; ++l)
-					{
-						for (int p = 0; p < nb_paths; ++p)
-						{
-							double nbp = current_objective.evacuations_timeslot_lecture_uses_path.at(timeslot, l, p) * session_nb_people.at(l);
-							if (get_patharc(p, ij))
-								current_objective.evacuations_timeslot_flow_per_arc.at(timeslot, ij) += nbp;
-						}
-					}
-				}
-
-				// 3. time per arc
-				for (int ij = 0; ij < nb_arcs; ++ij)
-				{
-					current_objective.evacuations_timeslot_time_per_arc.at(timeslot, ij) = arc_length.at(ij) / walking_alpha * current_objective.evacuations_timeslot_flow_per_arc.at(timeslot, ij) / arc_area.at(ij) + arc_length.at(ij) / v_max;
-					if (arc_stairs.at(ij))
-						current_objective.evacuations_timeslot_time_per_arc.at(timeslot, ij) *= speed_correction_stairs;
-				}
-
-				// 4. time per lecture in total
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					double time_longest_path = 0.0;
-					for (int p = 0; p < nb_paths; ++p)
-					{
-						if (current_objective.evacuations_timeslot_lecture_uses_path.at(timeslot, l, p) > 0.01)
-						{
-							double time_current_path = 0.0;
-							for (int ij = 0; ij < nb_arcs; ++ij)
-							{
-								if (get_patharc(p, ij))
-									time_current_path += current_objective.evacuations_timeslot_time_per_arc.at(timeslot, ij);
-							}
-							if (time_current_path > time_longest_path)
-								time_longest_path = time_current_path;
-						}
-					}
-					current_objective.evacuations_timeslot_lecture_travel_time.at(timeslot, l) = time_longest_path;
-				}
-
-				// 5. maximum evacuation time per timeslot
-				for (int l = 0; l < nb_sessions; ++l)
-				{
-					if (current_objective.evacuations_timeslot_lecture_travel_time.at(timeslot, l) > new_max_evac_time_changed_ts_roomswap)
-						new_max_evac_time_changed_ts_roomswap = current_objective.evacuations_timeslot_lecture_travel_time.at(timeslot, l);
-				}
-			}
+			// the flows of the timeslot in the current solution are shared by all candidates of a batch, only the two rooms are corrected
+			int rooms[2] = { room1, room2 };
+			int lectures[2] = { after(timeslot, room1), after(timeslot, room2) };
+			new_max_evac_time_changed_ts_roomswap = evaluate_evacuation_timeslot(solution, timeslot, 2, rooms, lectures);
 
 			// 6. objective evacuations
 			if (heuristic_master::_objective_type == heuristic_master::objective_type::maximum_over_timeslots)
@@ -1147,13 +2197,7 @@ namespace alg
 
 
 
-		// 6. Undo changes
-		lec_temp = solution.at(timeslot, room1);
-		solution.at(timeslot, room1) = solution.at(timeslot, room2);
-		solution.at(timeslot, room2) = lec_temp;
-
-
-		// 7. recalculate objective value
+		// 6. recalculate objective value
 		return (heuristic_master::_penalty_value_constraint_violation * (new_constraint_violations_scheduling_conflicts
 			+ new_constraint_violations_correct_room
 			+ new_constraint_violations_teacher_working_time
@@ -1164,7 +2208,7 @@ namespace alg
 
 
 
-	double heuristic_subprocess::evaluate_incremental(matrix2D<int>& solution, int timeslot1, int timeslot2, int room1, int room2)
+	double heuristic_subprocess::evaluate_incremental(const matrix2D<int>& solution, int timeslot1, int timeslot2, int room1, int room2)
 	{
 		// 1. start from current solution
 		new_constraint_violations_scheduling_conflicts = current_objective.constraint_violations_scheduling_conflicts;
@@ -1377,10 +2421,15 @@ namespace alg
 			}
 		}
 
-		// 3. Implement changes
-		int lec_temp = solution.at(timeslot1, room1);
-		solution.at(timeslot1, room1) = solution.at(timeslot2, room2);
-		solution.at(timeslot2, room2) = lec_temp;
+		// 3. The solution after the change is read through this mapping, so the solution itself is never changed
+		auto after = [&solution, timeslot1, timeslot2, room1, room2](int t, int r) -> int
+		{
+			if (t == timeslot1 && r == room1)
+				return solution.at(timeslot2, room2);
+			if (t == timeslot2 && r == room2)
+				return solution.at(timeslot1, room1);
+			return solution.at(t, r);
+		};
 
 		// 4. Add new values
 		{
@@ -1391,9 +2440,9 @@ namespace alg
 				int violations = 0;
 				for (int r = 0; r < nb_locations; ++r)
 				{
-					if (r != room1 && solution.at(timeslot1, room1) >= 0 && solution.at(timeslot1, r) >= 0 && get_sessionsessionconflict(solution.at(timeslot1, room1), solution.at(timeslot1, r)))
+					if (r != room1 && after(timeslot1, room1) >= 0 && after(timeslot1, r) >= 0 && get_sessionsessionconflict(after(timeslot1, room1), after(timeslot1, r)))
 						++violations;
-					if (r != room2 && solution.at(timeslot2, room2) >= 0 && solution.at(timeslot2, r) >= 0 && get_sessionsessionconflict(solution.at(timeslot2, room2), solution.at(timeslot2, r)))
+					if (r != room2 && after(timeslot2, room2) >= 0 && after(timeslot2, r) >= 0 && get_sessionsessionconflict(after(timeslot2, room2), after(timeslot2, r)))
 						++violations;
 				}
 				new_constraint_violations_scheduling_conflicts += violations;
@@ -1404,9 +2453,9 @@ namespace alg
 			{
 				int violations = 0;
 
-				if (solution.at(timeslot1, room1) >= 0 && !get_sessionlocationpossible(solution.at(timeslot1, room1), room1)) // after change to solution
+				if (after(timeslot1, room1) >= 0 && !get_sessionlocationpossible(after(timeslot1, room1), room1)) // after change to solution
 					++violations;
-				if (solution.at(timeslot2, room2) >= 0 && !get_sessionlocationpossible(solution.at(timeslot2, room2), room2))
+				if (after(timeslot2, room2) >= 0 && !get_sessionlocationpossible(after(timeslot2, room2), room2))
 					++violations;
 
 				new_constraint_violations_correct_room += violations;
@@ -1429,7 +2478,7 @@ namespace alg
 						{
 							for (int r = 0; r < nb_locations; ++r)
 							{
-								int lec = solution.at(t, r);
+								int lec = after(t, r);
 								if (lec >= 0 && get_teachersession(d, lec))
 									++teaches;
 							}
@@ -1457,10 +2506,10 @@ namespace alg
 							bool teaches_ts1 = false, teaches_ts2 = false, teaches_ts3 = false, teaches_ts4 = false;
 							for (int r = 0; r < nb_locations; ++r)
 							{
-								int lec1 = solution.at(t, r);
-								int lec2 = solution.at(t + 1, r);
-								int lec3 = solution.at(t + 2, r);
-								int lec4 = solution.at(t + 3, r);
+								int lec1 = after(t, r);
+								int lec2 = after(t + 1, r);
+								int lec3 = after(t + 2, r);
+								int lec4 = after(t + 3, r);
 
 								if (lec1 >= 0 && get_teachersession(d, lec1))
 									++teaches_ts1 = true;
@@ -1493,11 +2542,11 @@ namespace alg
 						bool teaches_t1 = false, teaches_t2 = false;
 						for (int r = 0; r < nb_locations; ++r)
 						{
-							int lec1 = solution.at(last_timeslot_of_previous_day, r);
+							int lec1 = after(last_timeslot_of_previous_day, r);
 							if (lec1 >= 0 && get_teachersession(d, lec1))
 								teaches_t1 = true;
 
-							int lec2 = solution.at(first_timeslot_of_next_day, r);
+							int lec2 = after(first_timeslot_of_next_day, r);
 							if (lec2 >= 0 && get_teachersession(d, lec2))
 								teaches_t2 = true;
 						}
@@ -1522,11 +2571,11 @@ namespace alg
 						bool teaches_t1 = false, teaches_t2 = false;
 						for (int r = 0; r < nb_locations; ++r)
 						{
-							int lec1 = solution.at(last_timeslot_of_day, r);
+							int lec1 = after(last_timeslot_of_day, r);
 							if (lec1 >= 0 && get_teachersession(d, lec1))
 								teaches_t1 = true;
 
-							int lec2 = solution.at(first_timeslot_of_day, r);
+							int lec2 = after(first_timeslot_of_day, r);
 							if (lec2 >= 0 && get_teachersession(d, lec2))
 								teaches_t2 = true;
 						}
@@ -1555,11 +2604,11 @@ namespace alg
 								bool classts1 = false, classts2 = false, classts3 = false;
 								for (int r = 0; r < nb_locations; ++r)
 								{
-									if (solution.at(ts1, r) >= 0 && get_seriessession(s, solution.at(ts1, r)))
+									if (after(ts1, r) >= 0 && get_seriessession(s, after(ts1, r)))
 										classts1 = true;
-									if (solution.at(ts2, r) >= 0 && get_seriessession(s, solution.at(ts2, r)))
+									if (after(ts2, r) >= 0 && get_seriessession(s, after(ts2, r)))
 										classts2 = true;
-									if (solution.at(ts3, r) >= 0 && get_seriessession(s, solution.at(ts3, r)))
+									if (after(ts3, r) >= 0 && get_seriessession(s, after(ts3, r)))
 										classts3 = true;
 								}
 
@@ -1578,10 +2627,10 @@ namespace alg
 
 			// II. OBJECTIVE (PREFERENCES)
 			{
-				int lec = solution.at(timeslot1, room1);
+				int lec = after(timeslot1, room1);
 				if (lec >= 0)
 					new_preference_score += (get_costsessiontimeslot(lec, timeslot1) + 1000 * get_costsession_ts_educational(lec, timeslot1));
-				lec = solution.at(timeslot2, room2);
+				lec = after(timeslot2, room2);
 				if (lec >= 0)
 					new_preference_score += (get_costsessiontimeslot(lec, timeslot2) + 1000 * get_costsession_ts_educational(lec, timeslot2));
 			}
@@ -1597,129 +2646,54 @@ namespace alg
 		// I. Evacuations
 		double objective_evacuations = 0.0;
 		{
-			current_objective.evacuations_timeslot_lecture_uses_path.fill(0.0);
-			current_objective.evacuations_timeslot_flow_per_arc.fill(0.0);
-			current_objective.evacuations_timeslot_time_per_arc.fill(0.0);
-			current_objective.evacuations_timeslot_lecture_travel_time.fill(0.0);
-			new_max_evac_time_changed_ts.at(0) = 0;
-			new_max_evac_time_changed_ts.at(1) = 0;
-
-			int index_ts = 0;
-			for (int t = 0; t < nb_timeslots; ++t)
+			// the flows of both timeslots in the current solution are shared by all candidates of a batch, only the changed rooms are corrected
+			if (timeslot1 == timeslot2)
 			{
-				if (t == timeslot1 || t == timeslot2)
-				{
-					// 1. who uses which paths
-					for (int r = 0; r < nb_locations; ++r)
-					{
-						int lec = solution.at(t, r);
-						if (lec >= 0)
-						{
-							for (int p = 0; p < nb_paths; ++p)
-								current_objective.evacuations_timeslot_lecture_uses_path.at(t, lec, p) = get_roomroompath(r, nb_locations, p);
-						}
-					}
-
-					// 2. flow per arc
-					for (int ij = 0; ij < nb_arcs; ++ij)
-					{
-						for (int l = 0; l < nb_sessions; ++l)
-						{
-							for (int p = 0; p < nb_paths; ++p)
-							{
-								double nbp = current_objective.evacuations_timeslot_lecture_uses_path.at(t, l, p) * session_nb_people.at(l);
-								if (get_patharc(p, ij))
-									current_objective.evacuations_timeslot_flow_per_arc.at(t, ij) += nbp;
-							}
-						}
-					}
-
-					// 3. time per arc
-					for (int ij = 0; ij < nb_arcs; ++ij)
-					{
-						current_objective.evacuations_timeslot_time_per_arc.at(t, ij) = arc_length.at(ij) / walking_alpha * current_objective.evacuations_timeslot_flow_per_arc.at(t, ij) / arc_area.at(ij) + arc_length.at(ij) / v_max;
-						if (arc_stairs.at(ij))
-							current_objective.evacuations_timeslot_time_per_arc.at(t, ij) *= speed_correction_stairs;
-					}
-
-					// 4. time per lecture in total
-					for (int l = 0; l < nb_sessions; ++l)
-					{
-						double time_longest_path = 0.0;
-						for (int p = 0; p < nb_paths; ++p)
-						{
-							if (current_objective.evacuations_timeslot_lecture_uses_path.at(t, l, p) > 0.01)
-							{
-								double time_current_path = 0.0;
-								for (int ij = 0; ij < nb_arcs; ++ij)
-								{
-									if (get_patharc(p, ij))
-										time_current_path += current_objective.evacuations_timeslot_time_per_arc.at(t, ij);
-								}
-								if (time_current_path > time_longest_path)
-									time_longest_path = time_current_path;
-							}
-						}
-						current_objective.evacuations_timeslot_lecture_travel_time.at(t, l) = time_longest_path;
-					}
-
-					// 5. maximum evacuation time per timeslot
-					for (int l = 0; l < nb_sessions; ++l)
-					{
-						if (current_objective.evacuations_timeslot_lecture_travel_time.at(t, l) > new_max_evac_time_changed_ts.at(index_ts))
-							new_max_evac_time_changed_ts.at(index_ts) = current_objective.evacuations_timeslot_lecture_travel_time.at(t, l);
-					}
-
-					++index_ts; // go to next timeslot
-				}
+				int rooms[2] = { room1, room2 };
+				int lectures[2] = { after(timeslot1, room1), after(timeslot1, room2) };
+				new_max_evac_time_changed_ts.at(0) = evaluate_evacuation_timeslot(solution, timeslot1, 2, rooms, lectures);
+				new_max_evac_time_changed_ts.at(1) = new_max_evac_time_changed_ts.at(0);
+			}
+			else
+			{
+				int lecture1 = after(timeslot1, room1);
+				int lecture2 = after(timeslot2, room2);
+				new_max_evac_time_changed_ts.at(0) = evaluate_evacuation_timeslot(solution, timeslot1, 1, &room1, &lecture1);
+				new_max_evac_time_changed_ts.at(1) = evaluate_evacuation_timeslot(solution, timeslot2, 1, &room2, &lecture2);
 			}
 
-			// 6. objective evacuations
+			// objective evacuations
 			if (heuristic_master::_objective_type == heuristic_master::objective_type::maximum_over_timeslots)
 			{
-				index_ts = 0;
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					if (t == timeslot1 || t == timeslot2)
-					{
-						if (new_max_evac_time_changed_ts.at(index_ts) > objective_evacuations)
-							objective_evacuations = new_max_evac_time_changed_ts.at(index_ts);
-						++index_ts;
-					}
-					else
-					{
-						if (current_objective.evacuations_timeslot_max_travel_time.at(t) > objective_evacuations)
-							objective_evacuations = current_objective.evacuations_timeslot_max_travel_time.at(t);
-					}
+					double time = current_objective.evacuations_timeslot_max_travel_time.at(t);
+					if (t == timeslot1)
+						time = new_max_evac_time_changed_ts.at(0);
+					else if (t == timeslot2)
+						time = new_max_evac_time_changed_ts.at(1);
+
+					if (time > objective_evacuations)
+						objective_evacuations = time;
 				}
 			}
 			else // _objective_type == objective_type::sum_over_timeslots
 			{
-				index_ts = 0;
 				for (int t = 0; t < nb_timeslots; ++t)
 				{
-					if (t == timeslot1 || t == timeslot2)
-					{
-						objective_evacuations += new_max_evac_time_changed_ts.at(index_ts);
-						++index_ts;
-					}
+					if (t == timeslot1)
+						objective_evacuations += new_max_evac_time_changed_ts.at(0);
+					else if (t == timeslot2)
+						objective_evacuations += new_max_evac_time_changed_ts.at(1);
 					else
-					{
 						objective_evacuations += current_objective.evacuations_timeslot_max_travel_time.at(t);
-					}
 				}
 			}
 		}
 
 
 
-		// 6. Undo changes
-		lec_temp = solution.at(timeslot1, room1);
-		solution.at(timeslot1, room1) = solution.at(timeslot2, room2);
-		solution.at(timeslot2, room2) = lec_temp;
-
-
-		// 7. recalculate objective value
+		// 6. recalculate objective value
 		return (heuristic_master::_penalty_value_constraint_violation * (new_constraint_violations_scheduling_conflicts
 			+ new_constraint_violations_correct_room
 			+ new_constraint_violations_teacher_working_time
@@ -1730,7 +2704,7 @@ namespace alg
 
 
 
-	double heuristic_subprocess::evaluate_incremental(matrix2D<int>& solution, double current_obj, const std::vector<std::pair<int, int>>& kempe_chain, int timeslot1, int timeslot2)
+	double heuristic_subprocess::evaluate_incremental(const matrix2D<int>& solution, double current_obj, const std::vector<std::pair<int, int>>& kempe_chain, int timeslot1, int timeslot2)
 	{
 		// no empty chain
 		if (kempe_chain.empty())
@@ -1963,56 +2937,18 @@ namespace alg
 		}
 
 
-		// 3. Implement changes
-		for (int ii = 0; ii < kempe_chain.size(); ++ii)
-		{
-			if (ii < kempe_chain.size() - 1)
-			{
-				if (kempe_chain.at(ii).second == kempe_chain.at(ii + 1).second) // two lectures same room different timeslot (by definition timeslot should be different)
-				{
-					// swap two lectures
-					int lec_temp = current_solution.at(kempe_chain.at(ii).first, kempe_chain.at(ii).second);
-					current_solution.at(kempe_chain.at(ii).first, kempe_chain.at(ii).second) = current_solution.at(kempe_chain.at(ii + 1).first, kempe_chain.at(ii + 1).second);
-					current_solution.at(kempe_chain.at(ii + 1).first, kempe_chain.at(ii + 1).second) = lec_temp;
-
-					// two lectures swapped, so skip ii+1
-					++ii;
-				}
-				else
-				{
-					// move lecture in current room to lecture in other room
-					if (kempe_chain.at(ii).first == timeslot1)
-					{
-						int lec_temp = current_solution.at(timeslot1, kempe_chain.at(ii).second);
-						current_solution.at(timeslot1, kempe_chain.at(ii).second) = -1;
-						current_solution.at(timeslot2, kempe_chain.at(ii).second) = lec_temp;
-					}
-					else
-					{
-						int lec_temp = current_solution.at(timeslot2, kempe_chain.at(ii).second);
-						current_solution.at(timeslot2, kempe_chain.at(ii).second) = -1;
-						current_solution.at(timeslot1, kempe_chain.at(ii).second) = lec_temp;
-					}
-				}
-			}
-			else
-			{
-				// move lecture in current room to lecture in other room
-				if (kempe_chain.at(ii).first == timeslot1)
-				{
-					int lec_temp = current_solution.at(timeslot1, kempe_chain.at(ii).second);
-					current_solution.at(timeslot1, kempe_chain.at(ii).second) = -1;
-					current_solution.at(timeslot2, kempe_chain.at(ii).second) = lec_temp;
-				}
-				else
-				{
-					int lec_temp = current_solution.at(timeslot2, kempe_chain.at(ii).second);
-					current_solution.at(timeslot2, kempe_chain.at(ii).second) = -1;
-					current_solution.at(timeslot1, kempe_chain.at(ii).second) = lec_temp;
-				}
-			}
-		}
+		// 3. The solution after the change is read through this mapping, so the solution itself is never changed:
+		// the chain swaps the contents of both timeslots for every room it contains
+		_kempe_room_swapped.assign(nb_locations, 0); // same size every call, so no allocation after the first one
+		for (auto&& node : kempe_chain)
+			_kempe_room_swapped.at(node.second) = 1;
 
+		auto after = [this, &solution, timeslot1, timeslot2](int t, int r) -> int
+		{
+			if ((t == timeslot1 || t == timeslot2) && _kempe_room_swapped.at(r))
+				return solution.at(t == timeslot1 ? timeslot2 : timeslot1, r);
+			return solution.at(t, r);
+		};
 
 		// 4. Add new values
 		{
@@ -2028,7 +2964,7 @@ namespace alg
 					{
 						for (int r2 = r1 + 1; r2 < nb_locations; ++r2)
 						{
-							if (solution.at(t, r1) >= 0 && solution.at(t, r2) >= 0 && get_sessionsessionconflict(solution.at(t, r1), solution.at(t, r2)))
+							if (after(t, r1) >= 0 && after(t, r2) >= 0 && get_sessionsessionconflict(after(t, r1), after(t, r2)))
 								++violations;
 						}
 					}
@@ -2046,7 +2982,7 @@ namespace alg
 						for (int r = 0; r < nb_locations; ++r)
 						{
 
-							if (solution.at(t, r) >= 0 && !get_sessionlocationpossible(solution.at(t, r), r)) // before change to solution
+							if (after(t, r) >= 0 && !get_sessionlocationpossible(after(t, r), r)) // before change to solution
 								++violations;
 
 						}
@@ -2071,7 +3007,7 @@ namespace alg
 						{
 							for (int r = 0; r < nb_locations; ++r)
 							{
-								int lec = solution.at(t, r);
+								int lec = after(t, r);
 								if (lec >= 0 && get_teachersession(d, lec))
 									++teaches;
 							}
@@ -2099,10 +3035,10 @@ namespace alg
 							bool teaches_ts1 = false, teaches_ts2 = false, teaches_ts3 = false, teaches_ts4 = false;
 							for (int r = 0; r < nb_locations; ++r)
 							{
-								int lec1 = solution.at(t, r);
-								int lec2 = solution.at(t + 1, r);
-								int lec3 = solution.at(t + 2, r);
-								int lec4 = solution.at(t + 3, r);
+								int lec1 = after(t, r);
+								int lec2 = after(t + 1, r);
+								int lec3 = after(t + 2, r);
+								int lec4 = after(t + 3, r);
 
 								if (lec1 >= 0 && get_teachersession(d, lec1))
 									++teaches_ts1 = true;
@@ -2135,11 +3071,11 @@ namespace alg
 						bool teaches_t1 = false, teaches_t2 = false;
 						for (int r = 0; r < nb_locations; ++r)
 						{
-							int lec1 = solution.at(last_timeslot_of_previous_day, r);
+							int lec1 = after(last_timeslot_of_previous_day, r);
 							if (lec1 >= 0 && get_teachersession(d, lec1))
 								teaches_t1 = true;
 
-							int lec2 = solution.at(first_timeslot_of_next_day, r);
+							int lec2 = after(first_timeslot_of_next_day, r);
 							if (lec2 >= 0 && get_teachersession(d, lec2))
 								teaches_t2 = true;
 						}
@@ -2164,11 +3100,11 @@ namespace alg
 						bool teaches_t1 = false, teaches_t2 = false;
 						for (int r = 0; r < nb_locations; ++r)
 						{
-							int lec1 = solution.at(last_timeslot_of_day, r);
+							int lec1 = after(last_timeslot_of_day, r);
 							if (lec1 >= 0 && get_teachersession(d, lec1))
 								teaches_t1 = true;
 
-							int lec2 = solution.at(first_timeslot_of_day, r);
+							int lec2 = after(first_timeslot_of_day, r);
 							if (lec2 >= 0 && get_teachersession(d, lec2))
 								teaches_t2 = true;
 						}
@@ -2197,11 +3133,11 @@ namespace alg
 								bool classts1 = false, classts2 = false, classts3 = false;
 								for (int r = 0; r < nb_locations; ++r)
 								{
-									if (solution.at(ts1, r) >= 0 && get_seriessession(s, solution.at(ts1, r)))
+									if (after(ts1, r) >= 0 && get_seriessession(s, after(ts1, r)))
 										classts1 = true;
-									if (solution.at(ts2, r) >= 0 && get_seriessession(s, solution.at(ts2, r)))
+									if (after(ts2, r) >= 0 && get_seriessession(s, after(ts2, r)))
 										classts2 = true;
-									if (solution.at(ts3, r) >= 0 && get_seriessession(s, solution.at(ts3, r)))
+									if (after(ts3, r) >= 0 && get_seriessession(s, after(ts3, r)))
 										classts3 = true;
 								}
 
@@ -2225,7 +3161,7 @@ namespace alg
 				{
 					for (int r = 0; r < nb_locations; ++r)
 					{
-						int lec = solution.at(t, r);
+						int lec = after(t, r);
 						if (lec >= 0)
 							new_preference_score += (get_costsessiontimeslot(lec, t) + 1000 * get_costsession_ts_educational(lec, t));
 					}
@@ -2257,7 +3193,7 @@ namespace alg
 					// 1. who uses which paths
 					for (int r = 0; r < nb_locations; ++r)
 					{
-						int lec = solution.at(t, r);
+						int lec = after(t, r);
 						if (lec >= 0)
 						{
 							for (int p = 0; p < nb_paths; ++p)
@@ -2358,59 +3294,7 @@ namespace alg
 
 
 
-		// 6. Undo changes
-		for (int ii = 0; ii < kempe_chain.size(); ++ii)
-		{
-			if (ii < kempe_chain.size() - 1)
-			{
-				if (kempe_chain.at(ii).second == kempe_chain.at(ii + 1).second) // two lectures same room different timeslot (by definition timeslot should be different)
-				{
-					// swap two lectures
-					int lec_temp = current_solution.at(kempe_chain.at(ii).first, kempe_chain.at(ii).second);
-					current_solution.at(kempe_chain.at(ii).first, kempe_chain.at(ii).second) = current_solution.at(kempe_chain.at(ii + 1).first, kempe_chain.at(ii + 1).second);
-					current_solution.at(kempe_chain.at(ii + 1).first, kempe_chain.at(ii + 1).second) = lec_temp;
-
-					// two lectures swapped, so skip ii+1
-					++ii;
-				}
-				else
-				{
-					// move lecture in current room to lecture in other room
-					if (kempe_chain.at(ii).first == timeslot1)
-					{
-						int lec_temp = current_solution.at(timeslot2, kempe_chain.at(ii).second); // different timeslot because we undo swap
-						current_solution.at(timeslot2, kempe_chain.at(ii).second) = -1;
-						current_solution.at(timeslot1, kempe_chain.at(ii).second) = lec_temp;
-					}
-					else
-					{
-						int lec_temp = current_solution.at(timeslot1, kempe_chain.at(ii).second);  // different timeslot because we undo swap
-						current_solution.at(timeslot1, kempe_chain.at(ii).second) = -1;
-						current_solution.at(timeslot2, kempe_chain.at(ii).second) = lec_temp;
-					}
-				}
-			}
-			else
-			{
-				// move lecture in current room to lecture in other room
-				if (kempe_chain.at(ii).first == timeslot1)
-				{
-					int lec_temp = current_solution.at(timeslot2, kempe_chain.at(ii).second);  // different timeslot because we undo swap
-					current_solution.at(timeslot2, kempe_chain.at(ii).second) = -1;
-					current_solution.at(timeslot1, kempe_chain.at(ii).second) = lec_temp;
-				}
-				else
-				{
-					int lec_temp = current_solution.at(timeslot1, kempe_chain.at(ii).second);  // different timeslot because we undo swap
-					current_solution.at(timeslot1, kempe_chain.at(ii).second) = -1;
-					current_solution.at(timeslot2, kempe_chain.at(ii).second) = lec_temp;
-				}
-			}
-		}
-
-
-
-		// 7. recalculate objective value
+		// 6. recalculate objective value
 		return (heuristic_master::_penalty_value_constraint_violation * (new_constraint_violations_scheduling_conflicts
 			+ new_constraint_violations_correct_room
 			+ new_constraint_violations_teacher_working_time
@@ -9,7 +9,12 @@
 
 #include <vector>
 #include <iostream>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
 #include "heuristic_utilities.h"
+#include "MIP_utilities.h"
 
 /*!
 *	@namespace	alg
@@ -132,6 +137,620 @@ namespace alg
 
 
 
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	*	@brief	Acceptance statistics of one type of move.
+	*/
+	struct move_statistics
+	{
+		/*!
+		*	@brief	The number of times the move was tried.
+		*/
+		size_t attempted = 0;
+
+		/*!
+		*	@brief	The number of accepted moves that improved the current solution.
+		*/
+		size_t accepted_improving = 0;
+
+		/*!
+		*	@brief	The number of accepted moves that did not improve the current solution.
+		*/
+		size_t accepted_worsening = 0;
+
+		/*!
+		*	@brief	Add the statistics of another subprocess.
+		*	@param	other	The statistics to add.
+		*/
+		move_statistics& operator+=(const move_statistics& other)
+		{
+			attempted += other.attempted;
+			accepted_improving += other.accepted_improving;
+			accepted_worsening += other.accepted_worsening;
+			return *this;
+		}
+	};
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	*	@brief	The result of the incremental evaluation of one candidate move, so that it can be kept while other candidates are evaluated.
+	*/
+	struct incremental_evaluation
+	{
+		/*!
+		*	@brief	The objective value of the solution after the move.
+		*/
+		double objective_value = 1e20;
+
+		/*!
+		*	@brief	The number of constraint violations for the scheduling conflicts after the move.
+		*/
+		double constraint_violations_scheduling_conflicts = 0;
+
+		/*!
+		*	@brief	The number of constraint violations for the room compatibilities after the move.
+		*/
+		double constraint_violations_correct_room = 0;
+
+		/*!
+		*	@brief	The number of teacher working time violations after the move.
+		*/
+		double constraint_violations_teacher_working_time = 0;
+
+		/*!
+		*	@brief	The number of constraint violations for the compactness constraints after the move.
+		*/
+		double constraint_violations_compactness_constraints = 0;
+
+		/*!
+		*	@brief	The preference score after the move.
+		*/
+		double preference_score = 0;
+
+		/*!
+		*	@brief	The evacuation time in the changed timeslot after a room swap.
+		*/
+		double max_evac_time_changed_ts_roomswap = 0;
+
+		/*!
+		*	@brief	The evacuation times in the two changed timeslots after a lecture swap or Kempe chain.
+		*/
+		double max_evac_time_changed_ts[2] = { 0, 0 };
+	};
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	*	@brief	The evacuation flow per arc of one timeslot of the current solution, shared by the candidate moves of a batch.
+	*/
+	struct timeslot_flow
+	{
+		/*!
+		*	@brief	The timeslot (-1 if nothing is stored).
+		*/
+		int timeslot = -1;
+
+		/*!
+		*	@brief	The version of the current solution for which the flow was calculated.
+		*/
+		size_t solution_version = 0;
+
+		/*!
+		*	@brief	The flow on every arc.
+		*/
+		std::vector<double> flow_per_arc;
+	};
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	*	@brief	Pool with the best solution published by every island (subprocess) in the asynchronous island model.
+	*	Every island owns one slot, so publishing only locks the own slot and reading the objective values is lock-free.
+	*/
+	class elite_pool
+	{
+		/*!
+		*	@brief	The solution published by one island.
+		*/
+		struct elite_slot
+		{
+			/*!
+			*	@brief	Protects the solution and its objective value information while they are copied.
+			*/
+			std::mutex mutex;
+
+			/*!
+			*	@brief	The published solution.
+			*/
+			matrix2D<int> solution;
+
+			/*!
+			*	@brief	The objective value information of the published solution.
+			*/
+			information_objective_value objective;
+
+			/*!
+			*	@brief	The objective value of the published solution, readable without locking (1e20 if nothing is published yet).
+			*/
+			std::atomic<double> objective_value{ 1e20 };
+		};
+
+		/*!
+		*	@brief	One slot per island.
+		*/
+		std::vector<std::unique_ptr<elite_slot>> _slots;
+
+	public:
+		/*!
+		*	@brief	Create an empty slot for every island.
+		*	@param	nb_islands	The number of islands.
+		*/
+		void initialize(size_t nb_islands);
+
+		/*!
+		*	@brief	Get the number of islands.
+		*	@returns	The number of islands.
+		*/
+		size_t get_nb_islands() const { return _slots.size(); }
+
+		/*!
+		*	@brief	Get the objective value of the solution published by an island without locking.
+		*	@param	island	The island.
+		*	@returns	The objective value of the published solution, or 1e20 if the island hasn't published anything yet.
+		*/
+		double get_objective_value(size_t island) const { return _slots.at(island)->objective_value.load(std::memory_order_acquire); }
+
+		/*!
+		*	@brief	Publish a solution in the slot of an island.
+		*	@param	island	The island that publishes the solution.
+		*	@param	solution	The solution.
+		*	@param	objective	The objective value information of the solution.
+		*/
+		void publish(size_t island, const matrix2D<int>& solution, const information_objective_value& objective);
+
+		/*!
+		*	@brief	Copy the solution published by an island.
+		*	@param	island	The island from which the solution is copied.
+		*	@param	solution	The copied solution.
+		*	@param	objective	The copied objective value information.
+		*	@returns	True if the island has published a solution, false otherwise.
+		*/
+		bool get_solution(size_t island, matrix2D<int>& solution, information_objective_value& objective) const;
+	};
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	class heuristic_subprocess;
+
+	/*!
+	*	@brief	Base class for the moves of the SA heuristic.
+	*	delta() evaluates the move against the current solution of a subprocess without changing that solution,
+	*	apply() implements the move with the values computed by delta(), and undo() restores the solution and the values from before apply().
+	*/
+	class heuristic_move
+	{
+	protected:
+		/*!
+		*	@brief	The values of the current solution after the move, computed by delta().
+		*/
+		incremental_evaluation _evaluation;
+
+		/*!
+		*	@brief	The values of the current solution before the move, saved by apply() for undo().
+		*/
+		incremental_evaluation _previous;
+
+	public:
+		/*!
+		*	@brief	Destructor.
+		*/
+		virtual ~heuristic_move() { }
+
+		/*!
+		*	@brief	Get the objective value of the current solution after the move (valid after delta()).
+		*	@returns	The objective value after the move.
+		*/
+		double get_objective_value() const { return _evaluation.objective_value; }
+
+		/*!
+		*	@brief	Evaluate the move against the current solution of a subprocess; the solution is only read.
+		*	@param	process	The subprocess.
+		*	@returns	The change in objective value if the move is applied.
+		*/
+		virtual double delta(heuristic_subprocess& process) = 0;
+
+		/*!
+		*	@brief	Implement the move in the current solution of a subprocess, using the values computed by delta().
+		*	@param	process	The subprocess.
+		*/
+		virtual void apply(heuristic_subprocess& process) = 0;
+
+		/*!
+		*	@brief	Undo the move after apply().
+		*	@param	process	The subprocess.
+		*/
+		virtual void undo(heuristic_subprocess& process) = 0;
+
+		/*!
+		*	@brief	Get the name of the move.
+		*	@returns	The name of the move.
+		*/
+		virtual const char * get_name() const = 0;
+	};
+
+
+
+	/*!
+	*	@brief	Swap the lectures (or empty rooms) of two rooms in the same timeslot.
+	*/
+	class room_swap_move : public heuristic_move
+	{
+		/*!
+		*	@brief	The timeslot of the swap.
+		*/
+		int _timeslot;
+
+		/*!
+		*	@brief	The first room in the swap.
+		*/
+		int _room1;
+
+		/*!
+		*	@brief	The second room in the swap.
+		*/
+		int _room2;
+
+	public:
+		/*!
+		*	@brief	Constructor.
+		*	@param	timeslot	The timeslot of the swap.
+		*	@param	room1		The first room in the swap.
+		*	@param	room2		The second room in the swap.
+		*/
+		room_swap_move(int timeslot = 0, int room1 = 0, int room2 = 0) : _timeslot(timeslot), _room1(room1), _room2(room2) { }
+
+		double delta(heuristic_subprocess& process) override;
+		void apply(heuristic_subprocess& process) override;
+		void undo(heuristic_subprocess& process) override;
+		const char * get_name() const override { return "Room Swap"; }
+	};
+
+
+
+	/*!
+	*	@brief	Swap the lectures (or empty rooms) of a room in one timeslot and a room in another timeslot.
+	*/
+	class lecture_swap_move : public heuristic_move
+	{
+		/*!
+		*	@brief	The first timeslot in the swap.
+		*/
+		int _timeslot1;
+
+		/*!
+		*	@brief	The second timeslot in the swap.
+		*/
+		int _timeslot2;
+
+		/*!
+		*	@brief	The room in the first timeslot.
+		*/
+		int _room1;
+
+		/*!
+		*	@brief	The room in the second timeslot.
+		*/
+		int _room2;
+
+	public:
+		/*!
+		*	@brief	Constructor.
+		*	@param	timeslot1	The first timeslot in the swap.
+		*	@param	timeslot2	The second timeslot in the swap.
+		*	@param	room1		The room in the first timeslot.
+		*	@param	room2		The room in the second timeslot.
+		*/
+		lecture_swap_move(int timeslot1 = 0, int timeslot2 = 0, int room1 = 0, int room2 = 0) : _timeslot1(timeslot1), _timeslot2(timeslot2), _room1(room1), _room2(room2) { }
+
+		double delta(heuristic_subprocess& process) override;
+		void apply(heuristic_subprocess& process) override;
+		void undo(heuristic_subprocess& process) override;
+		const char * get_name() const override { return "Lecture Swap"; }
+	};
+
+
+
+	/*!
+	*	@brief	Swap the contents of two timeslots for all rooms in a Kempe chain.
+	*/
+	class kempe_chain_move : public heuristic_move
+	{
+		/*!
+		*	@brief	The first timeslot in the Kempe chain.
+		*/
+		int _timeslot1;
+
+		/*!
+		*	@brief	The second timeslot in the Kempe chain.
+		*/
+		int _timeslot2;
+
+		/*!
+		*	@brief	The Kempe chain (timeslot, room) sorted on room; must stay valid until the move is applied or undone.
+		*/
+		const std::vector<std::pair<int, int>>* _chain;
+
+	public:
+		/*!
+		*	@brief	Constructor.
+		*	@param	timeslot1	The first timeslot in the Kempe chain.
+		*	@param	timeslot2	The second timeslot in the Kempe chain.
+		*	@param	chain		The Kempe chain.
+		*/
+		kempe_chain_move(int timeslot1, int timeslot2, const std::vector<std::pair<int, int>>& chain) : _timeslot1(timeslot1), _timeslot2(timeslot2), _chain(&chain) { }
+
+		/*!
+		*	@brief	Constructor for a chain that has already been evaluated (e.g. in parallel), so delta() needn't be called.
+		*	@param	timeslot1	The first timeslot in the Kempe chain.
+		*	@param	timeslot2	The second timeslot in the Kempe chain.
+		*	@param	chain		The Kempe chain.
+		*	@param	evaluation	The evaluation of the chain.
+		*/
+		kempe_chain_move(int timeslot1, int timeslot2, const std::vector<std::pair<int, int>>& chain, const incremental_evaluation& evaluation) : _timeslot1(timeslot1), _timeslot2(timeslot2), _chain(&chain) { _evaluation = evaluation; }
+
+		double delta(heuristic_subprocess& process) override;
+		void apply(heuristic_subprocess& process) override;
+		void undo(heuristic_subprocess& process) override;
+		const char * get_name() const override { return "Kempe Chain"; }
+	};
+
+
+
+	/*!
+	*	@brief	Swap two days: every timeslot of the first day swaps the contents of all its rooms with the same timeslot of the second day.
+	*	The contents of a timeslot move as a whole, so only the preferences and the teacher working time between consecutive days change;
+	*	the evacuation time of every timeslot moves along with its contents.
+	*/
+	class day_swap_move : public heuristic_move
+	{
+		/*!
+		*	@brief	The first day in the swap.
+		*/
+		int _day1;
+
+		/*!
+		*	@brief	The second day in the swap.
+		*/
+		int _day2;
+
+		/*!
+		*	@brief	Get the timeslot whose contents are in a given timeslot after the swap.
+		*	@param	timeslot	The timeslot.
+		*	@returns	The timeslot before the swap.
+		*/
+		int swapped_timeslot(int timeslot) const;
+
+		/*!
+		*	@brief	Swap the contents and the evacuation times of the two days in the current solution of a subprocess.
+		*	@param	process	The subprocess.
+		*/
+		void swap_days(heuristic_subprocess& process) const;
+
+	public:
+		/*!
+		*	@brief	Constructor.
+		*	@param	day1	The first day in the swap.
+		*	@param	day2	The second day in the swap.
+		*/
+		day_swap_move(int day1 = 0, int day2 = 0) : _day1(day1), _day2(day2) { }
+
+		double delta(heuristic_subprocess& process) override;
+		void apply(heuristic_subprocess& process) override;
+		void undo(heuristic_subprocess& process) override;
+		const char * get_name() const override { return "Day Swap"; }
+	};
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	*	@brief	Base class for the neighbourhoods of the SA heuristic.
+	*	A neighbourhood draws candidate moves of one kind, evaluates them, and applies the chosen move if it is accepted.
+	*	One object is shared by all subprocesses, so explore() may not change the neighbourhood itself.
+	*/
+	class heuristic_neighbourhood
+	{
+	public:
+		/*!
+		*	@brief	Destructor.
+		*/
+		virtual ~heuristic_neighbourhood() { }
+
+		/*!
+		*	@brief	Get the name of the neighbourhood.
+		*	@returns	The name of the neighbourhood.
+		*/
+		virtual const char * get_name() const = 0;
+
+		/*!
+		*	@brief	Explore the neighbourhood once from the current solution of a subprocess.
+		*	@param	process	The subprocess.
+		*	@param	acceptance_threshold	The Metropolis threshold of this iteration: the relative deterioration that is still accepted.
+		*	@param	statistics	The acceptance statistics of this neighbourhood in the subprocess.
+		*/
+		virtual void explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const = 0;
+
+	protected:
+		/*!
+		*	@brief	Get the random number generator of a subprocess.
+		*	@param	process	The subprocess.
+		*	@returns	The random number generator.
+		*/
+		static std::mt19937_64& get_generator(heuristic_subprocess& process);
+
+		/*!
+		*	@brief	Get the current solution of a subprocess.
+		*	@param	process	The subprocess.
+		*	@returns	The current solution.
+		*/
+		static const matrix2D<int>& get_solution(const heuristic_subprocess& process);
+
+		/*!
+		*	@brief	Check the acceptance rule for a candidate move.
+		*	@param	process	The subprocess.
+		*	@param	candidate_objective	The objective value after the move.
+		*	@param	acceptance_threshold	The Metropolis threshold of this iteration.
+		*	@returns	True if the move is accepted, false otherwise.
+		*/
+		static bool is_acceptable(const heuristic_subprocess& process, double candidate_objective, double acceptance_threshold);
+
+		/*!
+		*	@brief	Apply an accepted move in a subprocess.
+		*	@param	process	The subprocess.
+		*	@param	move	The accepted move (delta() has been called).
+		*	@param	statistics	The acceptance statistics of this neighbourhood.
+		*/
+		static void accept(heuristic_subprocess& process, heuristic_move& move, move_statistics& statistics);
+	};
+
+
+
+	/*!
+	*	@brief	Lecture swaps between two random timeslots (a batch of heuristic_master::_batch_size candidates).
+	*/
+	class lecture_swap_neighbourhood : public heuristic_neighbourhood
+	{
+	public:
+		const char * get_name() const override { return "Lecture swap"; }
+		void explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const override;
+	};
+
+
+
+	/*!
+	*	@brief	Room swaps in a random timeslot (a batch of heuristic_master::_batch_size candidates).
+	*/
+	class room_swap_neighbourhood : public heuristic_neighbourhood
+	{
+	public:
+		const char * get_name() const override { return "Room swap"; }
+		void explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const override;
+	};
+
+
+
+	/*!
+	*	@brief	The best Kempe chain between two random timeslots with lectures.
+	*/
+	class kempe_chain_neighbourhood : public heuristic_neighbourhood
+	{
+	public:
+		const char * get_name() const override { return "Kempe chain"; }
+		void explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const override;
+	};
+
+
+
+	/*!
+	*	@brief	Move a single lecture to an empty room in any timeslot (a batch of heuristic_master::_batch_size candidates).
+	*/
+	class relocate_neighbourhood : public heuristic_neighbourhood
+	{
+	public:
+		const char * get_name() const override { return "Relocate"; }
+		void explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const override;
+	};
+
+
+
+	/*!
+	*	@brief	Swap two random days.
+	*/
+	class day_swap_neighbourhood : public heuristic_neighbourhood
+	{
+	public:
+		const char * get_name() const override { return "Day swap"; }
+		void explore(heuristic_subprocess& process, double acceptance_threshold, move_statistics& statistics) const override;
+	};
+
+
+
+	/*!
+	*	@brief	The neighbourhoods from which the subprocesses choose a move in every iteration.
+	*/
+	class neighbourhood_registry
+	{
+		/*!
+		*	@brief	The registered neighbourhoods.
+		*/
+		std::vector<std::unique_ptr<heuristic_neighbourhood>> _neighbourhoods;
+
+		/*!
+		*	@brief	The probability of every neighbourhood.
+		*/
+		std::vector<double> _probabilities;
+
+	public:
+		/*!
+		*	@brief	Create a registry with the built-in neighbourhoods: lecture swap (0.6), room swap (0.38), Kempe chain (0.02), relocate (0) and day swap (0).
+		*	Relocate and day swap are therefore only chosen with adaptive selection, unless their probability is changed.
+		*	@returns	The registry.
+		*/
+		static neighbourhood_registry create_default();
+
+		/*!
+		*	@brief	Register a neighbourhood.
+		*	@param	neighbourhood	The neighbourhood.
+		*	@param	probability		The probability of the neighbourhood with fixed selection and its initial weight with adaptive selection (normalized over all neighbourhoods).
+		*/
+		void add(std::unique_ptr<heuristic_neighbourhood> neighbourhood, double probability);
+
+		/*!
+		*	@brief	Remove all neighbourhoods.
+		*/
+		void clear() { _neighbourhoods.clear(); _probabilities.clear(); }
+
+		/*!
+		*	@brief	Get the number of neighbourhoods.
+		*	@returns	The number of neighbourhoods.
+		*/
+		size_t size() const { return _neighbourhoods.size(); }
+
+		/*!
+		*	@brief	Get a neighbourhood.
+		*	@param	index	The index of the neighbourhood.
+		*	@returns	The neighbourhood.
+		*/
+		const heuristic_neighbourhood& get_neighbourhood(size_t index) const { return *_neighbourhoods.at(index); }
+
+		/*!
+		*	@brief	Get the probability of a neighbourhood.
+		*	@param	index	The index of the neighbourhood.
+		*	@returns	The probability (not normalized).
+		*/
+		double get_probability(size_t index) const { return _probabilities.at(index); }
+
+		/*!
+		*	@brief	Set the probability of a neighbourhood.
+		*	@param	index	The index of the neighbourhood.
+		*	@param	probability	The probability (not normalized).
+		*/
+		void set_probability(size_t index, double probability) { _probabilities.at(index) = probability; }
+	};
+
+
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	/*!
@@ -139,71 +758,234 @@ namespace alg
 	*/
 	class heuristic_subprocess
 	{
+		friend class room_swap_move;
+		friend class lecture_swap_move;
+		friend class kempe_chain_move;
+		friend class day_swap_move;
+		friend class heuristic_neighbourhood;
+		friend class kempe_chain_neighbourhood;
+
+		/*!
+		*	@brief	The objective value of the current solution.
+		*/
+		information_objective_value current_objective;
+
+		/*!
+		*	@brief	The current timetable solution.
+		*	Matrix in which the rows indicate the timeslot and the columns the room.
+		*	The value in a cell indicates the lecture that is assigned to that timeslot and room.
+		*/
+		matrix2D<int> current_solution;
+
+		/*!
+		*	@brief	The objective value of the best found solution.
+		*/
+		information_objective_value best_objective;
+
+		/*!
+		*	@brief	The best timetable solution found during the search process.
+		*	Matrix in which the rows indicate the timeslot and the columns the room.
+		*	The value in a cell indicates the lecture that is assigned to that timeslot and room.
+		*/
+		matrix2D<int> best_solution;
+
+		/*!
+		*	@brief	Count and remember the number of constraint violations for the scheduling conflicts when recalculating the objective value for a candidate solution.
+		*/
+		double new_constraint_violations_scheduling_conflicts;
+
+		/*!
+		*	@brief	Count and remember the number of constraint violations for the room compatibilities when recalculating the objective value for a candidate solution.
+		*/
+		double new_constraint_violations_correct_room;
+
+		/*!
+		*	@brief	Count and remember the number of teacher working time violations when recalculating the objective value for a candidate solution.
+		*/
+		double new_constraint_violations_teacher_working_time;
+
+		/*!
+		*	@brief	Count and remember the number of constraint violations for the compactness constraints when recalculating the objective value for a candidate solution.
+		*/
+		double new_constraint_violations_compactness_constraints;
+
+		/*!
+		*	@brief	Calculate and remember the preference score when recalculating the objective value for a candidate solution.
+		*/
+		double new_preference_score;
+
+		/*!
+		*	@brief	New value for the evacuation time in the timeslot that is changed during a room swap.
+		*	Used to updated the values of the vector with the evacuation times for all timeslots.
+		*/
+		double new_max_evac_time_changed_ts_roomswap = 0.0;
+
+		/*!
+		*	@brief	New value for the evacuation times in the timeslots that are changed during a lecture swap or Kempe chain.
+		*	Used to updated the values of the vector with the evacuation times for all timeslots.
+		*/
+		std::vector<double> new_max_evac_time_changed_ts{ 0.0, 0.0 };
+
+		/*!
+		*	@brief	The number of iterations.
+		*/
+		size_t _iterations = 0;
+
+		/*!
+		*	@brief	Incremented whenever the current solution changes, so that cached values of the current solution can be recognized as outdated.
+		*/
+		size_t _solution_version = 1;
+
+		/*!
+		*	@brief	The evacuation flows of the two timeslots that were evaluated last; the candidates of a batch share them.
+		*/
+		timeslot_flow _timeslot_flows[2];
+
+		/*!
+		*	@brief	The entry of _timeslot_flows that is replaced next.
+		*/
+		size_t _next_timeslot_flow = 0;
+
+		/*!
+		*	@brief	Matrix in which the rows indicate the room and the columns the arc: the fraction of the people in the room that evacuates over the arc.
+		*/
+		matrix2D<double> _room_arc_share;
+
 		/*!
-		*	@brief	The objective value of the current solution.
+		*	@brief	The paths used for the evacuation of every room.
 		*/
-		information_objective_value current_objective;
+		std::vector<std::vector<int>> _room_paths;
 
 		/*!
-		*	@brief	The current timetable solution.
-		*	Matrix in which the rows indicate the timeslot and the columns the room.
-		*	The value in a cell indicates the lecture that is assigned to that timeslot and room.
+		*	@brief	The arcs of every path.
 		*/
-		matrix2D<int> current_solution;
+		std::vector<std::vector<int>> _path_arcs;
 
 		/*!
-		*	@brief	The objective value of the best found solution.
+		*	@brief	Scratch space for the flow per arc of a candidate move.
 		*/
-		information_objective_value best_objective;
+		std::vector<double> _candidate_flow;
 
 		/*!
-		*	@brief	The best timetable solution found during the search process.
-		*	Matrix in which the rows indicate the timeslot and the columns the room.
-		*	The value in a cell indicates the lecture that is assigned to that timeslot and room.
+		*	@brief	Scratch space for the time per arc of a candidate move.
 		*/
-		matrix2D<int> best_solution;
+		std::vector<double> _candidate_time;
 
 		/*!
-		*	@brief	Count and remember the number of constraint violations for the scheduling conflicts when recalculating the objective value for a candidate solution.
+		*	@brief	Scratch space for the time per path of a candidate move.
 		*/
-		double new_constraint_violations_scheduling_conflicts;
+		std::vector<double> _candidate_path_time;
 
 		/*!
-		*	@brief	Count and remember the number of constraint violations for the room compatibilities when recalculating the objective value for a candidate solution.
+		*	@brief	The SA temperature of this subprocess.
 		*/
-		double new_constraint_violations_correct_room;
+		double _temperature = 1;
 
 		/*!
-		*	@brief	Count and remember the number of teacher working time violations when recalculating the objective value for a candidate solution.
+		*	@brief	The number of temperature updates since the start of the current cooling cycle (iteration-based cooling schedules).
 		*/
-		double new_constraint_violations_teacher_working_time;
+		size_t _cooling_step = 0;
 
 		/*!
-		*	@brief	Count and remember the number of constraint violations for the compactness constraints when recalculating the objective value for a candidate solution.
+		*	@brief	The number of accepted moves since the last temperature update (adaptive cooling schedule).
 		*/
-		double new_constraint_violations_compactness_constraints;
+		size_t _accepted_moves_interval = 0;
 
 		/*!
-		*	@brief	Calculate and remember the preference score when recalculating the objective value for a candidate solution.
+		*	@brief	The number of reheats of this subprocess (iteration-based cooling schedules).
 		*/
-		double new_preference_score;
+		size_t _reheats = 0;
 
 		/*!
-		*	@brief	New value for the evacuation time in the timeslot that is changed during a room swap.
-		*	Used to updated the values of the vector with the evacuation times for all timeslots.
+		*	@brief	The acceptance statistics of every neighbourhood (same order as heuristic_master::_neighbourhoods).
 		*/
-		double new_max_evac_time_changed_ts_roomswap = 0.0;
+		std::vector<move_statistics> _move_statistics;
 
 		/*!
-		*	@brief	New value for the evacuation times in the timeslots that are changed during a lecture swap or Kempe chain.
-		*	Used to updated the values of the vector with the evacuation times for all timeslots.
+		*	@brief	The cumulative probability with which every neighbourhood is chosen (not normalized: the last value is the total).
 		*/
-		std::vector<double> new_max_evac_time_changed_ts{ 0.0, 0.0 };
+		std::vector<double> _neighbourhood_cumulative_probability;
 
 		/*!
-		*	@brief	The number of iterations.
+		*	@brief	Adaptive selection: the weight of every neighbourhood (sums to one).
 		*/
-		size_t _iterations = 0;
+		std::vector<double> _neighbourhood_weight;
+
+		/*!
+		*	@brief	Adaptive selection: the relative improvement of the current solution by every neighbourhood in the current segment.
+		*/
+		std::vector<double> _neighbourhood_improvement;
+
+		/*!
+		*	@brief	Adaptive selection: the time spent in every neighbourhood in the current segment (in seconds).
+		*/
+		std::vector<double> _neighbourhood_time;
+
+		/*!
+		*	@brief	The Kempe chains of the current Kempe chain move; only the first _nb_kempe_chains are valid.
+		*	The buffers are reused across moves, so building the chains doesn't allocate memory once they have grown.
+		*/
+		std::vector<std::vector<std::pair<int, int>>> _kempe_chains;
+
+		/*!
+		*	@brief	The number of valid chains in _kempe_chains.
+		*/
+		size_t _nb_kempe_chains = 0;
+
+		/*!
+		*	@brief	Marks the cells of the two timeslots of a Kempe chain move that already belong to a chain.
+		*/
+		std::vector<char> _kempe_visited;
+
+		/*!
+		*	@brief	The lectures with which every lecture has a scheduling conflict.
+		*/
+		std::vector<std::vector<int>> _lecture_conflicts;
+
+		/*!
+		*	@brief	The node (side * nb_locations + room) of every lecture in the two timeslots of the Kempe chain move that is being built, -1 for the other lectures.
+		*/
+		std::vector<int> _kempe_lecture_node;
+
+		/*!
+		*	@brief	Marks the rooms of the Kempe chain that is being evaluated.
+		*/
+		std::vector<char> _kempe_room_swapped;
+
+		/*!
+		*	@brief	Copies of this subprocess that evaluate Kempe chains in parallel (only used if heuristic_master::_kempe_nb_threads > 1).
+		*/
+		std::vector<heuristic_subprocess> _kempe_evaluators;
+
+		/*!
+		*	@brief	The persistent threads that run _kempe_evaluators (started on the first parallel evaluation).
+		*/
+		worker_group_handle _kempe_workers;
+
+		/*!
+		*	@brief	The evaluation of the best chain of every Kempe evaluator.
+		*/
+		std::vector<incremental_evaluation> _kempe_worker_best_chain;
+
+		/*!
+		*	@brief	The index of the best chain of every Kempe evaluator (-1 if none).
+		*/
+		std::vector<int> _kempe_worker_best_index;
+
+		/*!
+		*	@brief	The random number generator of this subprocess.
+		*/
+		std::mt19937_64 _generator;
+
+		/*!
+		*	@brief	The objective value of the last solution this subprocess published in the elite pool.
+		*/
+		double published_objective = 1e20;
+
+		/*!
+		*	@brief	The number of migrants that were accepted.
+		*/
+		size_t _migrations = 0;
 
 
 
@@ -213,6 +995,59 @@ namespace alg
 		*/
 		size_t _process_id;
 
+		/*!
+		*	@brief	The elite pool of the asynchronous island model (nullptr if the island model is not used).
+		*/
+		elite_pool* _elite_pool = nullptr;
+
+		/*!
+		*	@brief	Get the SA temperature of this subprocess.
+		*	@returns	The SA temperature.
+		*/
+		double get_temperature() const { return _temperature; }
+
+		/*!
+		*	@brief	Set the SA temperature of this subprocess.
+		*	@param	temperature	The SA temperature.
+		*/
+		void set_temperature(double temperature) { _temperature = temperature; }
+
+		/*!
+		*	@brief	Get the acceptance statistics of a move.
+		*	@param	neighbourhood	The index of the neighbourhood (same order as heuristic_master::_neighbourhoods).
+		*	@returns	The acceptance statistics.
+		*/
+		const move_statistics& get_move_statistics(size_t neighbourhood) const { return _move_statistics.at(neighbourhood); }
+
+		/*!
+		*	@brief	Get the probability with which a neighbourhood is currently chosen.
+		*	@param	neighbourhood	The index of the neighbourhood (same order as heuristic_master::_neighbourhoods).
+		*	@returns	The probability.
+		*/
+		double get_neighbourhood_probability(size_t neighbourhood) const
+		{
+			double previous = (neighbourhood > 0) ? _neighbourhood_cumulative_probability.at(neighbourhood - 1) : 0.0;
+			return (_neighbourhood_cumulative_probability.at(neighbourhood) - previous) / _neighbourhood_cumulative_probability.back();
+		}
+
+		/*!
+		*	@brief	Get the number of reheats of this subprocess.
+		*	@returns	The number of reheats.
+		*/
+		size_t get_reheats() const { return _reheats; }
+
+		/*!
+		*	@brief	Get the objective value of the current solution.
+		*	@returns	The objective value of the current solution.
+		*/
+		double get_current_objective_value() const { return current_objective.objective_value; }
+
+		/*!
+		*	@brief	Get the number of accepted migrants.
+		*	@returns	The number of accepted migrants.
+		*/
+		size_t get_migrations() const { return _migrations; }
+
 		/*!
 		*	@brief	Get the number of iterations.
 		*	@returns	The number of iterations.
@@ -220,9 +1055,10 @@ namespace alg
 		size_t get_iterations() const { return _iterations; }
 
 		/*!
-		*	@brief	Initialize the matrices for use during the algorithm.
+		*	@brief	Initialize the matrices and the random number generator for use during the algorithm.
+		*	@param	seed	The seed of the random number generator.
 		*/
-		void initialize();
+		void initialize(unsigned long long seed);
 
 		/*!
 		*	@brief	Run the process for the given time limit.
@@ -251,43 +1087,147 @@ namespace alg
 		void set_solution(const matrix2D<int>& solution, const information_objective_value &objective_value)
 		{
 			current_solution = solution;	current_objective = objective_value;
+			++_solution_version;
 			best_solution = solution;		best_objective = objective_value;
 		}
 
 
 
 	private:
+		/*!
+		*	@brief	Check the Metropolis acceptance rule for a candidate move.
+		*	@param	candidate_objective	The objective value after the move.
+		*	@param	acceptance_threshold	The relative deterioration that is still accepted in this iteration.
+		*	@returns	True if the move is accepted, false otherwise.
+		*/
+		bool is_acceptable(double candidate_objective, double acceptance_threshold) const;
+
+		/*!
+		*	@brief	Choose a neighbourhood by roulette wheel selection on the current probabilities.
+		*	@returns	The index of the chosen neighbourhood.
+		*/
+		size_t select_neighbourhood();
+
+		/*!
+		*	@brief	Calculate the probabilities of the neighbourhoods from their weights, with at least heuristic_master::_adaptive_min_probability each.
+		*/
+		void calculate_neighbourhood_probabilities();
+
+		/*!
+		*	@brief	Adaptive selection: at the end of a segment, move the weights towards the share of every neighbourhood in the relative improvement per second.
+		*/
+		void update_neighbourhood_weights();
+
+		/*!
+		*	@brief	Build the Kempe chains between two timeslots of the current solution in _kempe_chains.
+		*	@param	timeslot1	The first timeslot.
+		*	@param	timeslot2	The second timeslot.
+		*/
+		void build_kempe_chains(int timeslot1, int timeslot2);
+
+		/*!
+		*	@brief	Evaluate every Kempe chain in _kempe_chains, each into its own result, and keep the best one.
+		*	Evaluated in parallel if there are at least heuristic_master::_kempe_parallel_min_chains chains and heuristic_master::_kempe_nb_threads > 1.
+		*	@param	timeslot1	The first timeslot in the Kempe chains.
+		*	@param	timeslot2	The second timeslot in the Kempe chains.
+		*	@param	best_chain	Receives the evaluation of the best chain.
+		*	@param	best_index	Receives the index of the best chain.
+		*/
+		void evaluate_kempe_chains(int timeslot1, int timeslot2, incremental_evaluation& best_chain, int& best_index);
+
+		/*!
+		*	@brief	Save the values of the last incremental evaluation.
+		*	@param	evaluation	Receives the objective value and the new_* values.
+		*	@param	objective_value	The objective value returned by the incremental evaluation.
+		*/
+		void save_evaluation(incremental_evaluation& evaluation, double objective_value) const;
+
+		/*!
+		*	@brief	Update the values of the current solution with the evaluation of a move that is applied.
+		*	@param	evaluation	The evaluation of the move.
+		*	@param	timeslot1	The first timeslot changed by the move.
+		*	@param	timeslot2	The second timeslot changed by the move (equal to timeslot1 if only one timeslot changes).
+		*	@param	previous	Receives the values from before the move, for undo.
+		*/
+		void commit_evaluation(const incremental_evaluation& evaluation, int timeslot1, int timeslot2, incremental_evaluation& previous);
+
+		/*!
+		*	@brief	Restore the values of the current solution from before a move.
+		*	@param	previous	The values saved by commit_evaluation().
+		*	@param	timeslot1	The first timeslot changed by the move.
+		*	@param	timeslot2	The second timeslot changed by the move.
+		*/
+		void revert_evaluation(const incremental_evaluation& previous, int timeslot1, int timeslot2);
+
+		/*!
+		*	@brief	Apply an accepted move, update the statistics, and save the current solution if it is the best one so far.
+		*	@param	move	The accepted move (delta() has been called).
+		*	@param	statistics	The acceptance statistics of the type of move.
+		*/
+		void accept_move(heuristic_move& move, move_statistics& statistics);
+
+		/*!
+		*	@brief	Update the temperature of this subprocess according to the iteration-based cooling schedule.
+		*/
+		void update_temperature();
+
+		/*!
+		*	@brief	Island model: publish the best found solution if it improved, and pull a migrant from the elite pool according to the migration topology.
+		*	The migrant replaces the current solution if it is better.
+		*/
+		void migrate();
+
+		/*!
+		*	@brief	Get the evacuation flow per arc of a timeslot of the current solution, calculated only if it isn't stored for this version of the solution.
+		*	@param	solution	The current solution.
+		*	@param	timeslot	The timeslot.
+		*	@returns	The flow on every arc.
+		*/
+		const std::vector<double>& get_timeslot_flow(const matrix2D<int>& solution, int timeslot);
+
+		/*!
+		*	@brief	Calculate the evacuation time of a timeslot after a move that changes the lectures in some of its rooms,
+		*	by correcting the (shared) flows of the current solution for the changed rooms.
+		*	@param	solution	The current solution.
+		*	@param	timeslot	The timeslot.
+		*	@param	nb_changed	The number of changed rooms.
+		*	@param	rooms		The changed rooms.
+		*	@param	lectures	The lecture in every changed room after the move (-1 if empty).
+		*	@returns	The evacuation time of the timeslot after the move.
+		*/
+		double evaluate_evacuation_timeslot(const matrix2D<int>& solution, int timeslot, int nb_changed, const int* rooms, const int* lectures);
+
 		/*!
 		*	@brief	Evaluate the objective value of a solution using incremental evaluation for a room swap.
-		*	@param	solution	The current solution before changes are implemented.
+		*	@param	solution	The current solution before changes are implemented (only read).
 		*	@param	timeslot	The timeslot in which two lectures are swapped between rooms.
 		*	@param	room1		The first room in the swap.
 		*	@param	room2		The second room in the swap.
 		*	@returns	The objective value of the new solution if the given changes were applied.
 		*/
-		double evaluate_incremental(matrix2D<int>& solution, int timeslot, int room1, int room2);
+		double evaluate_incremental(const matrix2D<int>& solution, int timeslot, int room1, int room2);
 
 		/*!
 		*	@brief	Evaluate the objective value of a solution using incremental evaluation for a lecture swap.
-		*	@param	solution	The current solution before changes are implemented.
+		*	@param	solution	The current solution before changes are implemented (only read).
 		*	@param	timeslot1	The first timeslot in the swap.
 		*	@param	timeslot2	The second timeslot in the swap.
 		*	@param	room1		The first room in the swap.
 		*	@param	room2		The second room in the swap.
 		*	@returns	The objective value of the new solution if the given changes were applied.
 		*/
-		double evaluate_incremental(matrix2D<int>& solution, int timeslot1, int timeslot2, int room1, int room2);
+		double evaluate_incremental(const matrix2D<int>& solution, int timeslot1, int timeslot2, int room1, int room2);
 
 		/*!
 		*	@brief	Evaluate the objective value of a solution using incremental evaluation for a Kempe chain move.
-		*	@param	solution	The current solution before changes are implemented.
+		*	@param	solution	The current solution before changes are implemented (only read).
 		*	@param	currrent_obj	The objective value of the current solution before changes are implemented.
 		*	@param	kempe_chain	The Kempe chain
 		*	@param	timeslot1	The first timeslot in the Kempe chain.
 		*	@param	timeslot2	The second timeslot in the Kempe chain.
 		*	@returns	The objective value of the new solution if the given changes were applied.
 		*/
-		double evaluate_incremental(matrix2D<int>& solution, double current_obj, const std::vector<std::pair<int, int>>& kempe_chain, int timeslot1, int timeslot2);
+		double evaluate_incremental(const matrix2D<int>& solution, double current_obj, const std::vector<std::pair<int, int>>& kempe_chain, int timeslot1, int timeslot2);
 	};
 
 
@@ -331,6 +1271,36 @@ namespace alg
 		*/
 		std::vector<heuristic_subprocess> threads;
 
+		/*!
+		*	@brief	The elite pool through which the subprocesses exchange solutions in the asynchronous island model.
+		*/
+		elite_pool elites;
+
+		/*!
+		*	@brief	The total number of accepted migrants in the island model.
+		*/
+		size_t total_migrations = 0;
+
+		/*!
+		*	@brief	The acceptance statistics of the neighbourhoods over all subprocesses.
+		*/
+		std::vector<move_statistics> total_move_statistics;
+
+		/*!
+		*	@brief	Parallel tempering: the subprocess at every rung of the temperature ladder (rung 0 is the hottest).
+		*/
+		std::vector<size_t> temperature_ladder;
+
+		/*!
+		*	@brief	Parallel tempering: the number of attempted swaps between adjacent replicas.
+		*/
+		size_t replica_swaps_attempted = 0;
+
+		/*!
+		*	@brief	Parallel tempering: the number of accepted swaps between adjacent replicas.
+		*/
+		size_t replica_swaps_accepted = 0;
+
 
 
 	public:
@@ -343,6 +1313,55 @@ namespace alg
 			sum_over_timeslots,		///< Sum over all timeslots of evacuation or travel times
 		};
 
+		/*!
+		*	@brief	How the subprocesses share their solutions.
+		*/
+		enum class synchronization_type
+		{
+			best_solution,	///< At every synchronization all subprocesses continue from the best solution over all subprocesses
+			island_model,	///< Asynchronous island model: subprocesses publish improvements in an elite pool and periodically pull a migrant from it
+			parallel_tempering,	///< Parallel tempering: every subprocess runs at its own temperature on a geometric ladder and adjacent replicas attempt to swap temperatures at every synchronization
+		};
+
+		/*!
+		*	@brief	Which island a subprocess pulls its migrant from in the island model.
+		*/
+		enum class migration_topology
+		{
+			ring,		///< The previous island in a ring
+			random,		///< A random other island
+			best_of_k,	///< The best of k random other islands
+		};
+
+		/*!
+		*	@brief	How the SA temperature is lowered.
+		*/
+		enum class cooling_schedule
+		{
+			per_synchronization,	///< The master cools the temperature of all subprocesses by _SA_alpha at every synchronization (depends on the speed of the machine)
+			geometric,		///< Every subprocess cools geometrically from _SA_start_temperature to _SA_Tmin in _SA_cooling_iterations iterations and then reheats
+			linear,			///< Every subprocess cools linearly from _SA_start_temperature to _SA_Tmin in _SA_cooling_iterations iterations and then reheats
+			adaptive,		///< Every subprocess cools when its acceptance rate is above _SA_target_acceptance_rate and heats up when it is below
+		};
+
+		/*!
+		*	@brief	Which candidate of a batch is tried with the acceptance rule.
+		*/
+		enum class batch_selection
+		{
+			best,				///< The best candidate of the batch
+			first_acceptable,	///< The first candidate that satisfies the acceptance rule (the rest of the batch is skipped)
+		};
+
+		/*!
+		*	@brief	How a subprocess chooses the neighbourhood of the next move.
+		*/
+		enum class neighbourhood_selection
+		{
+			fixed,		///< With the probabilities of the registry
+			adaptive,	///< Roulette wheel on weights that follow the relative improvement per second of every neighbourhood
+		};
+
 		/*!
 		*	@brief	Run the heuristic.
 		*/
@@ -389,12 +1408,72 @@ namespace alg
 		static size_t _nb_threads;
 
 		/*!
-		*	@brief	The probabilities of the different moves.
+		*	@brief	How the subprocesses share their solutions.
+		*/
+		static synchronization_type _synchronization_type;
+
+		/*!
+		*	@brief	The migration topology of the island model.
+		*/
+		static migration_topology _migration_topology;
+
+		/*!
+		*	@brief	The number of islands that are compared for the best-of-k migration topology.
+		*/
+		static size_t _migration_tournament_size;
+
+		/*!
+		*	@brief	The number of iterations of a subprocess between two migrations in the island model.
+		*/
+		static size_t _migration_interval;
+
+		/*!
+		*	@brief	The neighbourhoods and their probabilities.
+		*/
+		static neighbourhood_registry _neighbourhoods;
+
+		/*!
+		*	@brief	How a subprocess chooses the neighbourhood of the next move.
+		*/
+		static neighbourhood_selection _neighbourhood_selection;
+
+		/*!
+		*	@brief	Adaptive selection: the number of iterations of a subprocess between two weight updates.
+		*/
+		static size_t _adaptive_segment;
+
+		/*!
+		*	@brief	Adaptive selection: how fast the weights follow the last segment: w' = (1 - r) * w + r * share.
 		*/
-		static double _probability_move[3];
+		static double _adaptive_reaction;
 
 		/*!
-		*	@brief	The current temperature of the simulated annealing.
+		*	@brief	Adaptive selection: the minimum probability of every neighbourhood, so that none of them is abandoned.
+		*/
+		static double _adaptive_min_probability;
+
+		/*!
+		*	@brief	The number of candidate moves of the same kind evaluated per iteration: room swaps in one timeslot, or lecture swaps between the same two timeslots.
+		*/
+		static size_t _batch_size;
+
+		/*!
+		*	@brief	Which candidate of a batch is tried with the acceptance rule.
+		*/
+		static batch_selection _batch_selection;
+
+		/*!
+		*	@brief	The number of threads with which a subprocess evaluates the Kempe chains of one move (1 = sequential).
+		*/
+		static size_t _kempe_nb_threads;
+
+		/*!
+		*	@brief	The minimum number of Kempe chains in a move before they are evaluated in parallel.
+		*/
+		static size_t _kempe_parallel_min_chains;
+
+		/*!
+		*	@brief	The current temperature of the simulated annealing (all subprocesses, except for parallel tempering).
 		*/
 		static double _SA_temperature;
 
@@ -404,18 +1483,74 @@ namespace alg
 		static double _SA_alpha;
 
 		/*!
-		*	@brief	The start temperature of the SA.
+		*	@brief	The start temperature of the SA (the hottest rung of the ladder for parallel tempering).
 		*/
 		static double _SA_start_temperature;
 
 		/*!
-		*	@brief	The minimum temperature, when the SA is reheated.
+		*	@brief	The minimum temperature, when the SA is reheated (the coldest rung of the ladder for parallel tempering).
 		*/
 		static double _SA_Tmin;
 
+		/*!
+		*	@brief	How the SA temperature is lowered (not used for parallel tempering).
+		*/
+		static cooling_schedule _cooling_schedule;
+
+		/*!
+		*	@brief	The number of iterations of a subprocess between two temperature updates (iteration-based cooling schedules).
+		*/
+		static size_t _cooling_interval;
+
+		/*!
+		*	@brief	The number of iterations of one cooling cycle from _SA_start_temperature to _SA_Tmin (geometric and linear cooling schedule).
+		*/
+		static size_t _SA_cooling_iterations;
+
+		/*!
+		*	@brief	The fraction of accepted moves the adaptive cooling schedule aims for.
+		*/
+		static double _SA_target_acceptance_rate;
+
+		/*!
+		*	@brief	The factor by which the adaptive cooling schedule lowers (or the inverse by which it raises) the temperature.
+		*/
+		static double _SA_adaptive_factor;
+
+		/*!
+		*	@brief	Hybrid mode: give the best found solution as MIP start to the monolithic MIP, which polishes it.
+		*/
+		static bool _MIP_polish;
+
+		/*!
+		*	@brief	The allowed computation time for polishing the best found solution with the monolithic MIP (in seconds).
+		*/
+		static double _MIP_polish_time_limit;
+
+		/*!
+		*	@brief	The threads, memory, node files and determinism of the MIP that constructs the initial solution and of the MIP polishing.
+		*/
+		static solver_resources _MIP_resources;
+
 
 	private:
 		void write_output();
+
+		/*!
+		*	@brief	Parallel tempering: assign every subprocess a temperature on a geometric ladder from _SA_start_temperature down to _SA_Tmin.
+		*/
+		void initialize_temperature_ladder();
+
+		/*!
+		*	@brief	Parallel tempering: attempt to swap the temperatures of adjacent replicas with Metropolis acceptance.
+		*	@param	odd_pairs	Whether the pairs (1,2), (3,4), ... are tried instead of the pairs (0,1), (2,3), ...
+		*/
+		void exchange_replicas(bool odd_pairs);
+
+		/*!
+		*	@brief	Solve the monolithic MIP with the best found solution as MIP start, and keep its solution if it is better.
+		*/
+		void polish_with_MIP();
 	};
 
 } // namespace alg
@@ -8,6 +8,12 @@
 #define HEURISTIC_UTILITIES_H
 
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <exception>
 
 /*!
 *	@namespace	alg
@@ -307,6 +313,226 @@ namespace alg
 		~matrix3D() { }
 	};
 
+
+
+	/*!
+	*	@brief	A fixed group of persistent worker threads that execute a task in rounds.
+	*	run_round() releases all workers, every worker executes the task with its own index, and run_round() returns when all of them have finished.
+	*	An exception thrown by a worker is stored and rethrown in the owner by run_round(), after all workers have finished the round.
+	*	The destructor stops and joins the workers, so they never outlive the group on any exit path.
+	*/
+	class worker_group
+	{
+		/*!
+		*	@brief	Mutex that protects the round information.
+		*/
+		std::mutex _mutex;
+
+		/*!
+		*	@brief	Condition variable on which the idle workers block.
+		*/
+		std::condition_variable _start_condition;
+
+		/*!
+		*	@brief	Condition variable on which the owner blocks until the round is finished.
+		*/
+		std::condition_variable _end_condition;
+
+		/*!
+		*	@brief	The current round.
+		*/
+		size_t _round = 0;
+
+		/*!
+		*	@brief	The number of workers that have finished the current round.
+		*/
+		size_t _nb_finished = 0;
+
+		/*!
+		*	@brief	Indicates whether the workers have to stop.
+		*/
+		bool _stop = false;
+
+		/*!
+		*	@brief	The task of the current round; receives the index of the worker.
+		*/
+		std::function<void(size_t)> _task;
+
+		/*!
+		*	@brief	The exception thrown by every worker in the current round (empty if none).
+		*/
+		std::vector<std::exception_ptr> _exceptions;
+
+		/*!
+		*	@brief	The worker threads.
+		*/
+		std::vector<std::thread> _workers;
+
+		/*!
+		*	@brief	The loop of a worker: wait for a round, execute the task, report that it has finished.
+		*	@param	index	The index of the worker.
+		*/
+		void work(size_t index)
+		{
+			size_t round = 0;
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_start_condition.wait(lock, [this, round] { return _stop || _round != round; });
+					if (_stop)
+						return;
+					round = _round;
+				}
+
+				try
+				{
+					_task(index);
+				}
+				catch (...)
+				{
+					_exceptions[index] = std::current_exception();
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					++_nb_finished;
+				}
+				_end_condition.notify_one();
+			}
+		}
+
+		/*!
+		*	@brief	Stop and join all workers.
+		*/
+		void shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stop = true;
+			}
+			_start_condition.notify_all();
+			for (auto&& worker : _workers)
+			{
+				if (worker.joinable())
+					worker.join();
+			}
+		}
+
+	public:
+		/*!
+		*	@brief	Constructor: start the workers.
+		*	@param	nb_workers	The number of workers.
+		*/
+		explicit worker_group(size_t nb_workers) : _exceptions(nb_workers)
+		{
+			try
+			{
+				_workers.reserve(nb_workers);
+				for (size_t i = 0; i < nb_workers; ++i)
+					_workers.push_back(std::thread(&worker_group::work, this, i));
+			}
+			catch (...)
+			{
+				shutdown();
+				throw;
+			}
+		}
+
+		worker_group(const worker_group&) = delete;
+		worker_group& operator=(const worker_group&) = delete;
+
+		/*!
+		*	@brief	Destructor: stop and join the workers.
+		*/
+		~worker_group() { shutdown(); }
+
+		/*!
+		*	@brief	Get the number of workers.
+		*	@returns	The number of workers.
+		*/
+		size_t size() const { return _workers.size(); }
+
+		/*!
+		*	@brief	Let every worker execute a task and wait until all of them have finished; rethrows the first exception of a worker.
+		*	@param	task	The task; receives the index of the worker.
+		*/
+		void run_round(std::function<void(size_t)> task)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_task = std::move(task);
+				_nb_finished = 0;
+				++_round;
+			}
+			_start_condition.notify_all();
+
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_end_condition.wait(lock, [this] { return _nb_finished == _workers.size(); });
+			}
+
+			for (auto&& exception : _exceptions)
+			{
+				if (exception)
+				{
+					std::exception_ptr first = exception;
+					for (auto&& e : _exceptions)
+						e = nullptr;
+					std::rethrow_exception(first);
+				}
+			}
+		}
+	};
+
+
+
+	/*!
+	*	@brief	Owner of a worker_group that is started on first use.
+	*	A copy starts without workers, so the workers of an object are never shared with its copies.
+	*/
+	class worker_group_handle
+	{
+		/*!
+		*	@brief	The workers (nullptr until first use).
+		*/
+		std::unique_ptr<worker_group> _group;
+
+	public:
+		/*!
+		*	@brief	Constructor.
+		*/
+		worker_group_handle() { }
+
+		/*!
+		*	@brief	Copy constructor: the copy starts without workers.
+		*/
+		worker_group_handle(const worker_group_handle&) { }
+
+		/*!
+		*	@brief	Copy assignment: keeps the own workers.
+		*/
+		worker_group_handle& operator=(const worker_group_handle&) { return *this; }
+
+		worker_group_handle(worker_group_handle&&) = default;
+		worker_group_handle& operator=(worker_group_handle&&) = default;
+
+		/*!
+		*	@brief	Get the workers, started (again) if they don't exist yet or if their number differs.
+		*	@param	nb_workers	The number of workers.
+		*	@returns	The workers.
+		*/
+		worker_group& get(size_t nb_workers)
+		{
+			if (!_group || _group->size() != nb_workers)
+			{
+				_group.reset();
+				_group.reset(new worker_group(nb_workers));
+			}
+			return *_group;
+		}
+	};
+
 } // namespace alg
 
 #endif // !HEURISTIC_UTILITIES_H
\ No newline at end of file
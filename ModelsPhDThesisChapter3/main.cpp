@@ -49,9 +49,9 @@ int main()
 					alg::heuristic_master::_penalty_value_constraint_violation = 100000;
 					alg::heuristic_master::_lambda = 0;
 					alg::heuristic_master::_time_limit = 1000;
-					alg::heuristic_master::_SA_start_temperature = 100000;
+					alg::heuristic_master::_SA_start_temperature = 0.01;	// the temperature is on the scale of relative deteriorations: 1% is accepted with probability 1/e
 					alg::heuristic_master::_SA_alpha = 0.9;
-					alg::heuristic_master::_SA_Tmin = 0.1;
+					alg::heuristic_master::_SA_Tmin = 0.0001;
 					alg::heuristic_master::_nb_synchronizations = 40;
 					alg::heuristic_master::_nb_threads = 12;
 